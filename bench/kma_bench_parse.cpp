@@ -0,0 +1,376 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+//Standalone microbenchmarks for the kmake parser,
+//built by the bench-* profiles in project.kmake
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "core_utils.hpp"
+
+#include "core/kma_core.hpp"
+#include "core/kma_parse.hpp"
+#include "core/kma_context.hpp"
+#include "core/kma_mapped_file.hpp"
+
+using KalaMake::Core::Parse;
+using KalaMake::Core::MappedFile;
+using KalaMake::Core::SessionContext;
+
+using std::atomic;
+using std::cerr;
+using std::ofstream;
+using std::string;
+using std::string_view;
+using std::to_string;
+using std::vector;
+using std::filesystem::path;
+using std::filesystem::temp_directory_path;
+using std::filesystem::create_directories;
+using std::filesystem::remove_all;
+using std::filesystem::exists;
+using std::filesystem::current_path;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+using u64 = uint64_t;
+
+static atomic<u64> allocCount{};
+
+void* operator new(size_t size)
+{
+	++allocCount;
+
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+struct BenchConfig
+{
+	//how many #profile categories are generated
+	size_t profiles = 200;
+	//how many references are generated, half of them are used in nested form
+	size_t references = 2000;
+	//how many quoted entries the global sources field has
+	size_t sources = 5000;
+	//how many times each stage is repeated
+	size_t iterations = 5;
+};
+
+struct BenchResult
+{
+	string name{};
+	u64 ns{};
+	u64 allocs{};
+	size_t units{};
+	string_view unitName{};
+};
+
+struct GeneratedProject
+{
+	path root{};
+	path kmakePath{};
+	vector<string> lines{};
+	string content{};
+	vector<string> categoryLines{};
+	vector<string> globalFieldLines{};
+	vector<string> referenceValues{};
+	size_t fieldCount{};
+};
+
+static GeneratedProject GenerateProject(const BenchConfig& config)
+{
+	GeneratedProject project{};
+	project.root = temp_directory_path() / "kalamake-bench";
+
+	if (exists(project.root)) remove_all(project.root);
+	create_directories(project.root / "src");
+	create_directories(project.root / "include");
+
+	for (size_t i = 0; i < config.sources; ++i)
+	{
+		ofstream(project.root / "src" / ("file_" + to_string(i) + ".cpp")) << "int f" << i << "() { return " << i << "; }\n";
+	}
+
+	vector<string>& lines = project.lines;
+
+	auto add_category = [&project, &lines](const string& line)
+		{
+			lines.push_back(line);
+			project.categoryLines.push_back(line);
+		};
+
+	add_category("#version 1.0");
+	lines.push_back("");
+
+	//plain references hold values, index references hold the suffix
+	//of another reference name so fields can use the nested ${v_${n_i}} form
+
+	add_category("#references");
+	size_t half = config.references / 2;
+	for (size_t i = 0; i < half; ++i)
+	{
+		lines.push_back("v_" + to_string(i) + ": value_" + to_string(i) + " //plain reference");
+		lines.push_back("n_" + to_string(i) + ": " + to_string(i));
+
+		project.referenceValues.push_back("${v_" + to_string(i) + "}");
+		project.referenceValues.push_back("prefix_${v_${n_" + to_string(i) + "}}_suffix");
+	}
+	lines.push_back("");
+
+	string sources = "sources: ";
+	for (size_t i = 0; i < config.sources; ++i)
+	{
+		if (i != 0) sources += ", ";
+		sources += "\"src/file_" + to_string(i) + ".cpp\"";
+	}
+
+	string defines = "defines: ";
+	for (size_t i = 0; i < half && i < 64; ++i)
+	{
+		if (i != 0) defines += ", ";
+		defines += "D_${v_${n_" + to_string(i) + "}}";
+	}
+
+	vector<string> globalFields =
+	{
+		"compiler: clang++",
+		"standard: c++20",
+		"binarytype: executable",
+		"binaryname: bench",
+		"buildtype: release",
+		"buildpath: \"build/global\"",
+		"headers: \"include\"",
+		"warninglevel: normal",
+		sources,
+		defines
+	};
+
+	add_category("#global");
+	for (const auto& f : globalFields)
+	{
+		lines.push_back(f);
+		project.globalFieldLines.push_back(f);
+	}
+	project.fieldCount += globalFields.size();
+	lines.push_back("");
+
+	for (size_t i = 0; i < config.profiles; ++i)
+	{
+		string n = to_string(half ? i % half : 0);
+
+		add_category("#profile p_" + to_string(i));
+		lines.push_back("buildtype: debug");
+		lines.push_back("buildpath: \"build/p_" + to_string(i) + "\"");
+		lines.push_back("defines: P_${v_${n_" + n + "}}");
+		lines.push_back("// comment line between fields");
+		lines.push_back("compileflags: fno-exceptions");
+		lines.push_back("");
+	}
+
+	//FirstParse only ever parses global plus the target profile
+	project.fieldCount += 3;
+
+	for (const auto& l : lines)
+	{
+		project.content += l;
+		project.content += '\n';
+	}
+
+	project.kmakePath = project.root / "bench.kmake";
+	ofstream(project.kmakePath, std::ios::binary) << project.content;
+
+	return project;
+}
+
+template<typename F>
+static BenchResult Measure(
+	string_view name,
+	size_t iterations,
+	size_t units,
+	string_view unitName,
+	F&& func)
+{
+	u64 startAllocs = allocCount.load();
+	auto start = steady_clock::now();
+
+	for (size_t i = 0; i < iterations; ++i) func();
+
+	auto end = steady_clock::now();
+
+	return
+	{
+		.name = string(name),
+		.ns = scast<u64>(duration_cast<nanoseconds>(end - start).count()),
+		.allocs = allocCount.load() - startAllocs,
+		.units = units * iterations,
+		.unitName = unitName
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	BenchConfig config{};
+
+	if (argc > 1) config.profiles   = scast<size_t>(strtoull(argv[1], nullptr, 10));
+	if (argc > 2) config.references = scast<size_t>(strtoull(argv[2], nullptr, 10));
+	if (argc > 3) config.sources    = scast<size_t>(strtoull(argv[3], nullptr, 10));
+	if (argc > 4) config.iterations = scast<size_t>(strtoull(argv[4], nullptr, 10));
+
+	if (config.profiles == 0
+		|| config.references < 2
+		|| config.sources == 0
+		|| config.iterations == 0)
+	{
+		cerr << "usage: kalamake-bench [profiles >= 1] [references >= 2] [sources >= 1] [iterations >= 1]\n";
+		return 1;
+	}
+
+	GeneratedProject project = GenerateProject(config);
+	string lastProfile = "p_" + to_string(config.profiles - 1);
+
+	//the parser logs every field it resolves,
+	//results go to stderr so stdout can be silenced
+	if (!freopen(
+#ifdef _WIN32
+		"NUL",
+#else
+		"/dev/null",
+#endif
+		"w",
+		stdout))
+	{
+		cerr << "failed to silence stdout, results include logging cost\n";
+	}
+
+	//build paths are created relative to the working dir
+	path originalDir = current_path();
+	current_path(project.root);
+
+	//the parser stages work on the context bound to this thread
+	SessionContext context{};
+	SessionContext::Scope scope(context);
+
+	Parse::SetTarget(project.root, lastProfile);
+
+	//warm up once so references are loaded for the isolated stages
+	Parse::FirstParse(Parse::Tokenize(project.content));
+
+	vector<BenchResult> results{};
+
+	results.push_back(Measure(
+		"ExtractCategoryData",
+		config.iterations,
+		project.categoryLines.size(),
+		"line",
+		[&project]()
+		{
+			for (const auto& l : project.categoryLines)
+			{
+				string_view name{};
+				string_view value{};
+				Parse::ExtractCategoryData(l, name, value);
+			}
+		}));
+
+	results.push_back(Measure(
+		"TranslateReferences",
+		config.iterations,
+		project.referenceValues.size(),
+		"value",
+		[&project]()
+		{
+			for (const auto& v : project.referenceValues)
+			{
+				string translated = Parse::TranslateReferences(v);
+			}
+		}));
+
+	results.push_back(Measure(
+		"ExtractFieldData",
+		config.iterations,
+		project.globalFieldLines.size(),
+		"field",
+		[&project]()
+		{
+			for (const auto& l : project.globalFieldLines)
+			{
+				string name{};
+				vector<string> values{};
+				Parse::ExtractFieldData(l, name, values);
+			}
+		}));
+
+	results.push_back(Measure(
+		"Tokenize",
+		config.iterations,
+		project.lines.size(),
+		"line",
+		[&project]()
+		{
+			KalaMake::Core::ProjectIndex index = Parse::Tokenize(project.content);
+		}));
+
+	results.push_back(Measure(
+		"MappedFile + Tokenize",
+		config.iterations,
+		project.lines.size(),
+		"line",
+		[&project]()
+		{
+			MappedFile file{};
+			if (!file.Open(project.kmakePath).empty()) return;
+
+			KalaMake::Core::ProjectIndex index = Parse::Tokenize(file.GetView());
+		}));
+
+	results.push_back(Measure(
+		"Tokenize + FirstParse",
+		config.iterations,
+		project.lines.size(),
+		"line",
+		[&project]()
+		{
+			Parse::FirstParse(Parse::Tokenize(project.content));
+		}));
+
+	cerr << "kalamake-bench: "
+		<< config.profiles << " profiles, "
+		<< config.references << " references, "
+		<< config.sources << " sources, "
+		<< config.iterations << " iterations, "
+		<< project.lines.size() << " lines\n\n";
+
+	for (const auto& r : results)
+	{
+		double perUnit = r.units ? scast<double>(r.ns) / scast<double>(r.units) : 0.0;
+		double allocsPerUnit = r.units ? scast<double>(r.allocs) / scast<double>(r.units) : 0.0;
+
+		cerr << "  " << r.name << "\n"
+			<< "    " << perUnit << " ns per " << r.unitName << "\n"
+			<< "    " << allocsPerUnit << " allocations per " << r.unitName << "\n";
+	}
+
+	double firstParseAllocs = scast<double>(results.back().allocs) / scast<double>(config.iterations);
+	cerr << "\n  FirstParse allocations per parsed field: "
+		<< firstParseAllocs / scast<double>(project.fieldCount) << "\n";
+
+	current_path(originalDir);
+	remove_all(project.root);
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <functional>
+
+#include "core/kma_core.hpp"
+
+namespace KalaMake::Core
+{
+	using std::string;
+	using std::string_view;
+	using std::vector;
+	using std::function;
+	using std::filesystem::path;
+
+	//One pre or post build action split into its declarations and its command
+	struct BuildAction
+	{
+		string command{};
+
+		//files the command reads, relative to the kmake file
+		vector<path> inputs{};
+		//files the command writes, relative to the kmake file
+		vector<path> outputs{};
+
+		//only runs when the build wrote a new binary
+		bool onRelink{};
+	};
+
+	//Actions written as 'in "a" out "b" relink -> command' declare what they read and write,
+	//actions without ' -> ' are only a command and run on every build like before
+	class Action
+	{
+	public:
+		//Returns an error message, or an empty string if the action was valid
+		static string Parse(
+			string_view value,
+			BuildAction& outAction);
+
+		//True if the action declares outputs, pre build actions like this are generators
+		//that run alongside compilation instead of before it
+		static bool IsGenerator(string_view value);
+
+		//Parses every action and resolves its declared paths against the kmake file directory,
+		//closes with an error if any of them are invalid
+		static vector<BuildAction> Resolve(
+			const GlobalData& globalData,
+			const vector<string>& actions,
+			string_view target,
+			string_view stage);
+
+		//Runs actions in the order they were written. Declared actions that follow each other
+		//run at once unless one reads or writes what another writes, and declared actions
+		//whose outputs are newer than their inputs and the kmake file are skipped.
+		//onFinished gets the index of each action once it ran or was skipped, and whether it ran
+		static void RunAll(
+			const GlobalData& globalData,
+			const vector<string>& actions,
+			bool relinked,
+			string_view target,
+			string_view stage,
+			const function<void(size_t, bool)>& onFinished = {});
+	};
+}
@@ -0,0 +1,107 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+
+#include "core/kma_core.hpp"
+#include "core/kma_glob.hpp"
+#include "core/kma_snapshot.hpp"
+
+namespace KalaMake::Core
+{
+	using std::string;
+	using std::vector;
+	using std::unordered_map;
+	using std::unordered_set;
+	using std::mutex;
+	using std::condition_variable;
+	using std::filesystem::path;
+
+	//Everything one run of the engine parses, lists and schedules.
+	//The command line and every BuildSession own their own context, so runs on different threads share nothing.
+	//OpenFile binds the context to the calling thread and every thread the engine starts
+	//binds the context of the thread that started it
+	struct SessionContext
+	{
+		//Binds a context to the calling thread until the scope ends,
+		//the context that was bound before is bound again after
+		class Scope
+		{
+		public:
+			explicit Scope(SessionContext& context);
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		private:
+			SessionContext* previous{};
+		};
+
+		//The context bound to the calling thread, fails if there is none
+		static SessionContext& Current();
+
+		//
+		// PARSE
+		//
+
+		//kma path is the root directory where the kmake file is stored at
+		path kmaPath{};
+
+		string targetProfile{};
+
+		bool foundVersion{};
+		bool foundReferences{};
+		bool foundGlobal{};
+		bool foundTargetProfile{};
+		bool foundAnyUserProfile{};
+
+		GlobalData globalData{};
+		path projectFile{};
+
+		//the only source compiled by compile-file and whether its diagnostics are exported as json
+		path singleSource{};
+		bool exportDiagnostics{};
+
+		//every profile passed to compile or check, compiled together when there is more than one
+		vector<string> targetProfiles{};
+
+		//every directory and ignore file that was read while resolving sources, headers and links,
+		//a change in any of them invalidates the profile snapshot
+		unordered_set<string> traversedPaths{};
+
+		//'!' values of the global and target profile sources fields
+		GlobSet sourceExclusions{};
+
+		//
+		// DIRECTORY CACHE
+		//
+
+		unordered_map<string, DirListing> dirListings{};
+		bool dirListingsChanged{};
+
+		//profiles compiled together walk through the same directory cache,
+		//listings could be replaced while another walk still reads them
+		mutex m_walk;
+
+		//
+		// JOB POOL
+		//
+
+		mutex m_jobs;
+		condition_variable slotFreed{};
+
+		//0 removes the limit
+		u16 jobCapacity{};
+		u16 runningJobs{};
+	};
+}
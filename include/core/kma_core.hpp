@@ -9,6 +9,7 @@
 #include <string>
 #include <filesystem>
 #include <unordered_map>
+#include <stdexcept>
 
 #include "core_utils.hpp"
 
@@ -21,6 +22,7 @@ namespace KalaMake::Core
 	using std::string_view;
 	using std::filesystem::path;
 	using std::unordered_map;
+	using std::runtime_error;
 
 	using u8 = uint8_t;
 	using u16 = uint16_t;
@@ -31,7 +33,9 @@ namespace KalaMake::Core
 		S_COMPILE = 1u,
 		S_CLEAN = 2u,
 		S_LIST_PROFILES = 3u,
-		S_VALIDATE = 4u
+		S_VALIDATE = 4u,
+		S_COMPILE_FILE = 5u,
+		S_CHECK = 6u
 	};
 
 	enum class Version : u8
@@ -123,7 +127,23 @@ namespace KalaMake::Core
 
 		//post-build action field, can add as many as you want,
 		//supported by all languages
-		T_POST_BUILD_ACTION = 19u
+		T_POST_BUILD_ACTION = 19u,
+
+		//what other binaries are linked from the same object files,
+		//only for C and C++
+		T_TARGETS = 20u,
+
+		//what commands train the instrumented binaries of a profile-guided build,
+		//only for C and C++
+		T_PGO_TRAINING = 21u,
+
+		//what command is profiled to lay out executables with llvm-bolt,
+		//only for C and C++ on Linux
+		T_BOLT_WORKLOAD = 22u,
+
+		//what x86-64 psABI levels the binary is built for,
+		//only for C and C++
+		T_MICROARCH = 23u
 	};
 
 	//Allowed binary types that can be added to the binarytype field
@@ -364,9 +384,20 @@ namespace KalaMake::Core
 		//pyinstaller bundles everything into a single exe, all files are extracted at each run,
 		//otherwise it creates a dir with all content with faster startup.
 		//only for Python
-		F_PYTHON_ONE_FILE = 10u
+		F_PYTHON_ONE_FILE = 10u,
+
+		//runs link jobs only on the performance cores of hybrid cpus,
+		//only for C and C++, only used in linux
+		F_PIN_LINKS = 11u
 	};
 	
+	//One more binary of a profile, written as 'binarytype:binaryname' in the targets field
+	struct BuildTarget
+	{
+		BinaryType binaryType{};
+		string binaryName{};
+	};
+
 	struct ProfileData
 	{
 		//what is the name of this profile
@@ -430,12 +461,45 @@ namespace KalaMake::Core
 
 		//what actions will be done after generation, compilation and linking is complete
 		vector<string> postBuildActions{};
+
+		//what other binaries are linked from the same object files,
+		//only for C and C++
+		vector<BuildTarget> targets{};
+
+		//what commands run the instrumented binaries before the optimized build,
+		//only for C and C++
+		vector<string> pgoTraining{};
+
+		//what command is profiled to optimize executables with llvm-bolt after linking,
+		//only for C and C++ on Linux
+		string boltWorkload{};
+
+		//what x86-64 psABI levels the same binary is built for in one run,
+		//only for C and C++
+		vector<string> microarch{};
+	};
+
+	//Expansion state of a reference, used to memoize and to detect cycles
+	enum class ReferenceState : u8
+	{
+		R_UNRESOLVED = 0u,
+
+		//currently being expanded, seeing it again means a cycle
+		R_RESOLVING = 1u,
+
+		//expandedValue is final
+		R_RESOLVED = 2u
 	};
 
 	struct ReferenceData
 	{
 		string name{};
+		//value as written in the references category
 		string value{};
+
+		//value with all nested references expanded, filled on first use
+		string expandedValue{};
+		ReferenceState state{};
 	};
 
 	struct GlobalData
@@ -446,31 +510,48 @@ namespace KalaMake::Core
 		//final mixed data from global and/or target user profile
 		ProfileData targetProfile{};
 
-		//what references are included in this kalamake project
-		vector<ReferenceData> references{};
+		//set by the check command, sources are only checked for errors
+		//and nothing is written to the build path or linked
+		bool checkOnly{};
+
+		//what references are included in this kalamake project, by name
+		unordered_map<string, ReferenceData> references{};
 	};
 
+	//Thrown by KalaMakeCore::CloseOnError after the error was logged,
+	//target is the log tag of the part of kalamake that failed
+	class KalaMakeError : public runtime_error
+	{
+	public:
+		KalaMakeError(
+			string_view target,
+			string_view message)
+			: runtime_error(string(message)),
+			target(target) {}
+
+		const string& GetTarget() const { return target; }
+	private:
+		string target{};
+	};
+
+	//Parse state, directory listings and job slots of one run, see kma_context.hpp
+	struct SessionContext;
+
 	class KalaMakeCore
 	{
 	public:
+		//Runs a command on context, which holds the final profile of a successful validate or compile afterwards
 		static void OpenFile(
+			SessionContext& context,
 			StartType type,
 			const vector<string>& params);
 
 		static const unordered_map<Version,      string_view, EnumHash<Version>>&      GetVersions();
 		static const unordered_map<CategoryType, string_view, EnumHash<CategoryType>>& GetCategoryTypes();
-		static const unordered_map<FieldType,    string_view, EnumHash<FieldType>>&    GetFieldTypes();
-
-		static const unordered_map<BinaryType,           string_view, EnumHash<BinaryType>>&           GetBinaryTypes();
-		static const unordered_map<CompilerLauncherType, string_view, EnumHash<CompilerLauncherType>>& GetCompilerLauncherTypes();
-		static const unordered_map<CompilerType,         string_view, EnumHash<CompilerType>>&         GetCompilerTypes();
-		static const unordered_map<StandardType,         string_view, EnumHash<StandardType>>&         GetStandardTypes();
-		static const unordered_map<TargetType,           string_view, EnumHash<TargetType>>&           GetTargetTypes();
-		static const unordered_map<BuildType,            string_view, EnumHash<BuildType>>&            GetBuildTypes();
-		static const unordered_map<WarningLevel,         string_view, EnumHash<WarningLevel>>&         GetWarningLevels();
-		static const unordered_map<CustomFlag,           string_view, EnumHash<CustomFlag>>&           GetCustomFlags();
-
-		static void CloseOnError(
+
+		//Logs the error and throws KalaMakeError,
+		//the command line exits with 1 and embedders get the error back from their session
+		[[noreturn]] static void CloseOnError(
 			string_view target,
 			string_view message);
 	};
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <filesystem>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,18 @@ namespace KalaMake::Core
         string output{};
     };
 
+    //One compiler message of compile-file,
+    //line and column are 0 when the compiler did not print them
+    struct Diagnostic
+    {
+        path file{};
+        uint32_t line{};
+        uint32_t column{};
+        //error, warning or note
+        string severity{};
+        string message{};
+    };
+
     //Values for classpath file, Java only
     struct JavaClassPath
     {
@@ -61,6 +74,11 @@ namespace KalaMake::Core
         //Exports compile_commands.json
         static void GenerateCompileCommands(const vector<CompileCommand>& commands);
 
+        //Exports the diagnostics of a single compiled source as a json array
+        static void GenerateDiagnostics(
+            const vector<Diagnostic>& diagnostics,
+            const path& target);
+
         static void GenerateJavaClassPath(const JavaClassPath& javaData);
 
         //Updates existing launch.json and tasks.json or makes new ones
@@ -0,0 +1,120 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <unordered_set>
+
+#include "core/kma_core.hpp"
+
+namespace KalaMake::Core
+{
+	using std::vector;
+	using std::string;
+	using std::string_view;
+	using std::filesystem::path;
+	using std::unordered_set;
+
+	//Name of the gitignore-style file that hides entries from globbed and walked dirs
+	constexpr string_view ignore_file_name = ".kmakeignore";
+
+	enum class GlobTarget : u8
+	{
+		G_FILES = 0u,
+		G_DIRS = 1u
+	};
+
+	//One compiled path pattern. '*' and '?' match inside a single segment,
+	//'[...]' matches one char from a set and '**' matches any amount of segments
+	class GlobPattern
+	{
+	public:
+		//Pattern must be absolute with '/' separators and its braces already expanded
+		static GlobPattern Compile(string_view pattern);
+
+		bool Matches(string_view genericPath) const;
+
+		//True if the pattern has no wildcards at all
+		bool IsLiteral() const { return literal; }
+
+		//Leading segments without wildcards, walking this pattern starts here
+		const string& GetRoot() const { return root; }
+
+		//Positions in the segments after root that are still matching,
+		//walks step them once per entry instead of matching whole paths
+		void Start(vector<u16>& outStates) const;
+		void Step(
+			const vector<u16>& states,
+			string_view name,
+			vector<u16>& outStates) const;
+
+		bool IsMatch(const vector<u16>& states) const;
+		bool CanContinue(const vector<u16>& states) const;
+	private:
+		struct Segment
+		{
+			string text{};
+			bool isRecursive{};
+			bool isLiteral{};
+		};
+
+		void Close(vector<u16>& states) const;
+
+		vector<Segment> segments{};
+		string root{};
+		bool literal{};
+	};
+
+	//Exact paths by hash and wildcard patterns by compiled matcher
+	class GlobSet
+	{
+	public:
+		//Pattern must be absolute with '/' separators, braces are expanded here
+		void Add(string_view pattern);
+
+		//Checks only the path itself, walks check every dir on the way down
+		bool Matches(string_view genericPath) const;
+
+		//Checks the path and every dir above it
+		bool MatchesAnyParent(string_view genericPath) const;
+
+		bool IsEmpty() const { return exactPaths.empty() && patterns.empty(); }
+
+		void Clear();
+	private:
+		unordered_set<string> exactPaths{};
+		vector<GlobPattern> patterns{};
+	};
+
+	class Glob
+	{
+	public:
+		//Expands '{a,b}' alternatives into separate patterns, braces can be nested
+		static vector<string> ExpandBraces(string_view pattern);
+
+		static bool HasWildcards(string_view value);
+
+		//Resolves an absolute pattern through the directory cache.
+		//Only dirs that can still match are listed, excluded dirs and dirs
+		//ignored by an ignore file are skipped with everything inside them.
+		//Every listed dir and read ignore file is added to outVisited if it is not nullptr
+		static void Resolve(
+			string_view pattern,
+			GlobTarget target,
+			const GlobSet& exclusions,
+			vector<path>& outPaths,
+			vector<path>* outVisited);
+
+		//Every file below root that is not excluded or ignored
+		static void WalkFiles(
+			const path& root,
+			const GlobSet& exclusions,
+			vector<path>& outFiles,
+			vector<path>* outVisited);
+	};
+}
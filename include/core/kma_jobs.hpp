@@ -0,0 +1,95 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "core/kma_core.hpp"
+
+namespace KalaMake::Core
+{
+	using std::string;
+	using std::string_view;
+	using std::vector;
+	using std::filesystem::path;
+
+	using u64 = uint64_t;
+
+	//What one compiler or linker process used, counted together with the processes it waited for.
+	//Only the wall time is measured on Windows
+	struct JobUsage
+	{
+		//the object or output the job wrote
+		string name{};
+
+		u64 wallMicros{};
+		u64 userMicros{};
+		u64 systemMicros{};
+
+		u64 peakRssKiB{};
+
+		//voluntary switches are waits for i/o or locks, involuntary ones mean too few free cores
+		u64 voluntarySwitches{};
+		u64 involuntarySwitches{};
+
+		//blocks that had to come from or go to the disk
+		u64 blockReads{};
+		u64 blockWrites{};
+
+		//bytes passed through read and write calls, including ones served from the page cache
+		u64 readBytes{};
+		u64 writeBytes{};
+	};
+
+	//Limits how many compiler and linker processes run at once
+	//when several profiles are compiled in one invocation.
+	//Slots belong to the session bound to the calling thread, sessions never wait for each other
+	class JobPool
+	{
+	public:
+		//0 removes the limit, which is the default for a single profile
+		static void SetCapacity(u16 capacity);
+
+		static u16 GetCapacity();
+
+		//One job per physical core this process may run on, limited by the cpu quota
+		//of its cgroup when it runs in a container. Computed once
+		static u16 GetDefaultJobCount();
+
+		//Runs a compiler or linker command once a slot is free,
+		//returns the result of system
+		static int Run(const string& command);
+
+		//Same as Run, but also measures what the command used.
+		//outUsage.name is left as it was. Long jobs such as links can be pinned
+		//to the performance cores of hybrid cpus, which only has an effect on Linux
+		static int Run(
+			const string& command,
+			JobUsage& outUsage,
+			bool pinToPerformanceCores = false);
+
+		//Where the usage of the last job for each object and output lives inside a build path
+		static path GetUsagePath(
+			const path& buildPath,
+			string_view profile);
+
+		//Replaces the stored usage of every given job and keeps the rest,
+		//returns an error message on failure
+		static string SaveUsage(
+			const path& usagePath,
+			const vector<JobUsage>& jobs);
+
+		//Cpu and wall time, peak rss and bytes read and written of one job on one line
+		static string Describe(const JobUsage& usage);
+
+		//Prints the totals of the given jobs and the ones that used the most cpu time
+		static void PrintUsage(
+			const vector<JobUsage>& jobs,
+			string_view target);
+	};
+}
@@ -0,0 +1,46 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <filesystem>
+
+namespace KalaMake::Core
+{
+	using std::string;
+	using std::string_view;
+	using std::filesystem::path;
+
+	//Read-only memory mapping of a whole file,
+	//string_views into GetView stay valid until this object is destroyed
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		//Maps the file, returns an error message on failure.
+		//Empty files succeed with an empty view
+		string Open(const path& filePath);
+
+		string_view GetView() const { return { data, size }; }
+	private:
+		void Close();
+
+		const char* data{};
+		size_t size{};
+#ifdef _WIN32
+		void* fileHandle{};
+		void* mappingHandle{};
+#endif
+	};
+}
@@ -0,0 +1,86 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <unordered_map>
+
+#include "core/kma_core.hpp"
+
+namespace KalaMake::Core
+{
+	using std::vector;
+	using std::string;
+	using std::string_view;
+	using std::filesystem::path;
+	using std::unordered_map;
+
+	//One category header and the field lines that belong to it
+	struct CategoryRecord
+	{
+		CategoryType type{};
+
+		//version number or profile name, empty for references and global
+		string_view value{};
+
+		//comment-free and trimmed field lines in file order
+		vector<string_view> fields{};
+	};
+
+	//Every category of a kmake file, built by a single pass over its lines
+	//and shared by compile, validate, clean and list-profiles.
+	//All views point into the tokenized content, which must outlive the index
+	struct ProjectIndex
+	{
+		static constexpr size_t npos = static_cast<size_t>(-1);
+
+		//categories in file order
+		vector<CategoryRecord> categories{};
+
+		size_t versionIndex = npos;
+		size_t referencesIndex = npos;
+		size_t globalIndex = npos;
+
+		//user profile name to its index in categories
+		unordered_map<string_view, size_t> profileIndices{};
+	};
+
+	//Individual stages of the kmake file parser,
+	//used by kalamake-bench to measure them without compiling anything.
+	//Every stage works on the SessionContext bound to the calling thread
+	class Parse
+	{
+	public:
+		//Sets the kmake root dir that paths are resolved against
+		//and the profile that FirstParse looks for
+		static void SetTarget(
+			const path& kmaRoot,
+			string_view profile);
+
+		static void ExtractCategoryData(
+			string_view line,
+			string_view& outCategoryName,
+			string_view& outCategoryValue);
+
+		static void ExtractFieldData(
+			string_view line,
+			string& outFieldName,
+			vector<string>& outFieldValues,
+			bool isReference = false);
+
+		//Splits the kmake file content into categories and their fields
+		static ProjectIndex Tokenize(string_view content);
+
+		static void FirstParse(const ProjectIndex& index);
+
+		static string TranslateReferences(string_view value);
+
+		//Returns the data collected by the last FirstParse call
+		static const GlobalData& GetParsedData();
+	};
+}
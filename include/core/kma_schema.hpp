@@ -0,0 +1,715 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <type_traits>
+
+#include "core/kma_core.hpp"
+
+namespace KalaMake::Core
+{
+	using std::array;
+	using std::span;
+	using std::string;
+	using std::string_view;
+	using std::vector;
+	using std::filesystem::path;
+	using std::remove_cvref_t;
+
+	using u32 = uint32_t;
+
+	//One bit per language backend, C and C++ share a backend
+	constexpr u8 language_c_cpp  = 1u << 0;
+	constexpr u8 language_zig    = 1u << 1;
+	constexpr u8 language_java   = 1u << 2;
+	constexpr u8 language_python = 1u << 3;
+	constexpr u8 language_rust   = 1u << 4;
+
+	constexpr u8 language_all =
+		language_c_cpp
+		| language_zig
+		| language_java
+		| language_python
+		| language_rust;
+
+	//How the value of a field is parsed and resolved
+	enum class ValueKind : u8
+	{
+		//one or more names from a fixed set
+		V_ENUM = 0u,
+
+		//one unsigned integer
+		V_NUMBER = 1u,
+
+		//free text without quotes
+		V_TEXT = 2u,
+
+		//free text, quotes are passed through to the tools
+		V_TEXT_LIST = 3u,
+
+		//one quoted path that is created if it does not exist
+		V_BUILD_PATH = 4u,
+
+		//quoted paths, dirs and globs
+		V_PATH_LIST = 5u,
+
+		//quoted paths and globs or unquoted system library names
+		V_LINK_LIST = 6u,
+
+		//one console command per field line
+		V_ACTION = 7u,
+
+		//'binarytype:binaryname' pairs, the binary type is one of the field values
+		V_TARGET_LIST = 8u
+	};
+
+	//One accepted name of an enum field and the enum value it is stored as
+	struct SchemaValue
+	{
+		string_view name{};
+		u8 value{};
+
+		//languages that accept this value
+		u8 supportedIn = language_all;
+	};
+
+	//
+	// VALUE TABLES
+	//
+
+	constexpr array<SchemaValue, 3> binary_type_values =
+	{{
+		{ "executable", scast<u8>(BinaryType::B_EXECUTABLE) },
+		{ "static",     scast<u8>(BinaryType::B_STATIC) },
+		{ "shared",     scast<u8>(BinaryType::B_SHARED) }
+	}};
+
+	constexpr array<SchemaValue, 4> compiler_launcher_values =
+	{{
+		{ "ccache",  scast<u8>(CompilerLauncherType::C_CCACHE) },
+		{ "sccache", scast<u8>(CompilerLauncherType::C_SCCACHE) },
+		{ "distcc",  scast<u8>(CompilerLauncherType::C_DISTCC) },
+		{ "icecc",   scast<u8>(CompilerLauncherType::C_ICECC) }
+	}};
+
+	constexpr array<SchemaValue, 10> compiler_values =
+	{{
+		{ "zig",      scast<u8>(CompilerType::C_ZIG) },
+		{ "clang-cl", scast<u8>(CompilerType::C_CLANG_CL) },
+		{ "cl",       scast<u8>(CompilerType::C_CL) },
+
+		{ "clang",   scast<u8>(CompilerType::C_CLANG) },
+		{ "clang++", scast<u8>(CompilerType::C_CLANGPP) },
+		{ "gcc",     scast<u8>(CompilerType::C_GCC) },
+		{ "g++",     scast<u8>(CompilerType::C_GPP) },
+
+		{ "java",   scast<u8>(CompilerType::C_JAVA) },
+		{ "python", scast<u8>(CompilerType::C_PYTHON) },
+		{ "rust",   scast<u8>(CompilerType::C_RUST) }
+	}};
+
+	constexpr array<SchemaValue, 33> standard_values =
+	{{
+		{ "c89", scast<u8>(StandardType::C_89) },
+		{ "c99", scast<u8>(StandardType::C_99) },
+		{ "c11", scast<u8>(StandardType::C_11) },
+		{ "c17", scast<u8>(StandardType::C_17) },
+		{ "c23", scast<u8>(StandardType::C_23) },
+
+		{ "c++14", scast<u8>(StandardType::CPP_14) },
+		{ "c++17", scast<u8>(StandardType::CPP_17) },
+		{ "c++20", scast<u8>(StandardType::CPP_20) },
+		{ "c++23", scast<u8>(StandardType::CPP_23) },
+		{ "c++26", scast<u8>(StandardType::CPP_26) },
+
+		{ "java8",  scast<u8>(StandardType::JAVA_8) },
+		{ "java9",  scast<u8>(StandardType::JAVA_9) },
+		{ "java10", scast<u8>(StandardType::JAVA_10) },
+		{ "java11", scast<u8>(StandardType::JAVA_11) },
+		{ "java12", scast<u8>(StandardType::JAVA_12) },
+		{ "java13", scast<u8>(StandardType::JAVA_13) },
+		{ "java14", scast<u8>(StandardType::JAVA_14) },
+		{ "java15", scast<u8>(StandardType::JAVA_15) },
+		{ "java16", scast<u8>(StandardType::JAVA_16) },
+		{ "java17", scast<u8>(StandardType::JAVA_17) },
+		{ "java18", scast<u8>(StandardType::JAVA_18) },
+		{ "java19", scast<u8>(StandardType::JAVA_19) },
+		{ "java20", scast<u8>(StandardType::JAVA_20) },
+		{ "java21", scast<u8>(StandardType::JAVA_21) },
+		{ "java22", scast<u8>(StandardType::JAVA_22) },
+		{ "java23", scast<u8>(StandardType::JAVA_23) },
+		{ "java24", scast<u8>(StandardType::JAVA_24) },
+		{ "java25", scast<u8>(StandardType::JAVA_25) },
+		{ "java26", scast<u8>(StandardType::JAVA_26) },
+
+		{ "rust15", scast<u8>(StandardType::RUST_15) },
+		{ "rust18", scast<u8>(StandardType::RUST_18) },
+		{ "rust21", scast<u8>(StandardType::RUST_21) },
+		{ "rust24", scast<u8>(StandardType::RUST_24) }
+	}};
+
+	constexpr array<SchemaValue, 4> target_type_values =
+	{{
+		{ "linux-gnu",    scast<u8>(TargetType::T_LINUX_GNU) },
+		{ "linux-musl",   scast<u8>(TargetType::T_LINUX_MUSL) },
+		{ "windows-gnu",  scast<u8>(TargetType::T_WINDOWS_GNU) },
+		{ "windows-msvc", scast<u8>(TargetType::T_WINDOWS_MSVC) }
+	}};
+
+	constexpr array<SchemaValue, 4> build_type_values =
+	{{
+		{ "debug",      scast<u8>(BuildType::B_DEBUG) },
+		{ "release",    scast<u8>(BuildType::B_RELEASE) },
+		{ "reldebug",   scast<u8>(BuildType::B_RELDEBUG) },
+		{ "minsizerel", scast<u8>(BuildType::B_MINSIZEREL) }
+	}};
+
+	//Same warning types are used for both MSVC and GNU,
+	//their true meanings change depending on which OS is used
+	constexpr array<SchemaValue, 6> warning_level_values =
+	{{
+		{ "none",   scast<u8>(WarningLevel::W_NONE) },
+		{ "basic",  scast<u8>(WarningLevel::W_BASIC) },
+		{ "normal", scast<u8>(WarningLevel::W_NORMAL) },
+		{ "strong", scast<u8>(WarningLevel::W_STRONG) },
+		{ "strict", scast<u8>(WarningLevel::W_STRICT) },
+		{ "all",    scast<u8>(WarningLevel::W_ALL) }
+	}};
+
+	//Every custom flag with the languages that accept it
+	constexpr array<SchemaValue, 11> custom_flag_values =
+	{{
+		{ "export-compile-commands", scast<u8>(CustomFlag::F_EXPORT_COMPILE_COMMANDS), language_c_cpp },
+		{ "export-vscode-sln",       scast<u8>(CustomFlag::F_EXPORT_VSCODE_SLN),       language_all },
+		{ "warnings-as-errors",      scast<u8>(CustomFlag::F_WARNINGS_AS_ERRORS),      language_c_cpp | language_java | language_rust },
+		{ "msvc-static-runtime",     scast<u8>(CustomFlag::F_MSVC_STATIC_RUNTIME),     language_c_cpp },
+		{ "generate-symbols",        scast<u8>(CustomFlag::F_GENERATE_SYMBOLS),        language_c_cpp },
+		{ "no-console",              scast<u8>(CustomFlag::F_NO_CONSOLE),              language_c_cpp },
+		{ "package-jar",             scast<u8>(CustomFlag::F_PACKAGE_JAR),             language_java },
+		{ "java-win-console",        scast<u8>(CustomFlag::F_JAVA_WIN_CONSOLE),        language_java },
+		{ "export-java-sln",         scast<u8>(CustomFlag::F_EXPORT_JAVA_SLN),         language_java },
+		{ "python-one-file",         scast<u8>(CustomFlag::F_PYTHON_ONE_FILE),         language_python },
+		{ "pin-links",               scast<u8>(CustomFlag::F_PIN_LINKS),               language_c_cpp }
+	}};
+
+	//x86-64 psABI levels, the same names are used by -march and glibc-hwcaps,
+	//stored by name so the value is only the level
+	constexpr array<SchemaValue, 4> microarch_values =
+	{{
+		{ "x86-64",    1u },
+		{ "x86-64-v2", 2u },
+		{ "x86-64-v3", 3u },
+		{ "x86-64-v4", 4u }
+	}};
+
+	//Returns nullptr if the name is not one of the values
+	constexpr const SchemaValue* FindValue(
+		span<const SchemaValue> values,
+		string_view name)
+	{
+		for (const auto& v : values)
+		{
+			if (v.name == name) return &v;
+		}
+
+		return nullptr;
+	}
+
+	//Returns an empty name for values that are not in the table, including every invalid enum
+	constexpr string_view FindValueName(
+		span<const SchemaValue> values,
+		u8 value)
+	{
+		for (const auto& v : values)
+		{
+			if (v.value == value) return v.name;
+		}
+
+		return {};
+	}
+
+	struct FieldSchema;
+
+	//Stores the validated text values of a field into its ProfileData member
+	using AssignFn = void (*)(ProfileData&, const FieldSchema&, vector<string>&);
+
+	//Appends the text values a ProfileData member was assigned from, nothing if it is unset
+	using CollectFn = void (*)(const ProfileData&, const FieldSchema&, vector<string>&);
+
+	struct FieldSchema
+	{
+		string_view name{};
+		FieldType type{};
+		ValueKind kind{};
+
+		//allows more than one comma-separated value
+		bool isMultiValue{};
+
+		//the field line can appear more than once in a category
+		bool isRepeatable{};
+
+		//profile values are added to global values instead of replacing them
+		bool isMerged{};
+
+		//an empty value is an error
+		bool needsValue{};
+
+		//languages that accept this field
+		u8 supportedIn{};
+
+		//languages that fail without this field
+		u8 requiredIn{};
+
+		//true if the final profile has a value for this field
+		bool (*isSet)(const ProfileData&){};
+
+		//accepted names of enum and target fields
+		span<const SchemaValue> values{};
+
+		//parsing and the profile snapshot both go through these,
+		//so a field is read, stored and restored the same way everywhere
+		AssignFn assign{};
+		CollectFn collect{};
+	};
+
+	//
+	// FIELD ACCESSORS
+	//
+
+	//Values are validated before they are assigned,
+	//names missing from a value table are skipped instead of stored as invalid
+
+	inline string ToFieldText(const string& value) { return value; }
+	inline string ToFieldText(const path& value) { return value.string(); }
+
+	template<auto Member>
+	void AssignEnum(
+		ProfileData& p,
+		const FieldSchema& f,
+		vector<string>& values)
+	{
+		using E = remove_cvref_t<decltype(p.*Member)>;
+
+		const SchemaValue* v = FindValue(f.values, values.front());
+		if (v) p.*Member = scast<E>(v->value);
+	}
+
+	template<auto Member>
+	void CollectEnum(
+		const ProfileData& p,
+		const FieldSchema& f,
+		vector<string>& out)
+	{
+		string_view name = FindValueName(f.values, scast<u8>(p.*Member));
+		if (!name.empty()) out.emplace_back(name);
+	}
+
+	template<auto Member>
+	void AssignEnums(
+		ProfileData& p,
+		const FieldSchema& f,
+		vector<string>& values)
+	{
+		using E = typename remove_cvref_t<decltype(p.*Member)>::value_type;
+
+		auto& target = p.*Member;
+		target.clear();
+		for (const auto& name : values)
+		{
+			const SchemaValue* v = FindValue(f.values, name);
+			if (v) target.push_back(scast<E>(v->value));
+		}
+	}
+
+	template<auto Member>
+	void CollectEnums(
+		const ProfileData& p,
+		const FieldSchema& f,
+		vector<string>& out)
+	{
+		for (auto v : p.*Member) out.emplace_back(FindValueName(f.values, scast<u8>(v)));
+	}
+
+	template<auto Member>
+	void AssignNumber(
+		ProfileData& p,
+		const FieldSchema&,
+		vector<string>& values)
+	{
+		using N = remove_cvref_t<decltype(p.*Member)>;
+		if (!values.front().empty()) p.*Member = scast<N>(std::stoul(values.front()));
+	}
+
+	template<auto Member>
+	void CollectNumber(
+		const ProfileData& p,
+		const FieldSchema&,
+		vector<string>& out)
+	{
+		if (p.*Member != 0) out.push_back(std::to_string(p.*Member));
+	}
+
+	//string and path members with one value
+	template<auto Member>
+	void AssignText(
+		ProfileData& p,
+		const FieldSchema&,
+		vector<string>& values)
+	{
+		p.*Member = std::move(values.front());
+	}
+
+	template<auto Member>
+	void CollectText(
+		const ProfileData& p,
+		const FieldSchema&,
+		vector<string>& out)
+	{
+		if (!(p.*Member).empty()) out.push_back(ToFieldText(p.*Member));
+	}
+
+	//string and path list members
+	template<auto Member>
+	void AssignTexts(
+		ProfileData& p,
+		const FieldSchema&,
+		vector<string>& values)
+	{
+		auto& target = p.*Member;
+		target.assign(
+			std::make_move_iterator(values.begin()),
+			std::make_move_iterator(values.end()));
+	}
+
+	template<auto Member>
+	void CollectTexts(
+		const ProfileData& p,
+		const FieldSchema&,
+		vector<string>& out)
+	{
+		for (const auto& v : p.*Member) out.push_back(ToFieldText(v));
+	}
+
+	inline void AssignTargets(
+		ProfileData& p,
+		const FieldSchema& f,
+		vector<string>& values)
+	{
+		p.targets.clear();
+		for (const auto& t : values)
+		{
+			size_t split = t.find(':');
+
+			const SchemaValue* v = FindValue(f.values, string_view(t).substr(0, split));
+			if (!v
+				|| split == string::npos)
+			{
+				continue;
+			}
+
+			p.targets.push_back({
+				.binaryType = scast<BinaryType>(v->value),
+				.binaryName = t.substr(split + 1) });
+		}
+	}
+
+	inline void CollectTargets(
+		const ProfileData& p,
+		const FieldSchema& f,
+		vector<string>& out)
+	{
+		for (const auto& t : p.targets)
+		{
+			out.push_back(string(FindValueName(f.values, scast<u8>(t.binaryType))) + ":" + t.binaryName);
+		}
+	}
+
+	//Every field of the global and profile categories in FieldType order.
+	//Adding a field means adding its FieldType, its ProfileData member and its row here,
+	//parsing, validation, language checks and the snapshot all read this table
+	constexpr array<FieldSchema, 23> field_schema =
+	{{
+		{
+			.name = "binarytype", .type = FieldType::T_BINARY_TYPE, .kind = ValueKind::V_ENUM,
+			.needsValue = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return p.binaryType != BinaryType::B_INVALID; },
+			.values = binary_type_values, .assign = AssignEnum<&ProfileData::binaryType>, .collect = CollectEnum<&ProfileData::binaryType>
+		},
+		{
+			.name = "compilerlauncher", .type = FieldType::T_COMPILER_LAUNCHER, .kind = ValueKind::V_ENUM,
+			.supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return p.compilerLauncher != CompilerLauncherType::C_INVALID; },
+			.values = compiler_launcher_values, .assign = AssignEnum<&ProfileData::compilerLauncher>, .collect = CollectEnum<&ProfileData::compilerLauncher>
+		},
+		{
+			.name = "compiler", .type = FieldType::T_COMPILER, .kind = ValueKind::V_ENUM,
+			.needsValue = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return p.compiler != CompilerType::C_INVALID; },
+			.values = compiler_values, .assign = AssignEnum<&ProfileData::compiler>, .collect = CollectEnum<&ProfileData::compiler>
+		},
+		{
+			.name = "standard", .type = FieldType::T_STANDARD, .kind = ValueKind::V_ENUM,
+			.needsValue = true,
+			.supportedIn = language_c_cpp | language_java | language_rust,
+			.requiredIn = language_c_cpp | language_java | language_rust,
+			.isSet = [](const ProfileData& p) { return p.standard != StandardType::S_INVALID; },
+			.values = standard_values, .assign = AssignEnum<&ProfileData::standard>, .collect = CollectEnum<&ProfileData::standard>
+		},
+		{
+			.name = "targettype", .type = FieldType::T_TARGET_TYPE, .kind = ValueKind::V_ENUM,
+			.supportedIn = language_c_cpp | language_zig | language_rust,
+			.isSet = [](const ProfileData& p) { return p.targetType != TargetType::T_INVALID; },
+			.values = target_type_values, .assign = AssignEnum<&ProfileData::targetType>, .collect = CollectEnum<&ProfileData::targetType>
+		},
+		{
+			.name = "jobs", .type = FieldType::T_JOBS, .kind = ValueKind::V_NUMBER,
+			.supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return p.jobs != 0; },
+			.assign = AssignNumber<&ProfileData::jobs>, .collect = CollectNumber<&ProfileData::jobs>
+		},
+		{
+			.name = "binaryname", .type = FieldType::T_BINARY_NAME, .kind = ValueKind::V_TEXT,
+			.supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return !p.binaryName.empty(); },
+			.assign = AssignText<&ProfileData::binaryName>, .collect = CollectText<&ProfileData::binaryName>
+		},
+		{
+			.name = "buildtype", .type = FieldType::T_BUILD_TYPE, .kind = ValueKind::V_ENUM,
+			.needsValue = true,
+			.supportedIn = language_c_cpp | language_zig | language_java | language_rust,
+			.requiredIn = language_c_cpp | language_zig | language_java | language_rust,
+			.isSet = [](const ProfileData& p) { return p.buildType != BuildType::B_INVALID; },
+			.values = build_type_values, .assign = AssignEnum<&ProfileData::buildType>, .collect = CollectEnum<&ProfileData::buildType>
+		},
+		{
+			.name = "buildpath", .type = FieldType::T_BUILD_PATH, .kind = ValueKind::V_BUILD_PATH,
+			.needsValue = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return !p.buildPath.empty(); },
+			.assign = AssignText<&ProfileData::buildPath>, .collect = CollectText<&ProfileData::buildPath>
+		},
+		{
+			.name = "sources", .type = FieldType::T_SOURCES, .kind = ValueKind::V_PATH_LIST,
+			.isMultiValue = true, .isMerged = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return !p.sources.empty(); },
+			.assign = AssignTexts<&ProfileData::sources>, .collect = CollectTexts<&ProfileData::sources>
+		},
+		{
+			.name = "headers", .type = FieldType::T_HEADERS, .kind = ValueKind::V_PATH_LIST,
+			.isMultiValue = true, .isMerged = true, .supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return !p.headers.empty(); },
+			.assign = AssignTexts<&ProfileData::headers>, .collect = CollectTexts<&ProfileData::headers>
+		},
+		{
+			.name = "links", .type = FieldType::T_LINKS, .kind = ValueKind::V_LINK_LIST,
+			.isMultiValue = true, .isMerged = true,
+			.supportedIn = language_c_cpp | language_java | language_rust,
+			.isSet = [](const ProfileData& p) { return !p.links.empty(); },
+			.assign = AssignTexts<&ProfileData::links>, .collect = CollectTexts<&ProfileData::links>
+		},
+		{
+			.name = "warninglevel", .type = FieldType::T_WARNING_LEVEL, .kind = ValueKind::V_ENUM,
+			.supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return p.warningLevel != WarningLevel::W_INVALID; },
+			.values = warning_level_values, .assign = AssignEnum<&ProfileData::warningLevel>, .collect = CollectEnum<&ProfileData::warningLevel>
+		},
+		{
+			.name = "defines", .type = FieldType::T_DEFINES, .kind = ValueKind::V_TEXT_LIST,
+			.isMultiValue = true, .isMerged = true,
+			.supportedIn = language_c_cpp | language_java | language_rust,
+			.isSet = [](const ProfileData& p) { return !p.defines.empty(); },
+			.assign = AssignTexts<&ProfileData::defines>, .collect = CollectTexts<&ProfileData::defines>
+		},
+		{
+			.name = "compileflags", .type = FieldType::T_COMPILE_FLAGS, .kind = ValueKind::V_TEXT_LIST,
+			.isMultiValue = true, .isMerged = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return !p.compileFlags.empty(); },
+			.assign = AssignTexts<&ProfileData::compileFlags>, .collect = CollectTexts<&ProfileData::compileFlags>
+		},
+		{
+			.name = "linkflags", .type = FieldType::T_LINK_FLAGS, .kind = ValueKind::V_TEXT_LIST,
+			.isMultiValue = true, .isMerged = true, .supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return !p.linkFlags.empty(); },
+			.assign = AssignTexts<&ProfileData::linkFlags>, .collect = CollectTexts<&ProfileData::linkFlags>
+		},
+		{
+			.name = "customflags", .type = FieldType::T_CUSTOM_FLAGS, .kind = ValueKind::V_ENUM,
+			.isMultiValue = true, .isMerged = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return !p.customFlags.empty(); },
+			.values = custom_flag_values, .assign = AssignEnums<&ProfileData::customFlags>, .collect = CollectEnums<&ProfileData::customFlags>
+		},
+		{
+			.name = "prebuildaction", .type = FieldType::T_PRE_BUILD_ACTION, .kind = ValueKind::V_ACTION,
+			.isRepeatable = true, .isMerged = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return !p.preBuildActions.empty(); },
+			.assign = AssignTexts<&ProfileData::preBuildActions>, .collect = CollectTexts<&ProfileData::preBuildActions>
+		},
+		{
+			.name = "postbuildaction", .type = FieldType::T_POST_BUILD_ACTION, .kind = ValueKind::V_ACTION,
+			.isRepeatable = true, .isMerged = true, .supportedIn = language_all,
+			.isSet = [](const ProfileData& p) { return !p.postBuildActions.empty(); },
+			.assign = AssignTexts<&ProfileData::postBuildActions>, .collect = CollectTexts<&ProfileData::postBuildActions>
+		},
+		{
+			.name = "targets", .type = FieldType::T_TARGETS, .kind = ValueKind::V_TARGET_LIST,
+			.isMultiValue = true, .supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return !p.targets.empty(); },
+			.values = binary_type_values, .assign = AssignTargets, .collect = CollectTargets
+		},
+		{
+			.name = "pgotraining", .type = FieldType::T_PGO_TRAINING, .kind = ValueKind::V_ACTION,
+			.isRepeatable = true, .isMerged = true, .supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return !p.pgoTraining.empty(); },
+			.assign = AssignTexts<&ProfileData::pgoTraining>, .collect = CollectTexts<&ProfileData::pgoTraining>
+		},
+		{
+			.name = "boltworkload", .type = FieldType::T_BOLT_WORKLOAD, .kind = ValueKind::V_ACTION,
+			.supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return !p.boltWorkload.empty(); },
+			.assign = AssignText<&ProfileData::boltWorkload>, .collect = CollectText<&ProfileData::boltWorkload>
+		},
+		{
+			.name = "microarch", .type = FieldType::T_MICROARCH, .kind = ValueKind::V_ENUM,
+			.isMultiValue = true, .supportedIn = language_c_cpp,
+			.isSet = [](const ProfileData& p) { return !p.microarch.empty(); },
+			.values = microarch_values, .assign = AssignTexts<&ProfileData::microarch>, .collect = CollectTexts<&ProfileData::microarch>
+		}
+	}};
+
+
+	//Slots of the field name lookup, a power of two larger than the field count
+	constexpr size_t field_slot_count = 64;
+	constexpr u8 field_slot_empty = 0xFFu;
+
+	//Seeded FNV-1a, the seed is picked at compile time so every field name gets its own slot
+	constexpr u32 HashFieldName(
+		string_view name,
+		u32 seed)
+	{
+		u32 hash = 2166136261u ^ seed;
+		for (char c : name)
+		{
+			hash ^= scast<u8>(c);
+			hash *= 16777619u;
+		}
+
+		//low bits of FNV-1a only depend on low bits of its input, fold the high bits in
+		return hash ^ (hash >> 16);
+	}
+
+	consteval u32 FindFieldSeed()
+	{
+		for (u32 seed = 0; seed < 100000; ++seed)
+		{
+			array<bool, field_slot_count> used{};
+			bool isPerfect = true;
+
+			for (const auto& f : field_schema)
+			{
+				size_t slot = HashFieldName(f.name, seed) & (field_slot_count - 1);
+				if (used[slot])
+				{
+					isPerfect = false;
+					break;
+				}
+
+				used[slot] = true;
+			}
+
+			if (isPerfect) return seed;
+		}
+
+		//not a constant expression, fails the build if no seed was found
+		throw "No perfect hash seed found for field names!";
+	}
+
+	constexpr u32 field_seed = FindFieldSeed();
+
+	consteval array<u8, field_slot_count> BuildFieldSlots()
+	{
+		array<u8, field_slot_count> slots{};
+		slots.fill(field_slot_empty);
+
+		for (size_t i = 0; i < field_schema.size(); ++i)
+		{
+			slots[HashFieldName(field_schema[i].name, field_seed) & (field_slot_count - 1)] = scast<u8>(i);
+		}
+
+		return slots;
+	}
+
+	constexpr array<u8, field_slot_count> field_slots = BuildFieldSlots();
+
+	class Schema
+	{
+	public:
+		//Returns nullptr if the name is not a field,
+		//costs one hash and one string compare
+		static constexpr const FieldSchema* FindField(string_view name)
+		{
+			u8 index = field_slots[HashFieldName(name, field_seed) & (field_slot_count - 1)];
+
+			if (index == field_slot_empty
+				|| field_schema[index].name != name)
+			{
+				return nullptr;
+			}
+
+			return &field_schema[index];
+		}
+
+		static constexpr const FieldSchema& GetField(FieldType type)
+		{
+			return field_schema[scast<u8>(type) - 1];
+		}
+
+		//Name an enum field value is written as in kmake files, empty for invalid values
+		template<typename E>
+		static constexpr string_view GetValueName(
+			FieldType type,
+			E value)
+		{
+			return FindValueName(GetField(type).values, scast<u8>(value));
+		}
+
+		//Closes with an error if the profile misses a field the language requires
+		//or uses a field or custom flag the language does not support
+		static void CheckLanguage(
+			const ProfileData& profile,
+			u8 language,
+			string_view languageName,
+			string_view target);
+	};
+
+	static_assert([]
+		{
+			for (size_t i = 0; i < field_schema.size(); ++i)
+			{
+				if (scast<size_t>(field_schema[i].type) != i + 1) return false;
+				if (Schema::FindField(field_schema[i].name) != &field_schema[i]) return false;
+			}
+			for (const auto& f : field_schema)
+			{
+				bool hasValues =
+					f.kind == ValueKind::V_ENUM
+					|| f.kind == ValueKind::V_TARGET_LIST;
+
+				if (hasValues == f.values.empty()
+					|| !f.assign
+					|| !f.collect)
+				{
+					return false;
+				}
+			}
+
+			return !Schema::FindField("profile")
+				&& !Schema::FindField("");
+		}(), "Field schema must be in FieldType order, every field name must be found and every field needs its values and accessors");
+}
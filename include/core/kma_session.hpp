@@ -0,0 +1,66 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <filesystem>
+#include <mutex>
+
+#include "core/kma_core.hpp"
+#include "core/kma_context.hpp"
+
+namespace KalaMake::Core
+{
+	using std::string;
+	using std::mutex;
+	using std::filesystem::path;
+
+	//Why a session call failed, target is the log tag of the part of kalamake that failed
+	struct BuildError
+	{
+		string target{};
+		string message{};
+	};
+
+	struct BuildResult
+	{
+		bool success{};
+		BuildError error{};
+	};
+
+	//Runs kalamake in-process for tools that embed it instead of calling the command line.
+	//Each session owns its parse state, directory listings and job slots,
+	//so sessions on different threads build at the same time. Calls of one session run one at a time
+	class BuildSession
+	{
+	public:
+		BuildSession(
+			const path& projectFile,
+			string_view profile)
+			: projectFile(projectFile),
+			profile(profile) {}
+
+		BuildSession(const BuildSession&) = delete;
+		BuildSession& operator=(const BuildSession&) = delete;
+
+		BuildResult Validate();
+		BuildResult Compile();
+		BuildResult Check();
+		BuildResult Clean();
+
+		//Final profile of the last successful Validate or Compile of this session
+		const GlobalData& GetData() const { return data; }
+	private:
+		BuildResult Run(StartType type);
+
+		path projectFile{};
+		string profile{};
+		GlobalData data{};
+
+		SessionContext context{};
+		mutex m_calls;
+	};
+}
@@ -0,0 +1,98 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <filesystem>
+
+#include "core/kma_core.hpp"
+
+namespace KalaMake::Core
+{
+	using std::vector;
+	using std::string;
+	using std::string_view;
+	using std::filesystem::path;
+
+	using u64 = uint64_t;
+	using i64 = int64_t;
+
+	//Files and subdirectories of one directory at the time it had the stored modification time
+	struct DirListing
+	{
+		i64 time{};
+		vector<string> files{};
+		vector<string> dirs{};
+	};
+
+	//Binary cache of a fully resolved profile, stored in its build path
+	//so no-op compiles can skip parsing and path resolution entirely
+	class Snapshot
+	{
+	public:
+		//Identifies the kmake content, its location and the chosen profile,
+		//any difference means the snapshot was made from another project state
+		static u64 GetKey(
+			string_view content,
+			const path& projectFile,
+			string_view profile);
+
+		//64-bit FNV-1a of the bytes of a file, 0 if it cannot be read
+		static u64 HashFile(const path& target);
+
+		//Where the snapshot of this profile lives inside its build path
+		static path GetPath(
+			const path& buildPath,
+			string_view profile);
+
+		//Fills outData and returns true if the snapshot matches the key
+		//and none of the directories or ignore files that were read have changed since it was saved
+		static bool Load(
+			const path& snapshotPath,
+			u64 key,
+			GlobalData& outData);
+
+		//Stores data and the current modification time of every traversed path,
+		//returns an error message on failure
+		static string Save(
+			const path& snapshotPath,
+			u64 key,
+			const GlobalData& data,
+			const vector<path>& traversedPaths);
+	};
+
+	//Persistent directory listings, a directory is only read again
+	//if its modification time differs from the cached listing.
+	//Unchanged directories cost one stat instead of a full read.
+	//The listings belong to the session bound to the calling thread
+	class DirCache
+	{
+	public:
+		//Where the listing cache lives inside a build path
+		static path GetPath(const path& buildPath);
+
+		//Replaces the in-memory listings with the cache file,
+		//a missing or outdated file just starts with an empty cache
+		static void Load(const path& cachePath);
+
+		//Writes the listings if any of them changed since Load,
+		//returns an error message on failure
+		static string Save(const path& cachePath);
+
+		static void Clear();
+
+		//Returns the sorted files and subdirectories of dir,
+		//symlinked directories are not listed as subdirectories
+		static const DirListing& List(const path& dir);
+
+		//Same as List for every dir at the same index, outdated dirs are read in parallel.
+		//The pointers stay valid until the next call that can change the cache
+		static void ListMany(
+			const vector<path>& dirs,
+			vector<const DirListing*>& outListings);
+	};
+}
@@ -0,0 +1,54 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <filesystem>
+#include <functional>
+
+#include "core/kma_core.hpp"
+
+namespace KalaMake::Core
+{
+	using std::vector;
+	using std::function;
+	using std::filesystem::path;
+	using std::filesystem::file_time_type;
+
+	//One file found by a walk with its modification time
+	struct WalkedFile
+	{
+		path filePath{};
+		file_time_type time{};
+	};
+
+	//Spreads directory reads and file stats over worker threads.
+	//Every tree walk of kalamake goes through here or through Glob, which uses the same listings
+	class Walker
+	{
+	public:
+		//Threads used for a single walk, independent of the jobs count of the profile
+		static u16 GetThreadCount();
+
+		//Calls job once for every index below count, small counts run on the calling thread.
+		//Jobs must only write to their own index of any shared output
+		static void ForEach(
+			size_t count,
+			const function<void(size_t)>& job);
+
+		//Modification time of every target at the same index,
+		//targets that cannot be read get file_time_type::min()
+		static void GetWriteTimes(
+			const vector<path>& targets,
+			vector<file_time_type>& outTimes);
+
+		//Every file below roots with its modification time, sorted by path.
+		//Each level of dirs is listed in parallel through the directory cache
+		static void Walk(
+			const vector<path>& roots,
+			vector<WalkedFile>& outFiles);
+	};
+}
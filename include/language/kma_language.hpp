@@ -10,11 +10,20 @@
 namespace KalaMake::Language
 {
 	using KalaMake::Core::GlobalData;
+	using std::filesystem::path;
 
 	class LanguageCore
 	{
 	public:
 		static void Compile_C_CPP(GlobalData& globalData);
+		//Output of a resolved C or C++ profile, used when another project links it
+		static path GetOutput_C_CPP(const GlobalData& globalData);
+		//Compiles one source of the profile to its usual object file without linking,
+		//diagnostics are also written next to the object file as json if requested
+		static void CompileFile_C_CPP(
+			GlobalData& globalData,
+			const path& source,
+			bool exportDiagnostics);
 		static void Compile_Java(GlobalData& globalData);
 		static void Compile_Zig(GlobalData& globalData);
 		static void Compile_Python(GlobalData& globalData);
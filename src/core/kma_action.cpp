@@ -0,0 +1,444 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <system_error>
+
+#include "core_utils.hpp"
+#include "log_utils.hpp"
+#include "string_utils.hpp"
+
+#include "core/kma_action.hpp"
+#include "core/kma_jobs.hpp"
+#include "core/kma_context.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using KalaHeaders::KalaString::TrimString;
+
+using KalaMake::Core::Action;
+using KalaMake::Core::BuildAction;
+using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::JobPool;
+using KalaMake::Core::SessionContext;
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::function;
+using std::max;
+using std::min;
+using std::atomic;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
+using std::error_code;
+using std::filesystem::path;
+using std::filesystem::file_time_type;
+using std::filesystem::last_write_time;
+
+//separates the declarations of an action from its command
+constexpr string_view declaration_end = " -> ";
+
+constexpr string_view declaration_in     = "in";
+constexpr string_view declaration_out    = "out";
+constexpr string_view declaration_relink = "relink";
+
+//Position of the ' -> ' that ends the declarations, npos for a plain command.
+//Declarations must start with 'in', 'out' or 'relink' so shell commands that contain ' -> ' stay commands
+static size_t FindDeclarationEnd(string_view value);
+
+//True if the action has outputs and all of them are newer than its inputs and the kmake file
+static bool IsUpToDate(
+	const BuildAction& action,
+	file_time_type kmakeTime);
+
+//True if b has to wait for a, which is when one writes what the other reads or writes
+static bool DependsOn(
+	const BuildAction& a,
+	const BuildAction& b);
+
+namespace KalaMake::Core
+{
+	string Action::Parse(
+		string_view value,
+		BuildAction& outAction)
+	{
+		outAction = BuildAction{};
+
+		size_t end = FindDeclarationEnd(value);
+		if (end == string_view::npos)
+		{
+			outAction.command = string(value);
+			return{};
+		}
+
+		outAction.command = TrimString(value.substr(end + declaration_end.size()));
+		if (outAction.command.empty()) return "Action has no command after '->'!";
+
+		string_view declarations = value.substr(0, end);
+
+		//tokens are split by spaces, quoted tokens can contain spaces
+		vector<path>* target{};
+		size_t i = 0;
+		while (i < declarations.size())
+		{
+			if (declarations[i] == ' '
+				|| declarations[i] == '\t')
+			{
+				++i;
+				continue;
+			}
+
+			string token{};
+			bool isQuoted = declarations[i] == '"';
+
+			if (isQuoted)
+			{
+				size_t close = declarations.find('"', i + 1);
+				if (close == string_view::npos) return "Declaration '" + string(declarations.substr(i)) + "' must end with quotes!";
+
+				token = string(declarations.substr(i + 1, close - i - 1));
+				i = close + 1;
+			}
+			else
+			{
+				size_t close = declarations.find_first_of(" \t", i);
+				if (close == string_view::npos) close = declarations.size();
+
+				token = string(declarations.substr(i, close - i));
+				i = close;
+			}
+
+			if (!isQuoted
+				&& token == declaration_in)
+			{
+				target = &outAction.inputs;
+			}
+			else if (!isQuoted
+				&& token == declaration_out)
+			{
+				target = &outAction.outputs;
+			}
+			else if (!isQuoted
+				&& token == declaration_relink)
+			{
+				outAction.onRelink = true;
+				target = nullptr;
+			}
+			else if (target
+				&& !token.empty())
+			{
+				target->emplace_back(token);
+			}
+			else return "Unexpected '" + token + "' before '->', expected 'in', 'out' or 'relink'!";
+		}
+
+		return{};
+	}
+
+	bool Action::IsGenerator(string_view value)
+	{
+		BuildAction action{};
+
+		return Parse(value, action).empty()
+			&& !action.outputs.empty();
+	}
+
+	vector<BuildAction> Action::Resolve(
+		const GlobalData& globalData,
+		const vector<string>& actions,
+		string_view target,
+		string_view stage)
+	{
+		path root = globalData.projectFile.parent_path();
+
+		vector<BuildAction> parsed{};
+		parsed.reserve(actions.size());
+
+		for (const auto& a : actions)
+		{
+			BuildAction action{};
+			string result = Parse(a, action);
+
+			if (!result.empty())
+			{
+				KalaMakeCore::CloseOnError(
+					target,
+					"Failed to parse " + string(stage) + " action '" + a + "'! Reason: " + result);
+			}
+
+			for (auto& p : action.inputs)  p = (p.is_relative() ? root / p : p).lexically_normal();
+			for (auto& p : action.outputs) p = (p.is_relative() ? root / p : p).lexically_normal();
+
+			parsed.push_back(std::move(action));
+		}
+
+		return parsed;
+	}
+
+	void Action::RunAll(
+		const GlobalData& globalData,
+		const vector<string>& actions,
+		bool relinked,
+		string_view target,
+		string_view stage,
+		const function<void(size_t, bool)>& onFinished)
+	{
+		error_code ec{};
+		file_time_type kmakeTime = last_write_time(globalData.projectFile, ec);
+
+		vector<BuildAction> parsed = Resolve(
+			globalData,
+			actions,
+			target,
+			stage);
+
+		vector<bool> isDeclared{};
+		for (const auto& a : actions) isDeclared.push_back(FindDeclarationEnd(a) != string_view::npos);
+
+		auto run_action = [
+			&parsed,
+			&relinked,
+			&kmakeTime,
+			&target,
+			&stage,
+			&onFinished](size_t index) -> void
+			{
+				const BuildAction& action = parsed[index];
+
+				if (action.onRelink
+					&& !relinked)
+				{
+					Log::Print(
+						"Skipping action '" + action.command + "' because no new binary was written.",
+						target,
+						LogType::LOG_INFO);
+
+					if (onFinished) onFinished(index, false);
+					return;
+				}
+
+				if (IsUpToDate(action, kmakeTime))
+				{
+					Log::Print(
+						"Skipping action '" + action.command + "' because its outputs are newer than its inputs.",
+						target,
+						LogType::LOG_INFO);
+
+					if (onFinished) onFinished(index, false);
+					return;
+				}
+
+				Log::Print("\naction: " + action.command);
+
+				if (JobPool::Run(action.command) != 0)
+				{
+					KalaMakeCore::CloseOnError(
+						target,
+						"Failed to run " + string(stage) + " action '" + action.command + "'!");
+				}
+
+				if (onFinished) onFinished(index, true);
+			};
+
+		//runs every action of one level, at most one per hardware thread at a time
+		auto run_together = [run_action](const vector<size_t>& level) -> void
+			{
+				if (level.size() == 1)
+				{
+					run_action(level[0]);
+					return;
+				}
+
+				size_t threadCount = min(
+					scast<size_t>(max(thread::hardware_concurrency(), 1u)),
+					level.size());
+
+				atomic<size_t> next{};
+				exception_ptr firstError{};
+				mutex m_firstError{};
+
+				SessionContext& context = SessionContext::Current();
+
+				vector<thread> workers{};
+				for (size_t i = 0; i < threadCount; ++i)
+				{
+					workers.emplace_back([
+						&context,
+						&level,
+						&next,
+						&firstError,
+						&m_firstError,
+						run_action]
+						{
+							SessionContext::Scope scope(context);
+
+							while (true)
+							{
+								size_t idx = next++;
+								if (idx >= level.size()) break;
+
+								try
+								{
+									run_action(level[idx]);
+								}
+								catch (...)
+								{
+									lock_guard<mutex> lock(m_firstError);
+									if (!firstError) firstError = current_exception();
+
+									next = level.size();
+									break;
+								}
+							}
+						});
+				}
+
+				for (auto& w : workers) w.join();
+
+				if (firstError) rethrow_exception(firstError);
+			};
+
+		size_t i = 0;
+		while (i < parsed.size())
+		{
+			//plain commands keep their place and run alone
+			if (!isDeclared[i])
+			{
+				run_together({ i });
+				++i;
+				continue;
+			}
+
+			size_t groupEnd = i;
+			while (groupEnd < parsed.size()
+				&& isDeclared[groupEnd])
+			{
+				++groupEnd;
+			}
+
+			//an action runs one level after the last earlier action it depends on
+			vector<size_t> levels(groupEnd - i, 0);
+			size_t lastLevel{};
+
+			for (size_t b = i; b < groupEnd; ++b)
+			{
+				for (size_t a = i; a < b; ++a)
+				{
+					if (DependsOn(parsed[a], parsed[b]))
+					{
+						levels[b - i] = max(levels[b - i], levels[a - i] + 1);
+					}
+				}
+
+				lastLevel = max(lastLevel, levels[b - i]);
+			}
+
+			for (size_t l = 0; l <= lastLevel; ++l)
+			{
+				vector<size_t> level{};
+				for (size_t a = i; a < groupEnd; ++a)
+				{
+					if (levels[a - i] == l) level.push_back(a);
+				}
+
+				run_together(level);
+			}
+
+			i = groupEnd;
+		}
+	}
+}
+
+size_t FindDeclarationEnd(string_view value)
+{
+	size_t start = value.find_first_not_of(" \t");
+	if (start == string_view::npos) return string_view::npos;
+
+	size_t tokenEnd = value.find_first_of(" \t\"", start);
+	if (tokenEnd == string_view::npos) return string_view::npos;
+
+	string_view first = value.substr(start, tokenEnd - start);
+	if (first != declaration_in
+		&& first != declaration_out
+		&& first != declaration_relink)
+	{
+		return string_view::npos;
+	}
+
+	//quoted paths can contain ' -> ' themselves
+	bool isQuoted{};
+	for (size_t i = tokenEnd; i < value.size(); ++i)
+	{
+		if (value[i] == '"') isQuoted = !isQuoted;
+		else if (!isQuoted
+			&& value.substr(i).starts_with(declaration_end))
+		{
+			return i;
+		}
+	}
+
+	return string_view::npos;
+}
+
+bool IsUpToDate(
+	const BuildAction& action,
+	file_time_type kmakeTime)
+{
+	if (action.outputs.empty()) return false;
+
+	file_time_type oldestOutput = file_time_type::max();
+	for (const auto& o : action.outputs)
+	{
+		error_code ec{};
+		file_time_type time = last_write_time(o, ec);
+		if (ec) return false;
+
+		oldestOutput = min(oldestOutput, time);
+	}
+
+	if (oldestOutput < kmakeTime) return false;
+
+	for (const auto& i : action.inputs)
+	{
+		error_code ec{};
+		file_time_type time = last_write_time(i, ec);
+
+		//missing inputs are left for the command to report
+		if (ec
+			|| time > oldestOutput)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool DependsOn(
+	const BuildAction& a,
+	const BuildAction& b)
+{
+	for (const auto& o : a.outputs)
+	{
+		for (const auto& i : b.inputs)  if (o == i) return true;
+		for (const auto& p : b.outputs) if (o == p) return true;
+	}
+	for (const auto& i : a.inputs)
+	{
+		for (const auto& p : b.outputs) if (i == p) return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,38 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include "core/kma_context.hpp"
+
+using KalaMake::Core::SessionContext;
+using KalaMake::Core::KalaMakeCore;
+
+//each thread works for one session at a time, engine threads bind the context of the thread that started them
+static thread_local SessionContext* boundContext{};
+
+namespace KalaMake::Core
+{
+	SessionContext::Scope::Scope(SessionContext& context)
+		: previous(boundContext)
+	{
+		boundContext = &context;
+	}
+
+	SessionContext::Scope::~Scope()
+	{
+		boundContext = previous;
+	}
+
+	SessionContext& SessionContext::Current()
+	{
+		if (!boundContext)
+		{
+			KalaMakeCore::CloseOnError(
+				"KALAMAKE",
+				"No session context is bound to this thread!");
+		}
+
+		return *boundContext;
+	}
+}
@@ -9,12 +9,18 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <sstream>
 #include <filesystem>
 #include <string>
 #include <utility>
 #include <vector>
+#include <span>
 #include <unordered_map>
+#include <system_error>
+#include <thread>
+#include <mutex>
+#include <exception>
 #include <functional>
 
 #include "core_utils.hpp"
@@ -26,6 +32,14 @@
 
 #include "language/kma_language.hpp"
 #include "core/kma_core.hpp"
+#include "core/kma_parse.hpp"
+#include "core/kma_mapped_file.hpp"
+#include "core/kma_snapshot.hpp"
+#include "core/kma_glob.hpp"
+#include "core/kma_schema.hpp"
+#include "core/kma_jobs.hpp"
+#include "core/kma_action.hpp"
+#include "core/kma_context.hpp"
 
 using KalaHeaders::KalaCore::EnumHash;
 using KalaHeaders::KalaCore::IsComparable;
@@ -34,39 +48,50 @@ using KalaHeaders::KalaCore::AnyEnumAndStringMap;
 using KalaHeaders::KalaCore::AnyEnum;
 using KalaHeaders::KalaCore::StringToEnum;
 using KalaHeaders::KalaCore::RemoveDuplicates;
+using KalaHeaders::KalaCore::ContainsValue;
 
 using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
 
-using KalaHeaders::KalaFile::ReadLinesFromFile;
 using KalaHeaders::KalaFile::ResolveAnyPath;
 using KalaHeaders::KalaFile::ToStringVector;
-using KalaHeaders::KalaFile::ToPathVector;
 using KalaHeaders::KalaFile::PathTarget;
 using KalaHeaders::KalaFile::CreateNewDirectory;
 using KalaHeaders::KalaFile::DeletePath;
 
 using KalaHeaders::KalaString::SplitString;
-using KalaHeaders::KalaString::ReplaceAfter;
 using KalaHeaders::KalaString::TrimString;
 using KalaHeaders::KalaString::ContainsSpace;
 using KalaHeaders::KalaString::ContainsUnsafeFileChar;
 using KalaHeaders::KalaString::ContainsAlpha;
 
 using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::SessionContext;
+using KalaMake::Core::Parse;
+using KalaMake::Core::MappedFile;
+using KalaMake::Core::Snapshot;
+using KalaMake::Core::Glob;
+using KalaMake::Core::GlobSet;
+using KalaMake::Core::GlobTarget;
+using KalaMake::Core::Schema;
+using KalaMake::Core::JobPool;
+using KalaMake::Core::Action;
+using KalaMake::Core::BuildAction;
+using KalaMake::Core::FieldSchema;
+using KalaMake::Core::SchemaValue;
+using KalaMake::Core::FindValue;
+using KalaMake::Core::ValueKind;
+using KalaMake::Core::ProjectIndex;
+using KalaMake::Core::CategoryRecord;
 using KalaMake::Core::ReferenceData;
+using KalaMake::Core::ReferenceState;
 using KalaMake::Core::GlobalData;
 using KalaMake::Core::Version;
 using KalaMake::Core::CategoryType;
 using KalaMake::Core::FieldType;
-using KalaMake::Core::CompilerLauncherType;
 using KalaMake::Core::CompilerType;
 using KalaMake::Core::StandardType;
-using KalaMake::Core::TargetType;
-using KalaMake::Core::BuildType;
 using KalaMake::Core::BinaryType;
-using KalaMake::Core::WarningLevel;
-using KalaMake::Core::CustomFlag;
 using KalaMake::Language::LanguageCore;
 
 using std::ostringstream;
@@ -74,141 +99,57 @@ using std::filesystem::exists;
 using std::filesystem::path;
 using std::filesystem::current_path;
 using std::filesystem::weakly_canonical;
+using std::filesystem::absolute;
 using std::filesystem::is_directory;
 using std::filesystem::is_regular_file;
-using std::filesystem::recursive_directory_iterator;
 using std::filesystem::filesystem_error;
+using std::error_code;
 using std::string;
 using std::string_view;
+using std::span;
 using std::to_string;
 using std::vector;
 using std::unordered_map;
+using std::find_if;
 using std::function;
+using std::max;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
 
 using u16 = uint16_t;
+using u64 = uint64_t;
 
 constexpr string_view version_1_0 = "1.0";
 
+//passed instead of profile names to compile or check every user profile
+constexpr string_view all_profiles_param = "--all-profiles";
+
+//links to another kalamake project are written as 'path/project.kmake:profile'
+constexpr string_view project_link_marker = ".kmake:";
+
 constexpr string_view category_version    = "version";
 constexpr string_view category_references = "references";
 constexpr string_view category_global     = "global";
 constexpr string_view category_profile    = "profile";
 
-constexpr string_view field_binary_type       = "binarytype";
-constexpr string_view field_compiler_launcher = "compilerlauncher";
-constexpr string_view field_compiler          = "compiler";
-constexpr string_view field_standard          = "standard";
-constexpr string_view field_target_type       = "targettype";
-constexpr string_view field_jobs              = "jobs";
-constexpr string_view field_binary_name       = "binaryname";
-constexpr string_view field_build_type        = "buildtype";
-constexpr string_view field_build_path        = "buildpath";
-constexpr string_view field_sources           = "sources";
-constexpr string_view field_headers           = "headers";
-constexpr string_view field_links             = "links";
-constexpr string_view field_warning_level     = "warninglevel";
-constexpr string_view field_defines           = "defines";
-constexpr string_view field_compile_flags     = "compileflags";
-constexpr string_view field_link_flags        = "linkflags";
-constexpr string_view field_custom_flags      = "customflags";
-constexpr string_view field_pre_build_action  = "prebuildaction";
-constexpr string_view field_post_build_action = "postbuildaction";
-
-constexpr string_view binary_type_executable = "executable";
-constexpr string_view binary_type_static     = "static";
-constexpr string_view binary_type_shared     = "shared";
-
-constexpr string_view compiler_launcher_ccache  = "ccache";
-constexpr string_view compiler_launcher_sccache = "sccache";
-constexpr string_view compiler_launcher_distcc  = "distcc";
-constexpr string_view compiler_launcher_icecc   = "icecc";
-
-constexpr string_view compiler_zig      = "zig";
-constexpr string_view compiler_clang_cl = "clang-cl";
-constexpr string_view compiler_cl       = "cl";
-constexpr string_view compiler_clang    = "clang";
-constexpr string_view compiler_clangpp  = "clang++";
-constexpr string_view compiler_gcc      = "gcc";
-constexpr string_view compiler_gpp      = "g++";
-constexpr string_view compiler_java     = "java";
-constexpr string_view compiler_python   = "python";
-constexpr string_view compiler_rust     = "rust";
-
-constexpr string_view standard_c89    = "c89";
-constexpr string_view standard_c99    = "c99";
-constexpr string_view standard_c11    = "c11";
-constexpr string_view standard_c17    = "c17";
-constexpr string_view standard_c23    = "c23";
-constexpr string_view standard_cpp14  = "c++14";
-constexpr string_view standard_cpp17  = "c++17";
-constexpr string_view standard_cpp20  = "c++20";
-constexpr string_view standard_cpp23  = "c++23";
-constexpr string_view standard_cpp26  = "c++26";
-constexpr string_view standard_java8  = "java8";
-constexpr string_view standard_java9  = "java9";
-constexpr string_view standard_java10 = "java10";
-constexpr string_view standard_java11 = "java11";
-constexpr string_view standard_java12 = "java12";
-constexpr string_view standard_java13 = "java13";
-constexpr string_view standard_java14 = "java14";
-constexpr string_view standard_java15 = "java15";
-constexpr string_view standard_java16 = "java16";
-constexpr string_view standard_java17 = "java17";
-constexpr string_view standard_java18 = "java18";
-constexpr string_view standard_java19 = "java19";
-constexpr string_view standard_java20 = "java20";
-constexpr string_view standard_java21 = "java21";
-constexpr string_view standard_java22 = "java22";
-constexpr string_view standard_java23 = "java23";
-constexpr string_view standard_java24 = "java24";
-constexpr string_view standard_java25 = "java25";
-constexpr string_view standard_java26 = "java26";
-constexpr string_view standard_rust15 = "rust15";
-constexpr string_view standard_rust18 = "rust18";
-constexpr string_view standard_rust21 = "rust21";
-constexpr string_view standard_rust24 = "rust24";
-
-constexpr string_view target_type_linux_gnu    = "linux-gnu";
-constexpr string_view target_type_linux_musl   = "linux-musl";
-constexpr string_view target_type_windows_gnu  = "windows-gnu";
-constexpr string_view target_type_windows_msvc = "windows-msvc";
-
-constexpr string_view build_type_debug      = "debug";
-constexpr string_view build_type_release    = "release";
-constexpr string_view build_type_reldebug   = "reldebug";
-constexpr string_view build_type_minsizerel = "minsizerel";
-
-constexpr string_view warning_level_none   = "none";
-constexpr string_view warning_level_basic  = "basic";
-constexpr string_view warning_level_normal = "normal";
-constexpr string_view warning_level_strong = "strong";
-constexpr string_view warning_level_strict = "strict";
-constexpr string_view warning_level_all    = "all";
-
-constexpr string_view custom_export_comp_comm    = "export-compile-commands";
-constexpr string_view custom_export_vscode_sln   = "export-vscode-sln";
-constexpr string_view custom_warnings_as_err     = "warnings-as-errors";
-constexpr string_view custom_msvc_static_runtime = "msvc-static-runtime";
-constexpr string_view custom_generate_symbols    = "generate-symbols";
-constexpr string_view custom_no_console          = "no-console";
-constexpr string_view custom_package_jar         = "package-jar";
-constexpr string_view custom_java_win_console    = "java-win-console";
-constexpr string_view custom_export_java_sln     = "export-java-sln";
-constexpr string_view custom_python_one_file     = "python-one-file";
-
-//kma path is the root directory where the kmake file is stored at
-static path kmaPath{};
-
-static string targetProfile{};
-
-static bool foundVersion{};
-static bool foundReferences{};
-static bool foundGlobal{};
-static bool foundTargetProfile{};
-static bool foundAnyUserProfile{};
-
-static GlobalData globalData{};
-static path projectFile{};
+//A linked project reached through 'path/project.kmake:profile' links
+struct WorkspaceNode
+{
+	//canonical kmake path and profile of the link
+	string key{};
+	GlobalData data{};
+	//what the links of every project that links this one are replaced with
+	path output{};
+	//linked projects of a level only link projects of lower levels
+	size_t level{};
+};
+
+//matches nothing, for path fields that have no '!' values
+static const GlobSet noExclusions{};
 
 static u16 GetThreadCount()
 {
@@ -221,11 +162,17 @@ static u16 GetThreadCount()
 
 static void CleanEverything()
 {
-	foundVersion = false;
-	foundReferences = false;
-	foundGlobal = false;
-	foundAnyUserProfile = false;
-	globalData = GlobalData{};
+	SessionContext& context = SessionContext::Current();
+
+	context.traversedPaths.clear();
+	context.sourceExclusions.Clear();
+
+	context.foundVersion = false;
+	context.foundReferences = false;
+	context.foundGlobal = false;
+	context.foundTargetProfile = false;
+	context.foundAnyUserProfile = false;
+	context.globalData = GlobalData{};
 }
 
 template<AnyEnumAndStringMap T>
@@ -301,25 +248,105 @@ static bool GetEnumFromMap(
 	return true;
 }
 
+//Trims whitespace from both ends of a view without copying it
+static string_view TrimView(string_view value)
+{
+	constexpr string_view whitespace = " \t\r\n\v\f";
+
+	size_t first = value.find_first_not_of(whitespace);
+	if (first == string_view::npos) return {};
+
+	size_t last = value.find_last_not_of(whitespace);
+	return value.substr(first, last - first + 1);
+}
+
+//Quoted names of every value of an enum field for error messages
+static string ListValues(span<const SchemaValue> values)
+{
+	string result{};
+	for (const auto& v : values)
+	{
+		if (!result.empty()) result += ", ";
+		result += "'" + string(v.name) + "'";
+	}
+
+	return result;
+}
+
+//Splits multi-value fields on commas outside quotes and braces
+//so globs like '*.{c,cpp}' stay whole, each value is trimmed
+static vector<string> SplitFieldValues(string_view value)
+{
+	vector<string> result{};
+
+	bool inQuotes{};
+	size_t braceDepth{};
+	size_t start = 0;
+
+	for (size_t i = 0; i <= value.size(); ++i)
+	{
+		if (i < value.size())
+		{
+			char c = value[i];
+
+			if (c == '"') inQuotes = !inQuotes;
+			else if (c == '{') ++braceDepth;
+			else if (c == '}'
+				&& braceDepth > 0)
+			{
+				--braceDepth;
+			}
+
+			if (c != ','
+				|| inQuotes
+				|| braceDepth > 0)
+			{
+				continue;
+			}
+		}
+
+		string_view part = TrimView(value.substr(start, i - start));
+		if (!part.empty()) result.emplace_back(part);
+
+		start = i + 1;
+	}
+
+	return result;
+}
+
+//Turns a path value into an absolute pattern with '/' separators,
+//relative values are relative to the kmake file
+static string ToGenericPattern(string_view value)
+{
+	SessionContext& context = SessionContext::Current();
+
+	path p(value);
+	if (p.is_relative()) p = context.kmaPath / p;
+
+	error_code ec{};
+	path absolutePath = absolute(p, ec);
+	if (!ec) p = absolutePath;
+
+	return p.lexically_normal().generic_string();
+}
+
 static void ExtractCategoryData(
-	const string& line,
-	string& outCategoryName,
-	string& outCategoryValue)
+	string_view line,
+	string_view& outCategoryName,
+	string_view& outCategoryValue)
 {
 	if (!line.starts_with('#')) return;
 
-	string newLine = line;
-	
-	newLine.erase(0,  1);
+	string_view newLine = line.substr(1);
 	if (newLine.empty())
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
-			"Failed to resolve category '" + line + "' because it had no type or value!");
+			"Failed to resolve category '" + string(line) + "' because it had no type or value!");
 	}
 
 	size_t spacePos = newLine.find(' ');
-	string name = newLine.substr(0, spacePos);
+	string_view name = newLine.substr(0, spacePos);
 
 	auto is_valid_category = [](string_view name) -> bool
 	{
@@ -333,7 +360,7 @@ static void ExtractCategoryData(
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
-			"Failed to resolve category '" + line + "' because it does not exist!");
+			"Failed to resolve category '" + string(line) + "' because it does not exist!");
 	}
 
 	//early exit for valueless ref and global categories
@@ -345,20 +372,20 @@ static void ExtractCategoryData(
 	}
 
 	//space must exist after '#profile' and '#version'
-	if (spacePos == string::npos)
+	if (spacePos == string_view::npos)
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
-			"Failed to resolve category '" + line + "' because its value was empty!");
+			"Failed to resolve category '" + string(line) + "' because its value was empty!");
 	}
 
 	//must contain non-space value after '#profile ' and '#version '
 	size_t valueStart = newLine.find_first_not_of(' ', spacePos + 1);
-	if (valueStart == string::npos)
+	if (valueStart == string_view::npos)
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
-			"Failed to resolve category '" + line + "' because its value was empty!");
+			"Failed to resolve category '" + string(line) + "' because its value was empty!");
 	}
 
 	outCategoryName = name;
@@ -366,15 +393,47 @@ static void ExtractCategoryData(
 }
 
 static void ExtractFieldData(
-	const string& line,
+	string_view line,
 	string& outFieldName,
 	vector<string>& outFieldValues,
 	bool isReference = false);
 
-static void FirstParse(const vector<string>& lines);
+static ProjectIndex Tokenize(string_view content);
+
+static void LoadReferences(const CategoryRecord& category);
+
+static void FirstParse(const ProjectIndex& index);
+
+static path FindSnapshotPath(const ProjectIndex& index);
+
+static void RecordTraversal(
+	const vector<path>& visitedPaths,
+	const vector<path>& resolvedPaths);
+
+static void CollectSourceExclusions(const CategoryRecord& category);
+
+//Unresolved lines of one field in the order the field first appeared
+struct FieldLines
+{
+	string name{};
+	//nullptr for unknown names, they are reported when the first line is resolved
+	const FieldSchema* schema{};
+	vector<string_view> lines{};
+};
+
+//Groups the raw field lines of a category by field name without resolving any value
+static void CollectFieldLines(
+	const CategoryRecord& category,
+	vector<FieldLines>& outFields);
 
 static string TranslateReferences(string_view value);
 
+//Splits a 'project.kmake:profile' link, false for every other link
+static bool SplitProjectLink(
+	const path& link,
+	path& outProject,
+	string& outProfile);
+
 namespace KalaMake::Core
 {
 	static const unordered_map<Version, string_view, EnumHash<Version>> versions =
@@ -390,164 +449,58 @@ namespace KalaMake::Core
 		{ CategoryType::C_PROFILE,    category_profile }
 	};
 
-	static const unordered_map<FieldType, string_view, EnumHash<FieldType>> fieldTypes =
-	{
-		{ FieldType::T_BINARY_TYPE,       field_binary_type },
-		{ FieldType::T_COMPILER_LAUNCHER, field_compiler_launcher },
-		{ FieldType::T_COMPILER,          field_compiler },
-		{ FieldType::T_STANDARD,          field_standard },
-		{ FieldType::T_TARGET_TYPE,       field_target_type },
-		{ FieldType::T_JOBS,              field_jobs },
-
-		{ FieldType::T_BINARY_NAME,    field_binary_name },
-		{ FieldType::T_BUILD_TYPE,     field_build_type },
-		{ FieldType::T_BUILD_PATH,     field_build_path },
-		{ FieldType::T_SOURCES,        field_sources },
-		{ FieldType::T_HEADERS,        field_headers },
-		{ FieldType::T_LINKS,          field_links },
-		{ FieldType::T_WARNING_LEVEL,  field_warning_level },
-		{ FieldType::T_DEFINES,        field_defines },
-		{ FieldType::T_COMPILE_FLAGS,  field_compile_flags },
-		{ FieldType::T_LINK_FLAGS,     field_link_flags },
-		{ FieldType::T_CUSTOM_FLAGS,   field_custom_flags },
-
-		{ FieldType::T_PRE_BUILD_ACTION, field_pre_build_action },
-		{ FieldType::T_POST_BUILD_ACTION, field_post_build_action }
-	};
-
-	static const unordered_map<BinaryType, string_view, EnumHash<BinaryType>> binaryTypes =
-	{
-		{ BinaryType::B_EXECUTABLE, binary_type_executable },
-		{ BinaryType::B_STATIC,     binary_type_static },
-		{ BinaryType::B_SHARED,     binary_type_shared }
-	};
-
-	static const unordered_map<CompilerLauncherType, string_view, EnumHash<CompilerLauncherType>> compilerLauncherTypes =
-	{
-		{ CompilerLauncherType::C_CCACHE,  compiler_launcher_ccache },
-		{ CompilerLauncherType::C_SCCACHE, compiler_launcher_sccache },
-		{ CompilerLauncherType::C_DISTCC,  compiler_launcher_distcc },
-		{ CompilerLauncherType::C_ICECC,   compiler_launcher_icecc }
-	};
-
-	static const unordered_map<CompilerType, string_view, EnumHash<CompilerType>> compilerTypes =
-	{
-		{ CompilerType::C_ZIG,      compiler_zig },
-		{ CompilerType::C_CLANG_CL, compiler_clang_cl },
-		{ CompilerType::C_CL,       compiler_cl },
-
-		{ CompilerType::C_CLANG,   compiler_clang },
-		{ CompilerType::C_CLANGPP, compiler_clangpp },
-		{ CompilerType::C_GCC,     compiler_gcc },
-		{ CompilerType::C_GPP,     compiler_gpp },
-
-		{ CompilerType::C_JAVA,   compiler_java },
-		{ CompilerType::C_PYTHON, compiler_python },
-		{ CompilerType::C_RUST,   compiler_rust }
-	};
-
-	static const unordered_map<StandardType, string_view, EnumHash<StandardType>> standardTypes =
-	{
-		{ StandardType::C_89, standard_c89 },
-		{ StandardType::C_99, standard_c99 },
-		{ StandardType::C_11, standard_c11 },
-		{ StandardType::C_17, standard_c17 },
-		{ StandardType::C_23, standard_c23 },
-
-		{ StandardType::CPP_14, standard_cpp14 },
-		{ StandardType::CPP_17, standard_cpp17 },
-		{ StandardType::CPP_20, standard_cpp20 },
-		{ StandardType::CPP_23, standard_cpp23 },
-		{ StandardType::CPP_26, standard_cpp26 },
-
-		{ StandardType::JAVA_8,  standard_java8 },
-		{ StandardType::JAVA_9,  standard_java9 },
-		{ StandardType::JAVA_10, standard_java10 },
-		{ StandardType::JAVA_11, standard_java11 },
-		{ StandardType::JAVA_12, standard_java12 },
-		{ StandardType::JAVA_13, standard_java13 },
-		{ StandardType::JAVA_14, standard_java14 },
-		{ StandardType::JAVA_15, standard_java15 },
-		{ StandardType::JAVA_16, standard_java16 },
-		{ StandardType::JAVA_17, standard_java17 },
-		{ StandardType::JAVA_18, standard_java18 },
-		{ StandardType::JAVA_19, standard_java19 },
-		{ StandardType::JAVA_20, standard_java20 },
-		{ StandardType::JAVA_21, standard_java21 },
-		{ StandardType::JAVA_22, standard_java22 },
-		{ StandardType::JAVA_23, standard_java23 },
-		{ StandardType::JAVA_24, standard_java24 },
-		{ StandardType::JAVA_25, standard_java25 },
-		{ StandardType::JAVA_26, standard_java26 },
-
-		{ StandardType::RUST_15,     standard_rust15 },
-		{ StandardType::RUST_18,     standard_rust18 },
-		{ StandardType::RUST_21,     standard_rust21 },
-		{ StandardType::RUST_24,     standard_rust24 }
-	};
-
-	static const unordered_map<TargetType, string_view, EnumHash<TargetType>> targetTypes =
-	{
-		{ TargetType::T_LINUX_GNU,    target_type_linux_gnu },
-		{ TargetType::T_LINUX_MUSL,   target_type_linux_musl },
-		{ TargetType::T_WINDOWS_GNU,  target_type_windows_gnu },
-		{ TargetType::T_WINDOWS_MSVC, target_type_windows_msvc }
-	};
-
-	static const unordered_map<BuildType, string_view, EnumHash<BuildType>> buildTypes =
-	{
-		{ BuildType::B_DEBUG,      build_type_debug },
-		{ BuildType::B_RELEASE,    build_type_release },
-		{ BuildType::B_RELDEBUG,   build_type_reldebug },
-		{ BuildType::B_MINSIZEREL, build_type_minsizerel }
-	};
-
-	//Same warning types are used for both MSVC and GNU,
-	//their true meanings change depending on which OS is used
-	static const unordered_map<WarningLevel, string_view, EnumHash<WarningLevel>> warningLevels =
-	{
-		{ WarningLevel::W_NONE,   warning_level_none },
-		{ WarningLevel::W_BASIC,  warning_level_basic },
-		{ WarningLevel::W_NORMAL, warning_level_normal },
-		{ WarningLevel::W_STRONG, warning_level_strong },
-		{ WarningLevel::W_STRICT, warning_level_strict },
-		{ WarningLevel::W_ALL,    warning_level_all }
-	};
-
-	//Same warning types are used for both MSVC and GNU,
-	//their true meanings change depending on which OS is used
-	static const unordered_map<CustomFlag, string_view, EnumHash<CustomFlag>> customFlags =
-	{
-		{ CustomFlag::F_EXPORT_COMPILE_COMMANDS, custom_export_comp_comm },
-		{ CustomFlag::F_EXPORT_VSCODE_SLN,       custom_export_vscode_sln },
-		{ CustomFlag::F_WARNINGS_AS_ERRORS,      custom_warnings_as_err },
-		{ CustomFlag::F_MSVC_STATIC_RUNTIME,     custom_msvc_static_runtime },
-		{ CustomFlag::F_GENERATE_SYMBOLS,        custom_generate_symbols },
-		{ CustomFlag::F_NO_CONSOLE,              custom_no_console },
-		{ CustomFlag::F_PACKAGE_JAR,             custom_package_jar },
-		{ CustomFlag::F_JAVA_WIN_CONSOLE,        custom_java_win_console },
-		{ CustomFlag::F_EXPORT_JAVA_SLN,         custom_export_java_sln },
-		{ CustomFlag::F_PYTHON_ONE_FILE,         custom_python_one_file }
-	};
-
 	void KalaMakeCore::OpenFile(
+		SessionContext& context,
 		StartType type,
 		const vector<string>& params)
 	{
+		//every stage below and every thread it starts works on this context
+		SessionContext::Scope scope(context);
+
 		ostringstream details{};
 
 		Log::Print(details.str());
 
-		projectFile = params[1];
+		//nothing of a previous run of the same context may leak into this one
+		CleanEverything();
+		context.targetProfile.clear();
+		context.targetProfiles.clear();
+		context.singleSource.clear();
+		context.exportDiagnostics = false;
+
+		context.projectFile = params[1];
 		if (type == StartType::S_COMPILE 
-			|| type == StartType::S_VALIDATE) targetProfile = params[2];
+			|| type == StartType::S_VALIDATE
+			|| type == StartType::S_COMPILE_FILE
+			|| type == StartType::S_CHECK) context.targetProfile = params[2];
+
+		if (type == StartType::S_COMPILE
+			|| type == StartType::S_CHECK)
+		{
+			context.targetProfiles.assign(params.begin() + 2, params.end());
+		}
+		else if (!context.targetProfile.empty()) context.targetProfiles = { context.targetProfile };
+
+		if (type == StartType::S_COMPILE_FILE)
+		{
+			context.singleSource = absolute(params[3]);
+			context.exportDiagnostics = params.size() > 4 && params[4] == "json";
 
-		string& currentDir = KalaCLI::Core::GetCurrentDir();
-		if (currentDir.empty()) currentDir = current_path().string();
+			if (!is_regular_file(context.singleSource))
+			{
+				KalaMakeCore::CloseOnError(
+					"KALAMAKE",
+					"Source '" + context.singleSource.string() + "' does not exist!");
+			}
+		}
+
+		//read only, sessions on other threads resolve their projects at the same time
+		path currentDir = KalaCLI::Core::GetCurrentDir();
+		if (currentDir.empty()) currentDir = current_path();
 
-		auto first_parse = [](
+		auto first_parse = [&context](
 			const path& filePath,
-			const vector<string>& lines,
+			const ProjectIndex& index,
 			StartType type) -> void
 			{
 				Log::Print(
@@ -556,9 +509,9 @@ namespace KalaMake::Core
 					"KALAMAKE",
 					LogType::LOG_INFO);
 
-				FirstParse(lines);
+				FirstParse(index);
 
-				if (globalData.targetProfile.binaryType == BinaryType::B_INVALID)
+				if (context.globalData.targetProfile.binaryType == BinaryType::B_INVALID)
 				{
 					KalaMakeCore::CloseOnError(
 						"KALAMAKE",
@@ -566,17 +519,19 @@ namespace KalaMake::Core
 				}
 
 				//assume global profile if none was set
-				if (globalData.targetProfile.profileName.empty())
+				if (context.globalData.targetProfile.profileName.empty())
 				{
-					globalData.targetProfile.profileName = "global";
+					context.globalData.targetProfile.profileName = "global";
 				}
 
 				//always check for a compiler unless global profile is used and a user profile is found.
 				if (type == StartType::S_COMPILE 
-					|| globalData.targetProfile.profileName != "global"
-					|| !foundAnyUserProfile)
+					|| type == StartType::S_COMPILE_FILE
+					|| type == StartType::S_CHECK
+					|| context.globalData.targetProfile.profileName != "global"
+					|| !context.foundAnyUserProfile)
 				{
-					if (globalData.targetProfile.compiler == CompilerType::C_INVALID)
+					if (context.globalData.targetProfile.compiler == CompilerType::C_INVALID)
 					{	
 						KalaMakeCore::CloseOnError(
 							"KALAMAKE",
@@ -584,13 +539,13 @@ namespace KalaMake::Core
 					}
 
 				}
-				if (globalData.targetProfile.binaryName.empty())
+				if (context.globalData.targetProfile.binaryName.empty())
 				{
 					KalaMakeCore::CloseOnError(
 						"KALAMAKE",
 						"No binary name was passed!");
 				}
-				if (globalData.targetProfile.binaryName.size() > 50)
+				if (context.globalData.targetProfile.binaryName.size() > 50)
 				{
 					KalaMakeCore::CloseOnError(
 						"KALAMAKE",
@@ -598,42 +553,52 @@ namespace KalaMake::Core
 				}
 				//always check for a build path unless global profile is used and a user profile is found.
 				if (type == StartType::S_COMPILE 
-					|| globalData.targetProfile.profileName != "global"
-					|| !foundAnyUserProfile)
+					|| type == StartType::S_COMPILE_FILE
+					|| type == StartType::S_CHECK
+					|| context.globalData.targetProfile.profileName != "global"
+					|| !context.foundAnyUserProfile)
 				{
-					if (globalData.targetProfile.buildPath.empty())
+					if (context.globalData.targetProfile.buildPath.empty())
 					{
 						KalaMakeCore::CloseOnError(
 							"KALAMAKE",
 							"No build path was passed!");
 					}
 				}
-				if (globalData.targetProfile.sources.empty())
+				//generators can write every source during the build
+				bool hasGenerators{};
+				for (const auto& a : context.globalData.targetProfile.preBuildActions)
+				{
+					if (Action::IsGenerator(a)) hasGenerators = true;
+				}
+
+				if (context.globalData.targetProfile.sources.empty()
+					&& !hasGenerators)
 				{
 					KalaMakeCore::CloseOnError(
 						"KALAMAKE",
 						"No sources were passed!");
 				}
 
-				if (globalData.targetProfile.compiler == CompilerType::C_CLANG_CL
-					|| globalData.targetProfile.compiler == CompilerType::C_CL
-					|| globalData.targetProfile.compiler == CompilerType::C_CLANG
-					|| globalData.targetProfile.compiler == CompilerType::C_CLANGPP
-					|| globalData.targetProfile.compiler == CompilerType::C_GCC
-					|| globalData.targetProfile.compiler == CompilerType::C_GPP
-					|| (globalData.targetProfile.compiler == CompilerType::C_ZIG
-					&& globalData.targetProfile.standard != StandardType::S_INVALID))
+				if (context.globalData.targetProfile.compiler == CompilerType::C_CLANG_CL
+					|| context.globalData.targetProfile.compiler == CompilerType::C_CL
+					|| context.globalData.targetProfile.compiler == CompilerType::C_CLANG
+					|| context.globalData.targetProfile.compiler == CompilerType::C_CLANGPP
+					|| context.globalData.targetProfile.compiler == CompilerType::C_GCC
+					|| context.globalData.targetProfile.compiler == CompilerType::C_GPP
+					|| (context.globalData.targetProfile.compiler == CompilerType::C_ZIG
+					&& context.globalData.targetProfile.standard != StandardType::S_INVALID))
 				{
 					//assign cpu thread count if none was assigned
-					if (globalData.targetProfile.jobs == 0) globalData.targetProfile.jobs = GetThreadCount();
+					if (context.globalData.targetProfile.jobs == 0) context.globalData.targetProfile.jobs = JobPool::GetDefaultJobCount();
 
 					Log::Print(
-						"Using '" + to_string(globalData.targetProfile.jobs) + "' jobs for compilation.\n",
+						"Using '" + to_string(context.globalData.targetProfile.jobs) + "' jobs for compilation.\n",
 						"KALAMAKE",
 						LogType::LOG_INFO);
 				}
 
-				globalData.projectFile = weakly_canonical(projectFile);
+				context.globalData.projectFile = weakly_canonical(context.projectFile);
 
 				Log::Print(
 					"Finished first parse!\n",
@@ -642,17 +607,20 @@ namespace KalaMake::Core
 
 				Log::Print("===========================================================================\n");
 
-				CompilerType c = globalData.targetProfile.compiler;
-
 				if (type == StartType::S_VALIDATE)
 				{
 						Log::Print(
 					"Finished validating, kalamake file is valid!",
 					"KALAMAKE",
 					LogType::LOG_SUCCESS);
-
-					return;
 				}
+			};
+
+		auto compile_project = [type](GlobalData& data) -> void
+			{
+				data.checkOnly = type == StartType::S_CHECK;
+
+				CompilerType c = data.targetProfile.compiler;
 
 				if (c == CompilerType::C_ZIG
 					|| c == CompilerType::C_CL
@@ -663,23 +631,56 @@ namespace KalaMake::Core
 					|| c == CompilerType::C_GPP)
 				{
 					if (c == CompilerType::C_ZIG
-						&& globalData.targetProfile.standard == StandardType::S_INVALID)
+						&& data.targetProfile.standard == StandardType::S_INVALID)
 					{
-						LanguageCore::Compile_Zig(globalData);
+						LanguageCore::Compile_Zig(data);
 					}
-					else LanguageCore::Compile_C_CPP(globalData);
+					else LanguageCore::Compile_C_CPP(data);
 				}
 				else if (c == CompilerType::C_JAVA)
 				{
-					LanguageCore::Compile_Java(globalData);
+					LanguageCore::Compile_Java(data);
 				}
 				else if (c == CompilerType::C_PYTHON)
 				{
-					LanguageCore::Compile_Python(globalData);
+					if (data.checkOnly)
+					{
+						KalaMakeCore::CloseOnError(
+							"KALAMAKE",
+							"Command 'check' is not supported for Python!");
+					}
+
+					LanguageCore::Compile_Python(data);
 				}
 				else if (c == CompilerType::C_RUST)
 				{
-					LanguageCore::Compile_Rust(globalData);
+					LanguageCore::Compile_Rust(data);
+				}
+			};
+
+		auto compile_single_file = [&context]() -> void
+			{
+				CompilerType c = context.globalData.targetProfile.compiler;
+
+				if ((c == CompilerType::C_ZIG
+					&& context.globalData.targetProfile.standard != StandardType::S_INVALID)
+					|| c == CompilerType::C_CL
+					|| c == CompilerType::C_CLANG_CL
+					|| c == CompilerType::C_CLANG
+					|| c == CompilerType::C_CLANGPP
+					|| c == CompilerType::C_GCC
+					|| c == CompilerType::C_GPP)
+				{
+					LanguageCore::CompileFile_C_CPP(
+						context.globalData,
+						context.singleSource,
+						context.exportDiagnostics);
+				}
+				else
+				{
+					KalaMakeCore::CloseOnError(
+						"KALAMAKE",
+						"Command 'compile-file' is only supported for C and C++!");
 				}
 			};
 
@@ -715,280 +716,493 @@ namespace KalaMake::Core
 				return result;
 			};
 
-		auto handle_state = [first_parse, require_quotes, type](path filePath) -> void
+		//loads the resolved target profile from its snapshot or parses it again
+		auto resolve_profile = [&context, first_parse, type](
+			const path& filePath,
+			string_view content,
+			const ProjectIndex& index) -> void
 			{
-				if (is_directory(filePath))
+				u64 snapshotKey = Snapshot::GetKey(
+					content,
+					weakly_canonical(filePath),
+					context.targetProfile);
+				path snapshotPath = FindSnapshotPath(index);
+
+				if (!snapshotPath.empty()
+					&& Snapshot::Load(
+						snapshotPath,
+						snapshotKey,
+						context.globalData))
 				{
-					KalaMakeCore::CloseOnError(
+					Log::Print(
+						"Loaded resolved profile '" + context.globalData.targetProfile.profileName + "' from snapshot '" + snapshotPath.string() + "', "
+						"the kalamake file and its source directories have not changed.\n",
 						"KALAMAKE",
-						"Project path '" + filePath.string() + "' leads to a directory!");
+						LogType::LOG_SUCCESS);
+
+					return;
 				}
 
-				if (!filePath.has_extension()
-					|| filePath.extension() != ".kmake")
+				//listings of unchanged dirs are reused even when the snapshot is outdated
+				path dirCachePath{};
+				if (!snapshotPath.empty())
 				{
-					KalaMakeCore::CloseOnError(
-						"KALAMAKE",
-						"Project path '" + filePath.string() + "' has an incorrect extension!");
+					dirCachePath = DirCache::GetPath(snapshotPath.parent_path());
+					DirCache::Load(dirCachePath);
 				}
 
-				vector<string> content{};
+				first_parse(filePath, index, type);
 
-				string result = ReadLinesFromFile(
-					filePath,
-					content);
-
-				if (!result.empty())
+				if (!snapshotPath.empty())
 				{
-					KalaMakeCore::CloseOnError(
-						"KALAMAKE",
-						"Project '" + filePath.string() + "' is invalid! Reason: " + result);
+					string dirCacheResult = DirCache::Save(dirCachePath);
+					if (!dirCacheResult.empty())
+					{
+						Log::Print(
+							"Failed to save directory cache! Reason: " + dirCacheResult,
+							"KALAMAKE",
+							LogType::LOG_WARNING);
+					}
+
+					string snapshotResult = Snapshot::Save(
+						snapshotPath,
+						snapshotKey,
+						context.globalData,
+						vector<path>(context.traversedPaths.begin(), context.traversedPaths.end()));
+
+					if (!snapshotResult.empty())
+					{
+						Log::Print(
+							"Failed to save profile snapshot! Reason: " + snapshotResult,
+							"KALAMAKE",
+							LogType::LOG_WARNING);
+					}
 				}
+			};
+
+		//a linked project is parsed like the main one, from its own snapshot if it has one
+		auto resolve_project = [&context, resolve_profile](
+			const path& project,
+			const string& profile) -> GlobalData
+			{
+				CleanEverything();
 
-				if (content.empty())
+				context.projectFile = project;
+				context.targetProfile = profile;
+				context.kmaPath = project.parent_path();
+
+				MappedFile file{};
+
+				string result = file.Open(project);
+
+				if (!result.empty())
 				{
 					KalaMakeCore::CloseOnError(
 						"KALAMAKE",
-						"Project '" + filePath.string() + "' was empty!");
+						"Linked project '" + project.string() + "' is invalid! Reason: " + result);
 				}
 
-				kmaPath = filePath.parent_path();
-
-				auto clean_line = [](
-								string& line, 
-								string& name, 
-								string& value, 
-								CategoryType& type) -> void
-								{
-									if (line.empty()
-										|| line.starts_with("//")
-										|| !line.starts_with('#'))
-									{
-										return;
-									}
-
-									line = TrimString(ReplaceAfter(line, "//"));
+				Log::Print(
+					"Resolving linked project '" + project.string() + "' with profile '" + profile + "'.\n",
+					"KALAMAKE",
+					LogType::LOG_INFO);
 
-									ExtractCategoryData(
-										line, 
-										name,
-										value);
+				resolve_profile(
+					project,
+					file.GetView(),
+					Tokenize(file.GetView()));
 
-									if (!StringToEnum(name, categoryTypes, type)
-										|| type == CategoryType::C_INVALID)
-									{
-										KalaMakeCore::CloseOnError(
-											"KALAMAKE",
-											"Category type '" + name + "' is invalid!");
-									}
-								};
+				return std::move(context.globalData);
+			};
 
+		//every project reached through project links becomes one node,
+		//a project is only resolved once however many others link it
+		auto resolve_workspace = [resolve_project](vector<GlobalData>& roots) -> vector<WorkspaceNode>
+			{
+				vector<WorkspaceNode> nodes{};
+				vector<string> chain{};
 
-				switch (type)
-				{
-					default:
-					case StartType::S_INVALID:
-					{
-						KalaMakeCore::CloseOnError(
-							"KALAMAKE",
-							"Invalid start type was used!");
-					}
-					case StartType::S_COMPILE:
-					{
-						first_parse(filePath, content, type);
-						break;
-					}
-					case StartType::S_LIST_PROFILES:
+				function<size_t(GlobalData&)> link_projects{};
+				link_projects = [&nodes, &chain, &link_projects, resolve_project](GlobalData& data) -> size_t
 					{
-						Log::Print("Available profiles in '" + filePath.string() + "':");
-    					Log::Print("    global");
+						size_t level{};
 
-						for (const string& l : content)
+						for (auto& l : data.targetProfile.links)
 						{
-							string line = l;
-							string name{};
-							string value{};
+							path project{};
+							string profile{};
+							if (!SplitProjectLink(l, project, profile)) continue;
 
-							CategoryType type{};
-							clean_line(line, name, value, type);
+							string key = l.string();
 
-							if (type == CategoryType::C_PROFILE)
+							if (ContainsValue(chain, key))
 							{
-								Log::Print("    " + value);
+								KalaMakeCore::CloseOnError(
+									"KALAMAKE",
+									"Project link '" + key + "' links back to itself!");
 							}
 
-						}
-
-						 break;
-					}
-					case StartType::S_VALIDATE:
-					{
-						first_parse(filePath, content, type);
-						break;
-					}
-					case StartType::S_CLEAN:
-					{
-						vector<path> buildPaths{};
-						string_view bp = "buildpath: ";
-					
-							auto get_all_category_content = [&content](
-								string_view categoryName,
-								string_view categoryValue = {}) -> vector<string>
-								{
-									bool collecting{};
-									vector<string> collected{};
-
-									for (const string& li : content)
-									{
-										if (li.empty()
-											|| li.starts_with("//"))
-										{
-											continue;
-										}
-
-										string cli = TrimString(ReplaceAfter(li, "//"));
-										if (cli.empty()) continue;
+							auto it = find_if(
+								nodes.begin(),
+								nodes.end(),
+								[&key](const WorkspaceNode& n) { return n.key == key; });
 
-										if (!collecting)
-										{
-											if (categoryValue.empty())
-											{
-												if (cli == "#" + string(categoryName)) collecting = true;
-											}
-											else if (cli == "#" + string(categoryName) + " " + string(categoryValue)) collecting = true;
-											
-											continue;
-										}
+							size_t index = scast<size_t>(it - nodes.begin());
 
-										if (cli[0] == '#') break;
+							if (it == nodes.end())
+							{
+								chain.push_back(key);
 
-										collected.push_back(cli);
-									}
+								GlobalData linked = resolve_project(project, profile);
+								size_t linkedLevel = link_projects(linked);
 
-									return collected;
-								};
+								chain.pop_back();
 
-						for (const string& l : content)
-						{
-							string line = l;
-							string name{};
-							string value{};
+								CompilerType c = linked.targetProfile.compiler;
 
-							CategoryType type{};
-							clean_line(line, name, value, type);
+								if ((c != CompilerType::C_CL
+									&& c != CompilerType::C_CLANG_CL
+									&& c != CompilerType::C_CLANG
+									&& c != CompilerType::C_CLANGPP
+									&& c != CompilerType::C_GCC
+									&& c != CompilerType::C_GPP
+									&& (c != CompilerType::C_ZIG
+									|| linked.targetProfile.standard == StandardType::S_INVALID))
+									|| linked.targetProfile.binaryType == BinaryType::B_EXECUTABLE)
+								{
+									KalaMakeCore::CloseOnError(
+										"KALAMAKE",
+										"Project link '" + key + "' must lead to a C or C++ static or shared library!");
+								}
 
-							if (type == CategoryType::C_REFERENCES)
-							{
-								vector<string> content = get_all_category_content(name);
+								path output = LanguageCore::GetOutput_C_CPP(linked);
 
-								unordered_map<string, path> fields{};
-								for (const auto& c : content)
-								{
-									string fieldName{};
-									vector<string> fieldValues{};
-									ExtractFieldData(
-										c, 
-										fieldName, 
-										fieldValues,
-										true);
-
-									if (fields.contains(fieldName))
+								nodes.push_back(
 									{
-										KalaMakeCore::CloseOnError(
-											"KALAMAKE",
-											"Reference field '" + fieldName + "' was duplicated!");
-									}
+										.key = key,
+										.data = std::move(linked),
+										.output = output,
+										.level = linkedLevel
+									});
+							}
 
-									fields[fieldName] = fieldValues[0];
-								}
+							l = nodes[index].output;
+							level = max(level, nodes[index].level + 1);
+						}
 
-								globalData.references.reserve(globalData.references.size() + fields.size());
+						return level;
+					};
 
-								for (const auto& [k, v] : fields)
-								{
-									ReferenceData ref
-									{
-										.name = k,
-										.value = v.string()
-									};
+				for (auto& r : roots) link_projects(r);
 
-									globalData.references.push_back(ref);	
-								}
+				return nodes;
+			};
 
-								foundReferences = true;
+		//linked projects compile level by level before the roots, every level at once,
+		//and all compiler and linker processes share one job pool
+		auto compile_workspace = [&context, compile_project, type](
+			vector<WorkspaceNode>& nodes,
+			vector<GlobalData>& roots) -> void
+			{
+				//linked projects are not needed when only checking the roots
+				if (type == StartType::S_CHECK) nodes.clear();
 
-								break;
-							}
-						}
+				if (nodes.empty()
+					&& roots.size() == 1)
+				{
+					compile_project(roots[0]);
+					return;
+				}
 
-						for (const string& l : content)
-						{
-							if (l.empty()
-								|| l.starts_with("//"))
-							{
-								continue;
-							}
+				u16 capacity{};
+				size_t lastLevel{};
 
-							string line = TrimString(ReplaceAfter(l, "//"));
-							if (line.empty()) continue;
+				for (const auto& n : nodes)
+				{
+					capacity = max(capacity, n.data.targetProfile.jobs);
+					lastLevel = max(lastLevel, n.level);
+				}
+				for (const auto& r : roots) capacity = max(capacity, r.targetProfile.jobs);
 
-							if (line[0] == '#') continue;
+				if (capacity == 0) capacity = JobPool::GetDefaultJobCount();
 
-							if (!line.starts_with("buildpath: ")) continue;
+				Log::Print(
+					"Compiling '" + to_string(roots.size()) + "' profiles and '" + to_string(nodes.size()) + "' linked projects with '" + to_string(capacity) + "' shared jobs.\n",
+					"KALAMAKE",
+					LogType::LOG_INFO);
 
-							if (line.find(',') != string::npos)
-							{
-								KalaMakeCore::CloseOnError(
-									"KALAMAKE",
-									"Build path '" + line  + "' is not allowed to have more than one path!");
-							}
-							if (line.find('*') != string::npos)
-							{
-								KalaMakeCore::CloseOnError(
-									"KALAMAKE",
-									"Build path '" + line + "' is not allowed to use wildcards!");
-							}
+				JobPool::SetCapacity(capacity);
 
-							line.erase(0, bp.size());
+				exception_ptr firstError{};
+				mutex m_firstError{};
 
-							if (line.starts_with('"'))
+				auto compile_together = [&context, &firstError, &m_firstError](const vector<function<void()>>& jobs) -> void
+					{
+						vector<thread> jobThreads{};
+						for (const auto& j : jobs)
+						{
+							jobThreads.emplace_back([
+								&context,
+								&j,
+								&firstError,
+								&m_firstError]
+								{
+									SessionContext::Scope scope(context);
+
+									try
+									{
+										j();
+									}
+									catch (...)
+									{
+										lock_guard<mutex> lock(m_firstError);
+										if (!firstError) firstError = current_exception();
+									}
+								});
+						}
+
+						for (auto& t : jobThreads) t.join();
+					};
+
+				for (size_t level = 0; level <= lastLevel && !nodes.empty(); ++level)
+				{
+					vector<function<void()>> jobs{};
+					for (auto& n : nodes)
+					{
+						if (n.level == level) jobs.emplace_back([&n, compile_project] { compile_project(n.data); });
+					}
+
+					compile_together(jobs);
+
+					if (firstError) break;
+				}
+
+				if (!firstError)
+				{
+					vector<function<void()>> jobs{};
+					for (auto& r : roots) jobs.emplace_back([&r, compile_project] { compile_project(r); });
+
+					compile_together(jobs);
+				}
+
+				JobPool::SetCapacity(0);
+
+				if (firstError) rethrow_exception(firstError);
+
+				Log::Print(
+					"Finished compiling '" + to_string(roots.size()) + "' profiles and '" + to_string(nodes.size()) + "' linked projects!",
+					"KALAMAKE",
+					LogType::LOG_SUCCESS);
+			};
+
+		auto handle_state = [
+			&context,
+			first_parse,
+			resolve_profile,
+			resolve_workspace,
+			compile_workspace,
+			compile_single_file,
+			require_quotes,
+			type](path filePath) -> void
+			{
+				if (is_directory(filePath))
+				{
+					KalaMakeCore::CloseOnError(
+						"KALAMAKE",
+						"Project path '" + filePath.string() + "' leads to a directory!");
+				}
+
+				if (!filePath.has_extension()
+					|| filePath.extension() != ".kmake")
+				{
+					KalaMakeCore::CloseOnError(
+						"KALAMAKE",
+						"Project path '" + filePath.string() + "' has an incorrect extension!");
+				}
+
+				//the index holds views into the mapping,
+				//so it has to outlive every parse stage below
+				MappedFile file{};
+
+				string result = file.Open(filePath);
+
+				if (!result.empty())
+				{
+					KalaMakeCore::CloseOnError(
+						"KALAMAKE",
+						"Project '" + filePath.string() + "' is invalid! Reason: " + result);
+				}
+
+				string_view content = file.GetView();
+
+				if (TrimView(content).empty())
+				{
+					KalaMakeCore::CloseOnError(
+						"KALAMAKE",
+						"Project '" + filePath.string() + "' was empty!");
+				}
+
+				context.kmaPath = filePath.parent_path();
+
+				ProjectIndex index = Tokenize(content);
+
+				switch (type)
+				{
+					default:
+					case StartType::S_INVALID:
+					{
+						KalaMakeCore::CloseOnError(
+							"KALAMAKE",
+							"Invalid start type was used!");
+					}
+					case StartType::S_COMPILE:
+					case StartType::S_COMPILE_FILE:
+					case StartType::S_CHECK:
+					{
+						vector<string> profiles = context.targetProfiles;
+
+						if (profiles.size() == 1
+							&& profiles[0] == all_profiles_param)
+						{
+							profiles.clear();
+
+							for (const auto& c : index.categories)
+							{
+								if (c.type == CategoryType::C_PROFILE) profiles.emplace_back(c.value);
+							}
+
+							if (profiles.empty())
+							{
+								KalaMakeCore::CloseOnError(
+									"KALAMAKE",
+									"Project '" + filePath.string() + "' has no user profiles to compile!");
+							}
+						}
+
+						//every profile is resolved before linked projects replace the parse state
+						vector<GlobalData> roots{};
+						roots.reserve(profiles.size());
+
+						for (const auto& p : profiles)
+						{
+							CleanEverything();
+							context.targetProfile = p;
+
+							resolve_profile(filePath, content, index);
+
+							roots.push_back(std::move(context.globalData));
+						}
+
+						//a single source is compiled without linking, so linked projects are never loaded
+						if (type == StartType::S_COMPILE_FILE)
+						{
+							context.globalData = std::move(roots[0]);
+							compile_single_file();
+							break;
+						}
+
+						vector<WorkspaceNode> nodes = resolve_workspace(roots);
+
+						compile_workspace(nodes, roots);
+
+						context.globalData = std::move(roots[0]);
+						break;
+					}
+					case StartType::S_LIST_PROFILES:
+					{
+						Log::Print("Available profiles in '" + filePath.string() + "':");
+    					Log::Print("    global");
+
+						for (const auto& c : index.categories)
+						{
+							if (c.type == CategoryType::C_PROFILE)
+							{
+								Log::Print("    " + string(c.value));
+							}
+						}
+
+						 break;
+					}
+					case StartType::S_VALIDATE:
+					{
+						first_parse(filePath, index, type);
+						break;
+					}
+					case StartType::S_CLEAN:
+					{
+						vector<path> buildPaths{};
+						string_view bp = "buildpath: ";
+
+						if (index.referencesIndex != ProjectIndex::npos)
+						{
+							LoadReferences(index.categories[index.referencesIndex]);
+						}
+
+						for (const auto& c : index.categories)
+						{
+							for (string_view l : c.fields)
 							{
-								if (!line.ends_with('"'))
+								if (!l.starts_with(bp)) continue;
+
+								string line(l);
+
+								if (line.find(',') != string::npos)
+								{
+									KalaMakeCore::CloseOnError(
+										"KALAMAKE",
+										"Build path '" + line  + "' is not allowed to have more than one path!");
+								}
+								if (line.find('*') != string::npos)
 								{
 									KalaMakeCore::CloseOnError(
 										"KALAMAKE",
-										"Build path '" + line + "' must end with quotes!");
+										"Build path '" + line + "' is not allowed to use wildcards!");
 								}
 
-								line = TranslateReferences(require_quotes(line));
+								line.erase(0, bp.size());
 
-								vector<path> resolvedPaths{};
-								if (!exists(line)) continue;
-								else
+								if (line.starts_with('"'))
 								{
-									string errorMsg = ResolveAnyPath(
-										line, 
-										kmaPath.string(), 
-										resolvedPaths);
-
-									if (!errorMsg.empty())
+									if (!line.ends_with('"'))
 									{
 										KalaMakeCore::CloseOnError(
 											"KALAMAKE",
-											"Build path '" + line + "' could not be resolved! Reason: " + errorMsg);
+											"Build path '" + line + "' must end with quotes!");
 									}
-								}
 
-								vector<string> result{};
-								ToStringVector(resolvedPaths, result);
+									line = TranslateReferences(require_quotes(line));
 
-								buildPaths.push_back(result[0]);
-							}
-							else
-							{
-								KalaMakeCore::CloseOnError(
-									"KALAMAKE",
-									"Build path '" + l + "' has an illegal structure!");
+									path buildPath = line;
+									if (buildPath.is_relative()) buildPath = context.kmaPath / buildPath;
+
+									vector<path> resolvedPaths{};
+									if (!exists(buildPath)) continue;
+									else
+									{
+										string errorMsg = ResolveAnyPath(
+											line, 
+											context.kmaPath.string(), 
+											resolvedPaths);
+
+										if (!errorMsg.empty())
+										{
+											KalaMakeCore::CloseOnError(
+												"KALAMAKE",
+												"Build path '" + line + "' could not be resolved! Reason: " + errorMsg);
+										}
+									}
+
+									vector<string> result{};
+									ToStringVector(resolvedPaths, result);
+
+									buildPaths.push_back(result[0]);
+								}
+								else
+								{
+									KalaMakeCore::CloseOnError(
+										"KALAMAKE",
+										"Build path '" + string(l) + "' has an illegal structure!");
+								}
 							}
 						}
 
@@ -1020,13 +1234,13 @@ namespace KalaMake::Core
 
 		try
 		{
-			correctTarget = weakly_canonical(path(KalaCLI::Core::GetCurrentDir()) / projectFile);
+			correctTarget = weakly_canonical(currentDir / context.projectFile);
 		}
 		catch (const filesystem_error&)
 		{
 			KalaMakeCore::CloseOnError(
 				"KALAMAKE",
-				"Project partial path via '" + projectFile.string() + "' could not be resolved!");
+				"Project partial path via '" + context.projectFile.string() + "' could not be resolved!");
 		}
 
 		if (exists(correctTarget))
@@ -1040,13 +1254,13 @@ namespace KalaMake::Core
 
 		try
 		{
-			correctTarget = weakly_canonical(projectFile);
+			correctTarget = weakly_canonical(context.projectFile);
 		}
 		catch (const filesystem_error&)
 		{
 			KalaMakeCore::CloseOnError(
 				"KALAMAKE",
-				"Project full path '" + projectFile.string() + "' could not be resolved!");
+				"Project full path '" + context.projectFile.string() + "' could not be resolved!");
 		}
 
 		if (exists(correctTarget))
@@ -1058,21 +1272,53 @@ namespace KalaMake::Core
 
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
-			"Project path '" + projectFile.string() + "' does not exist!");
+			"Project path '" + context.projectFile.string() + "' does not exist!");
 	}
 
 	const unordered_map<Version,      string_view, EnumHash<Version>>&      KalaMakeCore::GetVersions()      { return versions; }
 	const unordered_map<CategoryType, string_view, EnumHash<CategoryType>>& KalaMakeCore::GetCategoryTypes() { return categoryTypes; }
-	const unordered_map<FieldType,    string_view, EnumHash<FieldType>>&    KalaMakeCore::GetFieldTypes()    { return fieldTypes; }
 
-	const unordered_map<BinaryType,           string_view, EnumHash<BinaryType>>&           KalaMakeCore::GetBinaryTypes()           { return binaryTypes; }
-	const unordered_map<CompilerLauncherType, string_view, EnumHash<CompilerLauncherType>>& KalaMakeCore::GetCompilerLauncherTypes() { return compilerLauncherTypes; }
-	const unordered_map<CompilerType,         string_view, EnumHash<CompilerType>>&         KalaMakeCore::GetCompilerTypes()         { return compilerTypes; }
-	const unordered_map<StandardType,         string_view, EnumHash<StandardType>>&         KalaMakeCore::GetStandardTypes()         { return standardTypes; }
-	const unordered_map<TargetType,           string_view, EnumHash<TargetType>>&           KalaMakeCore::GetTargetTypes()           { return targetTypes; }
-	const unordered_map<BuildType,            string_view, EnumHash<BuildType>>&            KalaMakeCore::GetBuildTypes()            { return buildTypes; }
-	const unordered_map<WarningLevel,         string_view, EnumHash<WarningLevel>>&         KalaMakeCore::GetWarningLevels()         { return warningLevels; }
-	const unordered_map<CustomFlag,           string_view, EnumHash<CustomFlag>>&           KalaMakeCore::GetCustomFlags()           { return customFlags; }
+	void Parse::SetTarget(
+		const path& kmaRoot,
+		string_view profile)
+	{
+		SessionContext& context = SessionContext::Current();
+
+		context.kmaPath = kmaRoot;
+		context.targetProfile = string(profile);
+	}
+
+	void Parse::ExtractCategoryData(
+		string_view line,
+		string_view& outCategoryName,
+		string_view& outCategoryValue)
+	{
+		::ExtractCategoryData(
+			line,
+			outCategoryName,
+			outCategoryValue);
+	}
+
+	void Parse::ExtractFieldData(
+		string_view line,
+		string& outFieldName,
+		vector<string>& outFieldValues,
+		bool isReference)
+	{
+		::ExtractFieldData(
+			line,
+			outFieldName,
+			outFieldValues,
+			isReference);
+	}
+
+	ProjectIndex Parse::Tokenize(string_view content) { return ::Tokenize(content); }
+
+	void Parse::FirstParse(const ProjectIndex& index) { ::FirstParse(index); }
+
+	string Parse::TranslateReferences(string_view value) { return ::TranslateReferences(value); }
+
+	const GlobalData& Parse::GetParsedData() { return SessionContext::Current().globalData; }
 
     void KalaMakeCore::CloseOnError(
 		string_view target,
@@ -1084,34 +1330,35 @@ namespace KalaMake::Core
 			LogType::LOG_ERROR,
 			2);
 
-		exit(1);
+		throw KalaMakeError(target, message);
 	}
 }
 
 void ExtractFieldData(
-	const string& line,
+	string_view line,
 	string& outFieldName,
 	vector<string>& outFieldValues,
 	bool isReference)
 {
-	if (line.find(": ") == string::npos)
+	SessionContext& context = SessionContext::Current();
+
+	size_t separatorPos = line.find(": ");
+	if (separatorPos == string_view::npos)
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
-			"Failed to resolve field '" + line + "' because it is missing its name and value separator!");
+			"Failed to resolve field '" + string(line) + "' because it is missing its name and value separator!");
 	}
 
-	vector<string> split = SplitString(line, ": ");
-
-	if (split.size() > 2)
+	if (line.find(": ", separatorPos + 2) != string_view::npos)
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
-			"Failed to resolve field '" + line + "' because it has more than one name and value separator!");
+			"Failed to resolve field '" + string(line) + "' because it has more than one name and value separator!");
 	}
 
-	string name = split[0];
-	string trimmedValue = TrimString(split[1]);
+	string name(line.substr(0, separatorPos));
+	string trimmedValue(TrimView(line.substr(separatorPos + 2)));
 
 	if (ContainsSpace(name))
 	{
@@ -1126,20 +1373,17 @@ void ExtractFieldData(
 			"Field name '" + name + "' must only contain 'A-Z', 'a-z', '0-9', '_', '-' or '.'!");
 	}
 
-	FieldType t{};
-	bool searchSuccess = StringToEnum(name, KalaMakeCore::GetFieldTypes(), t);
+	const FieldSchema* schema = Schema::FindField(name);
 
 	if (!isReference
-		&& (!searchSuccess
-		|| t == FieldType::T_INVALID))
+		&& !schema)
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
 			"Field '" + name  + "' is invalid!");
 	}
 	else if (isReference
-			 && searchSuccess
-			 && t != FieldType::T_INVALID)
+			 && schema)
 	{
 		KalaMakeCore::CloseOnError(
 			"KALAMAKE",
@@ -1182,7 +1426,20 @@ void ExtractFieldData(
 	// PARSE FIELD
 	//
 
-	if (name == field_build_path)
+	//any field in references category
+	if (isReference)
+	{
+		if (trimmedValue.empty())
+		{
+			KalaMakeCore::CloseOnError(
+				"KALAMAKE",
+				"Reference '" + name + "' must have a value!");
+		}
+
+		outFieldName = name;
+		outFieldValues = { trimmedValue };
+	}
+	else if (schema->kind == ValueKind::V_BUILD_PATH)
 	{
 		if (trimmedValue.empty())
 		{
@@ -1215,10 +1472,14 @@ void ExtractFieldData(
 
 			trimmedValue = TranslateReferences(require_quotes(trimmedValue));
 
+			//relative to the kmake file, linked projects are resolved from another working directory
+			path buildPath = trimmedValue;
+			if (buildPath.is_relative()) buildPath = context.kmaPath / buildPath;
+
 			vector<path> resolvedPaths{};
-			if (!exists(trimmedValue))
+			if (!exists(buildPath))
 			{
-				string errorMsg = CreateNewDirectory(trimmedValue);
+				string errorMsg = CreateNewDirectory(buildPath);
 							
 				if (!errorMsg.empty())
 				{
@@ -1227,13 +1488,13 @@ void ExtractFieldData(
 						"Build path '" + trimmedValue + "' could not be created! Reason: " + errorMsg);
 				}
 
-				resolvedPaths = { trimmedValue };
+				resolvedPaths = { weakly_canonical(buildPath) };
 			}
 			else
 			{
 				string errorMsg = ResolveAnyPath(
 					trimmedValue, 
-					kmaPath.string(), 
+					context.kmaPath.string(), 
 					resolvedPaths);
 
 				if (!errorMsg.empty())
@@ -1258,8 +1519,7 @@ void ExtractFieldData(
 				"Build path '" + trimmedValue + "' has an illegal structure!");
 		}
 	}
-	else if (name == field_sources
-			 || name == field_headers)
+	else if (schema->kind == ValueKind::V_PATH_LIST)
 	{
 		//early exit for empty value
 		if (trimmedValue.empty())
@@ -1269,17 +1529,12 @@ void ExtractFieldData(
 		}
 
 		string ref = TranslateReferences(trimmedValue);
-		vector<string> split{};
-
-		if (ref.find(", ") != string::npos) split = SplitString(ref, ", ");
-		else split = SplitString(ref, ",");
+		vector<string> split = SplitFieldValues(ref);
 
 		vector<string> result{};
 
-		for (const string& l : split)
+		for (const string& trimmedLine : split)
 		{
-			string trimmedLine = TrimString(l);
-
 			if (trimmedLine.starts_with('"'))
 			{
 				if (!trimmedLine.ends_with('"'))
@@ -1291,14 +1546,31 @@ void ExtractFieldData(
 
 				string cleanedValue = require_quotes(trimmedLine);
 
+				//exclusions were already collected before any field was resolved
+				if (schema->type == FieldType::T_SOURCES
+					&& cleanedValue.starts_with('!'))
+				{
+					continue;
+				}
+
 				vector<string> resolvedStringPaths{};
 				vector<path> resolvedPaths{};
+				vector<path> visitedPaths{};
 
-				if (name == field_sources)
+				if (Glob::HasWildcards(cleanedValue))
+				{
+					Glob::Resolve(
+						ToGenericPattern(cleanedValue),
+						schema->type == FieldType::T_SOURCES ? GlobTarget::G_FILES : GlobTarget::G_DIRS,
+						schema->type == FieldType::T_SOURCES ? context.sourceExclusions : noExclusions,
+						resolvedPaths,
+						&visitedPaths);
+				}
+				else if (schema->type == FieldType::T_SOURCES)
 				{
 					string errorMsg = ResolveAnyPath(
 						cleanedValue, 
-						kmaPath.string(), 
+						context.kmaPath.string(), 
 						resolvedPaths,
 						PathTarget::P_FILE_ONLY);
 
@@ -1313,7 +1585,7 @@ void ExtractFieldData(
 				{
 					string errorMsg = ResolveAnyPath(
 						cleanedValue, 
-						kmaPath.string(), 
+						context.kmaPath.string(), 
 						resolvedPaths);
 
 					if (!errorMsg.empty())
@@ -1334,33 +1606,24 @@ void ExtractFieldData(
 					}
 				}
 
-				if (name == field_sources)
+				if (schema->type == FieldType::T_SOURCES)
 				{
-					auto dir_to_scripts = [](const path& dir) -> vector<path>
-						{
-							vector<path> out{};
-
-							for (const auto& f : recursive_directory_iterator(dir))
-							{
-								if (is_regular_file(f)) out.push_back(f);
-							}
-
-							return out;
-						};
-
 					vector<path> sourceFiles{};
 
 					for (const auto& p : resolvedPaths)
 					{
 						if (is_directory(p))
 						{
-							vector<path> localSrc = dir_to_scripts(p);
-							sourceFiles.insert(
-								sourceFiles.end(),
-								make_move_iterator(localSrc.begin()),
-								make_move_iterator(localSrc.end()));
+							Glob::WalkFiles(
+								p,
+								context.sourceExclusions,
+								sourceFiles,
+								&visitedPaths);
+						}
+						else if (!context.sourceExclusions.MatchesAnyParent(ToGenericPattern(p.string())))
+						{
+							result.push_back(p.string());
 						}
-						else result.push_back(p.string());
 					}
 
 					vector<string> stringSourceFiles{};
@@ -1380,6 +1643,10 @@ void ExtractFieldData(
 						make_move_iterator(resolvedStringPaths.begin()),
 						make_move_iterator(resolvedStringPaths.end()));
 				}
+
+				RecordTraversal(
+					visitedPaths,
+					resolvedPaths);
 			}
 			else
 			{
@@ -1394,7 +1661,7 @@ void ExtractFieldData(
 		outFieldName = name;
 		outFieldValues = result;
 	}
-	else if (name == field_links)
+	else if (schema->kind == ValueKind::V_LINK_LIST)
 	{
 		//early exit for empty value
 		if (trimmedValue.empty())
@@ -1404,14 +1671,11 @@ void ExtractFieldData(
 		}
 
 		string ref = TranslateReferences(trimmedValue);
-		vector<string> split{};
-
-		if (ref.find(", ") != string::npos) split = SplitString(ref, ", ");
-		else split = SplitString(ref, ",");
+		vector<string> split = SplitFieldValues(ref);
 
 		vector<string> result{};
 
-		auto resolve_line = [require_quotes](string& trimmedLine) -> vector<string>
+		auto resolve_line = [&context, require_quotes](string& trimmedLine) -> vector<string>
 			{
 				if (trimmedLine.starts_with('"'))
 				{
@@ -1426,20 +1690,69 @@ void ExtractFieldData(
 
 					vector<string> resolvedStringPaths{};
 					vector<path> resolvedPaths{};
+					vector<path> visitedPaths{};
 
-					string errorMsg = ResolveAnyPath(
-							trimmedLine, 
-							kmaPath.string(), 
-							resolvedPaths,
-							PathTarget::P_FILE_ONLY);
+					//the project is only resolved here, its output replaces this link
+					//once the project itself is resolved before compiling
+					size_t projectEnd = trimmedLine.find(project_link_marker);
+					if (projectEnd != string::npos)
+					{
+						string projectPart = trimmedLine.substr(0, projectEnd + project_link_marker.size() - 1);
+						string profilePart = trimmedLine.substr(projectEnd + project_link_marker.size());
 
-					if (!errorMsg.empty())
+						if (profilePart.empty()
+							|| ContainsSpace(profilePart))
+						{
+							KalaMakeCore::CloseOnError(
+								"KALAMAKE",
+								"Project link '" + trimmedLine + "' has an invalid profile name!");
+						}
+
+						string errorMsg = ResolveAnyPath(
+								projectPart, 
+								context.kmaPath.string(), 
+								resolvedPaths,
+								PathTarget::P_FILE_ONLY);
+
+						if (!errorMsg.empty())
+						{
+							KalaMakeCore::CloseOnError(
+								"KALAMAKE",
+								"Project link '" + trimmedLine + "' could not be resolved! Reason: " + errorMsg);
+						}
+
+						return { weakly_canonical(resolvedPaths[0]).string() + ":" + profilePart };
+					}
+
+					if (Glob::HasWildcards(trimmedLine))
 					{
-						KalaMakeCore::CloseOnError(
-							"KALAMAKE",
-							"Link path '" + trimmedLine + "' could not be resolved! Reason: " + errorMsg);
+						Glob::Resolve(
+							ToGenericPattern(trimmedLine),
+							GlobTarget::G_FILES,
+							noExclusions,
+							resolvedPaths,
+							&visitedPaths);
+					}
+					else
+					{
+						string errorMsg = ResolveAnyPath(
+								trimmedLine, 
+								context.kmaPath.string(), 
+								resolvedPaths,
+								PathTarget::P_FILE_ONLY);
+
+						if (!errorMsg.empty())
+						{
+							KalaMakeCore::CloseOnError(
+								"KALAMAKE",
+								"Link path '" + trimmedLine + "' could not be resolved! Reason: " + errorMsg);
+						}
 					}
 
+					RecordTraversal(
+						visitedPaths,
+						resolvedPaths);
+
 					ToStringVector(resolvedPaths, resolvedStringPaths);
 
 					return resolvedStringPaths;
@@ -1461,10 +1774,8 @@ void ExtractFieldData(
 				return {};
 			};
 
-		for (const string& l : split)
+		for (string& trimmedLine : split)
 		{
-			string trimmedLine = TrimString(l);
-
 			vector<string> cleanedStrings = resolve_line(trimmedLine);
 
 			result.insert(
@@ -1478,49 +1789,41 @@ void ExtractFieldData(
 		outFieldName = name;
 		outFieldValues = result;
 	}
-	//any field in references category
-	else if (isReference)
+	else if (schema->kind == ValueKind::V_ACTION)
 	{
-		if (trimmedValue.empty())
+		if (trimmedValue.find(',') != string::npos)
 		{
 			KalaMakeCore::CloseOnError(
 				"KALAMAKE",
-				"Reference '" + name + "' must have a value!");
+				"Build action '" + name  + "' is not allowed to have more than one value!");
 		}
 
-		outFieldName = name;
-		outFieldValues = { trimmedValue };
-	}
-	else if (name == field_pre_build_action)
-	{
-		if (trimmedValue.find(',') != string::npos)
+		string action = TranslateReferences(trimmedValue);
+
+		BuildAction parsedAction{};
+		string errorMsg = Action::Parse(action, parsedAction);
+
+		if (!errorMsg.empty())
 		{
 			KalaMakeCore::CloseOnError(
 				"KALAMAKE",
-				"Pre build action '" + name  + "' is not allowed to have more than one value!");
+				"Build action '" + action + "' is invalid! Reason: " + errorMsg);
 		}
-
-		outFieldName = name;
-		outFieldValues = { TranslateReferences(trimmedValue) };
-	}
-	else if (name == field_post_build_action)
-	{
-		if (trimmedValue.find(',') != string::npos)
+		if (parsedAction.onRelink
+			&& schema->type == FieldType::T_PRE_BUILD_ACTION)
 		{
 			KalaMakeCore::CloseOnError(
 				"KALAMAKE",
-				"Post build action '" + name  + "' is not allowed to have more than one value!");
+				"Pre build action '" + action + "' cannot use 'relink', nothing is linked before it runs!");
 		}
 
 		outFieldName = name;
-		outFieldValues = { TranslateReferences(trimmedValue) };
+		outFieldValues = { action };
 	}
 	//all other standard fields with no paths
 	else 
 	{
-		if (name != field_defines
-			&& name != field_compile_flags
-			&& name != field_link_flags
+		if (schema->kind != ValueKind::V_TEXT_LIST
 			&& trimmedValue.find('"') != string::npos)
 		{
 			KalaMakeCore::CloseOnError(
@@ -1534,11 +1837,7 @@ void ExtractFieldData(
 				"Field '" + name + "' is not allowed to use wildcards!");
 		}
 
-		//these fields must have a value
-		if ((name == field_binary_type
-			|| name == field_build_type
-			|| name == field_compiler
-			|| name == field_standard)
+		if (schema->needsValue
 			&& trimmedValue.empty())
 		{
 			KalaMakeCore::CloseOnError(
@@ -1546,13 +1845,7 @@ void ExtractFieldData(
 				"Field '" + name + "' must have a value!");
 		}
 
-		if ((name == field_binary_type
-			|| name == field_compiler_launcher
-			|| name == field_compiler
-			|| name == field_standard
-			|| name == field_target_type
-			|| name == field_binary_name
-			|| name == field_warning_level)
+		if (!schema->isMultiValue
 			&& trimmedValue.find(",") != string::npos)
 		{
 			KalaMakeCore::CloseOnError(
@@ -1562,7 +1855,7 @@ void ExtractFieldData(
 
 		string cleanValue = TranslateReferences(trimmedValue);
 
-		if (name == field_jobs
+		if (schema->kind == ValueKind::V_NUMBER
 			&& !cleanValue.empty())
 		{
 			unsigned long parsed{};
@@ -1602,124 +1895,45 @@ void ExtractFieldData(
 			}
 		}
 
-		if (name == field_binary_type)
+		vector<string> result{};
+		if (cleanValue.find(", ") != string::npos)
 		{
-			const auto& binaryTypes = KalaMakeCore::GetBinaryTypes();
-
-			BinaryType binaryType{};
-			if (!StringToEnum(cleanValue, binaryTypes, binaryType)
-				|| binaryType == BinaryType::B_INVALID)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Binary type '" + trimmedValue + "' is invalid!");
-			}
+			result = SplitString(cleanValue, ", ");
 		}
-		if (name == field_compiler_launcher)
+		else if (cleanValue.find(",") != string::npos)
 		{
-			const auto& compilerLauncherTypes = KalaMakeCore::GetCompilerLauncherTypes();
-
-			CompilerLauncherType compilerLauncherType{};
-			if (!StringToEnum(cleanValue, compilerLauncherTypes, compilerLauncherType)
-				|| compilerLauncherType == CompilerLauncherType::C_INVALID)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Compiler launcher type '" + trimmedValue + "' is invalid!");
-			}
-		}
-		if (name == field_compiler)
-		{
-			const auto& compilerTypes = KalaMakeCore::GetCompilerTypes();
-
-			CompilerType compilerType{};
-			if (!StringToEnum(cleanValue, compilerTypes, compilerType)
-				|| compilerType == CompilerType::C_INVALID)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Compiler type '" + trimmedValue + "' is invalid!");
-			}
+			result = SplitString(cleanValue, ",");
 		}
-		if (name == field_standard)
-		{
-			const auto& standardTypes = KalaMakeCore::GetStandardTypes();
+		else result.push_back(cleanValue);
 
-			StandardType standardType{};
-			if (!StringToEnum(cleanValue, standardTypes, standardType)
-				|| standardType == StandardType::S_INVALID)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Standard type '" + trimmedValue + "' is invalid!");
-			}
-		}
-		if (name == field_target_type)
-		{
-			const auto& targetTypes = KalaMakeCore::GetTargetTypes();
+		RemoveDuplicates(result);
 
-			TargetType targetType{};
-			if (!StringToEnum(cleanValue, targetTypes, targetType)
-				|| targetType == TargetType::T_INVALID)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Target type '" + trimmedValue + "' is invalid!");
-			}
-		}
-		if (name == field_build_type)
+		if (schema->kind == ValueKind::V_ENUM)
 		{
-			const auto& buildTypes = KalaMakeCore::GetBuildTypes();
-
-			BuildType buildType{};
-			if (!StringToEnum(cleanValue, buildTypes, buildType)
-				|| buildType == BuildType::B_INVALID)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Build type '" + trimmedValue + "' is invalid!");
-			}
-		}
-		if (name == field_warning_level)
-		{
-			const auto& warningLevels = KalaMakeCore::GetWarningLevels();
-
-			WarningLevel warningLevel{};
-			if (!StringToEnum(cleanValue, warningLevels, warningLevel)
-				|| warningLevel == WarningLevel::W_INVALID)
+			for (const auto& r : result)
 			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Warning level '" + trimmedValue + "' is invalid!");
+				if (!FindValue(schema->values, r))
+				{
+					KalaMakeCore::CloseOnError(
+						"KALAMAKE",
+						"Value '" + r + "' of field '" + name + "' is invalid, valid values are " + ListValues(schema->values) + "!");
+				}
 			}
 		}
-
-		vector<string> result{};
-		if (cleanValue.find(", ") != string::npos)
-		{
-			result = SplitString(cleanValue, ", ");
-		}
-		else if (cleanValue.find(",") != string::npos)
-		{
-			result = SplitString(cleanValue, ",");
-		}
-		else result.push_back(cleanValue);
-
-		RemoveDuplicates(result);
-
-		if (name == field_custom_flags)
+		if (schema->kind == ValueKind::V_TARGET_LIST)
 		{
-			const auto& customFlags = KalaMakeCore::GetCustomFlags();
-
 			for (const auto& r : result)
 			{
-				CustomFlag customFlag{};
-				if (!StringToEnum(r, customFlags, customFlag)
-					|| customFlag == CustomFlag::F_INVALID)
+				size_t split = r.find(':');
+
+				if (split == string::npos
+					|| split + 1 == r.size()
+					|| !FindValue(schema->values, string_view(r).substr(0, split))
+					|| ContainsUnsafeFileChar(r.substr(split + 1)))
 				{
 					KalaMakeCore::CloseOnError(
 						"KALAMAKE",
-						"Custom flag '" + trimmedValue + "' is invalid!");
+						"Target '" + r + "' is invalid, targets must be written as 'binarytype:binaryname'!");
 				}
 			}
 		}
@@ -1753,102 +1967,87 @@ void ExtractFieldData(
 	}
 }
 
-void FirstParse(const vector<string>& lines)
+ProjectIndex Tokenize(string_view content)
 {
-	//always a fresh build
-	CleanEverything();
+	ProjectIndex index{};
+	CategoryRecord* current{};
 
-	//look for any user profiles before continuing
-	for (const string& l : lines)
+	//every line and value is a view into content,
+	//nothing is copied until fields are resolved
+	size_t lineStart = 0;
+	while (lineStart < content.size())
 	{
-		if (l.starts_with("#profile "))
-		{
-			foundAnyUserProfile = true;
-			break;
-		}
-		
-	}
-	
-	auto get_all_category_content = [&lines](
-		string_view categoryName,
-		string_view categoryValue = {}) -> vector<string>
-		{
-			bool collecting{};
-			vector<string> collected{};
+		size_t lineEnd = content.find('\n', lineStart);
+		if (lineEnd == string_view::npos) lineEnd = content.size();
 
-			for (const string& li : lines)
-			{
-				if (li.empty()
-					|| li.starts_with("//"))
-				{
-					continue;
-				}
+		string_view l = content.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
 
-				string cli = TrimString(ReplaceAfter(li, "//"));
-				if (cli.empty()) continue;
+		string_view line = TrimView(l.substr(0, l.find("//")));
+		if (line.empty()) continue;
 
-				if (!collecting)
-				{
-					if (categoryValue.empty())
-					{
-						if (cli == "#" + string(categoryName)) collecting = true;
-					}
-					else if (cli == "#" + string(categoryName) + " " + string(categoryValue)) collecting = true;
-					
-					continue;
-				}
+		if (line[0] != '#')
+		{
+			//fields before the first category belong to nothing
+			if (current) current->fields.push_back(line);
+			continue;
+		}
 
-				if (cli[0] == '#') break;
+		string_view name{};
+		string_view value{};
 
-				collected.push_back(cli);
-			}
+		ExtractCategoryData(
+			line, 
+			name,
+			value);
 
-			return collected;
-		};
+		CategoryType type{};
+		if (!StringToEnum(name, KalaMakeCore::GetCategoryTypes(), type)
+			|| type == CategoryType::C_INVALID)
+		{
+			KalaMakeCore::CloseOnError(
+				"KALAMAKE",
+				"Category type '" + string(name) + "' is invalid!");
+		}
 
-	const auto& categoryTypes = KalaMakeCore::GetCategoryTypes();
-	const auto& versions = KalaMakeCore::GetVersions();
+		size_t categoryIndex = index.categories.size();
 
-	auto clean_line = [&categoryTypes](
-		string& line, 
-		string& name, 
-		string& value, 
-		CategoryType& type) -> void
+		switch (type)
+		{
+		case CategoryType::C_VERSION:
 		{
-			if (line.empty()
-				|| line.starts_with("//")
-				|| !line.starts_with('#'))
+			if (index.versionIndex != ProjectIndex::npos)
 			{
-				return;
+				KalaMakeCore::CloseOnError(
+					"KALAMAKE",
+					"Version category was passed more than once!");
 			}
-
-			line = TrimString(ReplaceAfter(line, "//"));
-
-			ExtractCategoryData(
-				line, 
-				name,
-				value);
-
-			if (!StringToEnum(name, categoryTypes, type)
-				|| type == CategoryType::C_INVALID)
+			index.versionIndex = categoryIndex;
+			break;
+		}
+		case CategoryType::C_REFERENCES:
+		{
+			if (index.referencesIndex != ProjectIndex::npos)
 			{
 				KalaMakeCore::CloseOnError(
 					"KALAMAKE",
-					"Category type '" + name + "' is invalid!");
+					"References category was used more than once!");
 			}
-		};
-
-	string correctTargetProfile{};
-	for (const string& l : lines)
-	{
-		string line = l;
-		string name{};
-		string value{};
-
-		CategoryType type{};
-		clean_line(line, name, value, type);
-
-		if (type == CategoryType::C_PROFILE)
+			index.referencesIndex = categoryIndex;
+			break;
+		}
+		case CategoryType::C_GLOBAL:
+		{
+			if (index.globalIndex != ProjectIndex::npos)
+			{
+				KalaMakeCore::CloseOnError(
+					"KALAMAKE",
+					"Global category was used more than once!");
+			}
+			index.globalIndex = categoryIndex;
+			break;
+		}
+		case CategoryType::C_PROFILE:
 		{
 			if (value == "global")
 			{
@@ -1856,733 +2055,527 @@ void FirstParse(const vector<string>& lines)
 					"KALAMAKE",
 					"User profile name is not allowed to be 'global'!");
 			}
-
 			if (ContainsUnsafeFileChar(value))
 			{
 				KalaMakeCore::CloseOnError(
 					"KALAMAKE",
-					"User profile name '" + value + "' must only contain 'A-Z', 'a-z', '0-9', '_', '-' or '.'!");
+					"User profile name '" + string(value) + "' must only contain 'A-Z', 'a-z', '0-9', '_', '-' or '.'!");
 			}
-
-			if (value != targetProfile) continue;
-			else
+			if (!index.profileIndices.emplace(value, categoryIndex).second)
 			{
-				foundTargetProfile = true;
-				correctTargetProfile = value;
-
-				break;
+				KalaMakeCore::CloseOnError(
+					"KALAMAKE",
+					"User profile '" + string(value) + "' was added more than once!");
 			}
+			break;
 		}
-	}
-	if (!foundTargetProfile)
-	{
-		for (const string& l : lines)
-		{
-			string line = l;
-			string name{};
-			string value{};
-
-			CategoryType type{};
-			clean_line(line, name, value, type);
-
-			if (type == CategoryType::C_GLOBAL
-				&& targetProfile == "global")
-			{
-				foundTargetProfile = true;
-				correctTargetProfile = targetProfile;
-				break;
-			}
+		default: break;
 		}
-	}
-
-	if (!foundTargetProfile)
-	{
-		KalaMakeCore::CloseOnError(
-			"KALAMAKE",
-			"Target profile '" + targetProfile + "' was not found!");
-	}
 
-	if (!foundVersion)
-	{
-		for (const string& l : lines)
-		{
-			string line = l;
-			string name{};
-			string value{};
-
-			CategoryType type{};
-			clean_line(line, name, value, type);
-
-			if (type == CategoryType::C_VERSION)
+		current = &index.categories.emplace_back(
+			CategoryRecord
 			{
-				if (foundVersion)
-				{
-					KalaMakeCore::CloseOnError(
-						"KALAMAKE",
-						"Version category was passed more than once!");
-				}
-
-				Version v{};
-				bool convertVersion = StringToEnum(
-					value, 
-					versions, 
-					v);
-
-				if (!convertVersion
-					|| v == Version::V_INVALID)
-				{
-					KalaMakeCore::CloseOnError(
-						"KALAMAKE",
-						"Version '" + value  + "' is invalid!");
-				}
-
-				Log::Print(
-					"Found valid version '" + value + "'",
-					"KALAMAKE",
-					LogType::LOG_INFO);
+				.type = type,
+				.value = value
+			});
+	}
 
-				foundVersion = true;
+	return index;
+}
 
-				break;
-			}
-		}
+void LoadReferences(const CategoryRecord& category)
+{
+	SessionContext& context = SessionContext::Current();
 
-		if (!foundVersion)
+	unordered_map<string, path> fields{};
+	for (const auto& c : category.fields)
+	{
+		string fieldName{};
+		vector<string> fieldValues{};
+		ExtractFieldData(
+			c, 
+			fieldName, 
+			fieldValues,
+			true);
+
+		if (fields.contains(fieldName))
 		{
 			KalaMakeCore::CloseOnError(
 				"KALAMAKE",
-				"Failed to find version!");
+				"Reference field '" + fieldName + "' was duplicated!");
 		}
-	}
 
-	if (!foundReferences)
-	{
-		for (const string& l : lines)
-		{
-			string line = l;
-			string name{};
-			string value{};
+		fields[fieldName] = fieldValues[0];
+	}
 
-			CategoryType type{};
-			clean_line(line, name, value, type);
+	context.globalData.references.reserve(context.globalData.references.size() + fields.size());
 
-			if (type == CategoryType::C_REFERENCES)
+	for (const auto& [k, v] : fields)
+	{
+		context.globalData.references.emplace(
+			k,
+			ReferenceData
 			{
-				Log::Print(
-					"\n---------------------------------------------------------------------------"
-					"\n# Starting to parse references category\n"
-					"---------------------------------------------------------------------------\n");
+				.name = k,
+				.value = v.string()
+			});
+	}
 
-				if (foundReferences)
-				{
-					KalaMakeCore::CloseOnError(
-						"KALAMAKE",
-						"References category was used more than once!");
-				}
+	context.foundReferences = true;
+}
 
-				vector<string> content = get_all_category_content(name);
+path FindSnapshotPath(const ProjectIndex& index)
+{
+	SessionContext& context = SessionContext::Current();
 
-				unordered_map<string, path> fields{};
-				for (const auto& c : content)
-				{
-					string fieldName{};
-					vector<string> fieldValues{};
-					ExtractFieldData(
-						c, 
-						fieldName, 
-						fieldValues,
-						true);
-
-					if (fields.contains(fieldName))
-					{
-						KalaMakeCore::CloseOnError(
-							"KALAMAKE",
-							"Reference field '" + fieldName + "' was duplicated!");
-					}
+	string prefix = string(Schema::GetField(FieldType::T_BUILD_PATH).name) + ": ";
 
-					fields[fieldName] = fieldValues[0];
-				}
+	auto find_build_path = [&prefix](const CategoryRecord& category) -> string_view
+		{
+			for (string_view f : category.fields)
+			{
+				if (f.starts_with(prefix)) return TrimView(f.substr(prefix.size()));
+			}
 
-				globalData.references.reserve(globalData.references.size() + fields.size());
+			return {};
+		};
 
-				for (const auto& [k, v] : fields)
-				{
-					ReferenceData ref
-					{
-						.name = k,
-						.value = v.string()
-					};
+	string_view value{};
 
-					globalData.references.push_back(ref);	
-				}
+	if (auto it = index.profileIndices.find(context.targetProfile);
+		it != index.profileIndices.end())
+	{
+		value = find_build_path(index.categories[it->second]);
+	}
+	else if (context.targetProfile != "global") return {};
 
-				foundReferences = true;
+	if (value.empty()
+		&& index.globalIndex != ProjectIndex::npos)
+	{
+		value = find_build_path(index.categories[index.globalIndex]);
+	}
 
-				break;
-			}
-		}
+	//anything unusual is left for the full parse to report
+	if (value.size() <= 2
+		|| value.front() != '"'
+		|| value.back() != '"')
+	{
+		return {};
 	}
 
-	if (!foundGlobal)
+	string buildPath(value.substr(1, value.size() - 2));
+
+	if (buildPath.find("${") != string::npos)
 	{
-		for (const string& l : lines)
-		{
-			string line = l;
-			string name{};
-			string value{};
+		if (index.referencesIndex == ProjectIndex::npos) return {};
 
-			CategoryType type{};
-			clean_line(line, name, value, type);
+		LoadReferences(index.categories[index.referencesIndex]);
+		buildPath = TranslateReferences(buildPath);
+	}
 
-			if (type == CategoryType::C_GLOBAL)
-			{
-				Log::Print(
-					"\n---------------------------------------------------------------------------"
-					"\n# Starting to parse global profile\n"
-					"---------------------------------------------------------------------------\n");
+	//relative to the kmake file like ExtractFieldData resolves it, not to the working directory
+	path resolvedPath = buildPath;
+	if (resolvedPath.is_relative()) resolvedPath = context.kmaPath / resolvedPath;
 
-				if (foundGlobal)
-				{
-					KalaMakeCore::CloseOnError(
-						"KALAMAKE",
-						"Global category was used more than once!");
-				}
-				
-				vector<string> content = get_all_category_content(name);
+	error_code ec{};
+	path canonicalPath = weakly_canonical(resolvedPath, ec);
+	if (ec) return {};
 
-				unordered_map<string, vector<string>> fields{};
-				for (const auto& c : content)
-				{
-					string fieldName{};
-					vector<string> fieldValues{};
-					ExtractFieldData(
-						c, 
-						fieldName, 
-						fieldValues);
-
-					if (fields.contains(fieldName)
-						&& fieldName != field_pre_build_action
-						&& fieldName != field_post_build_action)
-					{
-						KalaMakeCore::CloseOnError(
-							"KALAMAKE",
-							"Field '" + fieldName + "' was duplicated!");
-					}
+	return Snapshot::GetPath(canonicalPath, context.targetProfile);
+}
 
-					if (fieldName != field_pre_build_action
-						&& fieldName != field_post_build_action)
-					{
-						fields[fieldName] = fieldValues;
-					}
-					else
-					{
-						if (!fields.contains(string(field_pre_build_action))
-							&& !fields.contains(string(field_post_build_action)))
-						{
-							fields[fieldName] = fieldValues;
-						}
-						else fields[fieldName].push_back(fieldValues[0]);
-					}
-				}
+void RecordTraversal(
+	const vector<path>& visitedPaths,
+	const vector<path>& resolvedPaths)
+{
+	SessionContext& context = SessionContext::Current();
 
-				if (fields.contains(string(field_binary_type)))
-				{
-					const vector<string>& values = fields[string(field_binary_type)];
+	for (const auto& p : visitedPaths) context.traversedPaths.insert(p.lexically_normal().string());
 
-					BinaryType result{};
-					StringToEnum(values.front(), KalaMake::Core::binaryTypes, result);
-					globalData.targetProfile.binaryType = result;
-				}
-				if (fields.contains(string(field_compiler_launcher)))
-				{
-					const vector<string>& values = fields[string(field_compiler_launcher)];
+	//removing a resolved file or dir changes its parent
+	for (const auto& p : resolvedPaths) context.traversedPaths.insert(p.parent_path().lexically_normal().string());
+}
 
-					CompilerLauncherType result{};
-					StringToEnum(values.front(), KalaMake::Core::compilerLauncherTypes, result);
-					globalData.targetProfile.compilerLauncher = result;
-				}
-				if (fields.contains(string(field_compiler)))
-				{
-					const vector<string>& values = fields[string(field_compiler)];
+void CollectSourceExclusions(const CategoryRecord& category)
+{
+	SessionContext& context = SessionContext::Current();
 
-					CompilerType result{};
-					StringToEnum(values.front(), KalaMake::Core::compilerTypes, result);
-					globalData.targetProfile.compiler = result;
-				}
-				if (fields.contains(string(field_standard)))
-				{
-					const vector<string>& values = fields[string(field_standard)];
+	string prefix = string(Schema::GetField(FieldType::T_SOURCES).name) + ": ";
 
-					StandardType result{};
-					StringToEnum(values.front(), KalaMake::Core::standardTypes, result);
-					globalData.targetProfile.standard = result;
-				}
-				if (fields.contains(string(field_target_type)))
-				{
-					const vector<string>& values = fields[string(field_target_type)];
+	for (string_view f : category.fields)
+	{
+		if (!f.starts_with(prefix)) continue;
 
-					TargetType result{};
-					StringToEnum(values.front(), KalaMake::Core::targetTypes, result);
-					globalData.targetProfile.targetType = result;
-				}
-				if (fields.contains(string(field_jobs)))
-				{
-					const vector<string>& values = fields[string(field_jobs)];
-					globalData.targetProfile.jobs = scast<u16>(stoul(values[0]));
-				}
+		string ref = TranslateReferences(TrimView(f.substr(prefix.size())));
 
-				if (fields.contains(string(field_binary_name)))
-				{
-					globalData.targetProfile.binaryName = fields[string(field_binary_name)][0];
-				}
-				if (fields.contains(string(field_build_type)))
-				{
-					const vector<string>& values = fields[string(field_build_type)];
+		for (const auto& v : SplitFieldValues(ref))
+		{
+			if (v.size() <= 3
+				|| !v.starts_with("\"!")
+				|| !v.ends_with('"'))
+			{
+				continue;
+			}
 
-					BuildType result{};
-					StringToEnum(values.front(), KalaMake::Core::buildTypes, result);
-					globalData.targetProfile.buildType = result;
-				}
-				if (fields.contains(string(field_build_path)))
-				{
-					globalData.targetProfile.buildPath = fields[string(field_build_path)][0];
-				}
-				if (fields.contains(string(field_sources)))
-				{
-					vector<path> pathResult{};
-					ToPathVector(fields[string(field_sources)], pathResult);
+			string pattern = ToGenericPattern(v.substr(2, v.size() - 3));
+			context.sourceExclusions.Add(pattern);
 
-					globalData.targetProfile.sources = std::move(pathResult);
-				}
-				if (fields.contains(string(field_headers)))
-				{
-					vector<path> pathResult{};
-					ToPathVector(fields[string(field_headers)], pathResult);
+			Log::Print(
+				"Excluding sources matching '" + pattern + "'.",
+				"KALAMAKE",
+				LogType::LOG_INFO);
+		}
+	}
+}
 
-					globalData.targetProfile.headers = std::move(pathResult);
-				}
-				if (fields.contains(string(field_links)))
-				{
-					vector<path> pathResult{};
-					ToPathVector(fields[string(field_links)], pathResult);
+void FirstParse(const ProjectIndex& index)
+{
+	SessionContext& context = SessionContext::Current();
 
-					globalData.targetProfile.links = std::move(pathResult);
-				}
-				if (fields.contains(string(field_warning_level)))
-				{
-					const vector<string>& values = fields[string(field_warning_level)];
+	//always a fresh build
+	CleanEverything();
 
-					WarningLevel result{};
-					StringToEnum(values.front(), KalaMake::Core::warningLevels, result);
-					globalData.targetProfile.warningLevel = result;
-				}
-				if (fields.contains(string(field_defines)))
-				{
-					globalData.targetProfile.defines = std::move(fields[string(field_defines)]);
-				}
-				if (fields.contains(string(field_compile_flags)))
-				{
-					globalData.targetProfile.compileFlags = std::move(fields[string(field_compile_flags)]);
-				}
-				if (fields.contains(string(field_link_flags)))
-				{
-					globalData.targetProfile.linkFlags = std::move(fields[string(field_link_flags)]);
-				}
-				if (fields.contains(string(field_custom_flags)))
-				{
-					const vector<string>& values = fields[string(field_custom_flags)];
-					vector<CustomFlag> customFlags{};
+	context.foundAnyUserProfile = !index.profileIndices.empty();
 
-					for (const auto& cf : values)
-					{
-						CustomFlag result{};
-						StringToEnum(cf, KalaMake::Core::customFlags, result);
-						customFlags.push_back(result);
-					}
-					globalData.targetProfile.customFlags = std::move(customFlags);
-				}
-				if (fields.contains(string(field_pre_build_action)))
-				{
-					globalData.targetProfile.preBuildActions = std::move(fields[string(field_pre_build_action)]);
-				}
-				if (fields.contains(string(field_post_build_action)))
-				{
-					globalData.targetProfile.postBuildActions = std::move(fields[string(field_post_build_action)]);
-				}
+	const CategoryRecord* targetCategory{};
 
-				foundGlobal = true;
+	if (auto it = index.profileIndices.find(context.targetProfile);
+		it != index.profileIndices.end())
+	{
+		context.foundTargetProfile = true;
+		targetCategory = &index.categories[it->second];
+	}
+	else if (context.targetProfile == "global"
+		&& index.globalIndex != ProjectIndex::npos)
+	{
+		context.foundTargetProfile = true;
+	}
 
-				break;
-			}
-		}
+	if (!context.foundTargetProfile)
+	{
+		KalaMakeCore::CloseOnError(
+			"KALAMAKE",
+			"Target profile '" + context.targetProfile + "' was not found!");
+	}
+
+	if (index.versionIndex == ProjectIndex::npos)
+	{
+		KalaMakeCore::CloseOnError(
+			"KALAMAKE",
+			"Failed to find version!");
+	}
+	else
+	{
+		string_view value = index.categories[index.versionIndex].value;
 
-		if (!foundGlobal)
+		Version v{};
+		bool convertVersion = StringToEnum(
+			value, 
+			KalaMakeCore::GetVersions(), 
+			v);
+
+		if (!convertVersion
+			|| v == Version::V_INVALID)
 		{
 			KalaMakeCore::CloseOnError(
 				"KALAMAKE",
-				"Failed to find global profile!");
+				"Version '" + string(value)  + "' is invalid!");
 		}
-	}
 
-	if (foundTargetProfile
-		&& correctTargetProfile != "global")
-	{
-		for (const string& l : lines)
-		{
-			string line = l;
-			string name{};
-			string value{};
+		Log::Print(
+			"Found valid version '" + string(value) + "'",
+			"KALAMAKE",
+			LogType::LOG_INFO);
 
-			CategoryType type{};
-			clean_line(line, name, value, type);
+		context.foundVersion = true;
+	}
 
-			if (type == CategoryType::C_PROFILE)
-			{
-				if (value != correctTargetProfile) continue;
+	if (index.referencesIndex != ProjectIndex::npos)
+	{
+		Log::Print(
+			"\n---------------------------------------------------------------------------"
+			"\n# Starting to parse references category\n"
+			"---------------------------------------------------------------------------\n");
 
-				Log::Print(
-					"\n---------------------------------------------------------------------------"
-					"\n# Starting to parse user profile '" + value + "'\n"
-					"---------------------------------------------------------------------------\n");
+		LoadReferences(index.categories[index.referencesIndex]);
+	}
 
-				vector<string> content = get_all_category_content(name, value);
+	//exclusions prune walks of both global and profile sources
+	if (index.globalIndex != ProjectIndex::npos) CollectSourceExclusions(index.categories[index.globalIndex]);
+	if (targetCategory) CollectSourceExclusions(*targetCategory);
 
-				unordered_map<string, vector<string>> fields{};
-				for (const auto& c : content)
-				{
-					string fieldName{};
-					vector<string> fieldValues{};
-					ExtractFieldData(
-						c, 
-						fieldName, 
-						fieldValues);
-
-					if (fields.contains(fieldName)
-						&& fieldName != field_pre_build_action
-						&& fieldName != field_post_build_action)
-					{
-						KalaMakeCore::CloseOnError(
-							"KALAMAKE",
-							"Field '" + fieldName + "' was duplicated!");
-					}
+	if (index.globalIndex == ProjectIndex::npos)
+	{
+		KalaMakeCore::CloseOnError(
+			"KALAMAKE",
+			"Failed to find global profile!");
+	}
 
-					if (fieldName != field_pre_build_action
-						&& fieldName != field_post_build_action)
-					{
-						fields[fieldName] = fieldValues;
-					}
-					else
-					{
-						if (!fields.contains(string(field_pre_build_action))
-							&& !fields.contains(string(field_post_build_action)))
-						{
-							fields[fieldName] = fieldValues;
-						}
-						else fields[fieldName].push_back(fieldValues[0]);
-					}
-				}
+	//global and profile lines are merged before anything is resolved,
+	//so global values the profile replaces never walk globs or create dirs
+	vector<FieldLines> fieldLines{};
+	CollectFieldLines(index.categories[index.globalIndex], fieldLines);
 
-				globalData.targetProfile.profileName = value;
-				if (fields.contains(string(field_binary_type)))
-				{
-					const vector<string>& values = fields[string(field_binary_type)];
+	context.foundGlobal = true;
 
-					BinaryType result{};
-					StringToEnum(values.front(), KalaMake::Core::binaryTypes, result);
-					globalData.targetProfile.binaryType = result;
-				}
-				if (fields.contains(string(field_compiler)))
-				{
-					const vector<string>& values = fields[string(field_compiler)];
+	if (targetCategory)
+	{
+		vector<FieldLines> profileLines{};
+		CollectFieldLines(*targetCategory, profileLines);
 
-					CompilerType result{};
-					StringToEnum(values.front(), KalaMake::Core::compilerTypes, result);
-					globalData.targetProfile.compiler = result;
-				}
-				if (fields.contains(string(field_compiler_launcher)))
-				{
-					const vector<string>& values = fields[string(field_compiler_launcher)];
+		for (auto& f : profileLines)
+		{
+			auto it = find_if(
+				fieldLines.begin(),
+				fieldLines.end(),
+				[&f](const FieldLines& g) { return g.name == f.name; });
+
+			if (it == fieldLines.end()) fieldLines.push_back(std::move(f));
+			else if (f.schema
+				&& f.schema->isMerged)
+			{
+				it->lines.insert(
+					it->lines.end(),
+					f.lines.begin(),
+					f.lines.end());
+			}
+			else it->lines = std::move(f.lines);
+		}
 
-					CompilerLauncherType result{};
-					StringToEnum(values.front(), KalaMake::Core::compilerLauncherTypes, result);
-					globalData.targetProfile.compilerLauncher = result;
-				}
-				if (fields.contains(string(field_standard)))
-				{
-					const vector<string>& values = fields[string(field_standard)];
+		context.globalData.targetProfile.profileName = string(targetCategory->value);
+	}
 
-					StandardType result{};
-					StringToEnum(values.front(), KalaMake::Core::standardTypes, result);
-					globalData.targetProfile.standard = result;
-				}
-				if (fields.contains(string(field_target_type)))
-				{
-					const vector<string>& values = fields[string(field_target_type)];
+	string profileName = targetCategory
+		? string(targetCategory->value)
+		: "global";
 
-					TargetType result{};
-					StringToEnum(values.front(), KalaMake::Core::targetTypes, result);
-					globalData.targetProfile.targetType = result;
-				}
-				if (fields.contains(string(field_jobs)))
-				{
-					const vector<string>& values = fields[string(field_jobs)];
-					globalData.targetProfile.jobs = scast<u16>(stoul(values[0]));
-				}
+	Log::Print(
+		"\n---------------------------------------------------------------------------"
+		"\n# Starting to resolve profile '" + profileName + "'\n"
+		"---------------------------------------------------------------------------\n");
 
-				if (fields.contains(string(field_binary_name)))
-				{
-					globalData.targetProfile.binaryName = fields[string(field_binary_name)][0];
-				}
-				if (fields.contains(string(field_build_type)))
-				{
-					const vector<string>& values = fields[string(field_build_type)];
+	for (const auto& f : fieldLines)
+	{
+		vector<string> values{};
 
-					BuildType result{};
-					StringToEnum(values.front(), KalaMake::Core::buildTypes, result);
-					globalData.targetProfile.buildType = result;
-				}
-				if (fields.contains(string(field_build_path)))
-				{
-					globalData.targetProfile.buildPath = fields[string(field_build_path)][0];
-				}
-				if (fields.contains(string(field_sources)))
-				{
-					vector<path> pathResult{};
-					ToPathVector(fields[string(field_sources)], pathResult);
+		for (string_view l : f.lines)
+		{
+			string fieldName{};
+			vector<string> fieldValues{};
+			ExtractFieldData(
+				l, 
+				fieldName, 
+				fieldValues);
+
+			values.insert(
+				values.end(),
+				make_move_iterator(fieldValues.begin()),
+				make_move_iterator(fieldValues.end()));
+		}
 
-					globalData.targetProfile.sources.reserve(
-						globalData.targetProfile.sources.size()
-						+ pathResult.size());
+		//every line was validated, so the field exists and every value is accepted
+		if (values.empty()) continue;
 
-					globalData.targetProfile.sources.insert(
-						globalData.targetProfile.sources.end(),
-						pathResult.begin(),
-						pathResult.end());
+		//repeated commands are run again, every other value is kept once
+		if (f.schema->kind != ValueKind::V_ACTION) RemoveDuplicates(values);
 
-					RemoveDuplicates(globalData.targetProfile.sources);
-				}
-				if (fields.contains(string(field_headers)))
-				{
-					vector<path> pathResult{};
-					ToPathVector(fields[string(field_headers)], pathResult);
+		f.schema->assign(
+			context.globalData.targetProfile,
+			*f.schema,
+			values);
+	}
+}
 
-					globalData.targetProfile.headers.reserve(
-						globalData.targetProfile.headers.size()
-						+ pathResult.size());
+void CollectFieldLines(
+	const CategoryRecord& category,
+	vector<FieldLines>& outFields)
+{
+	for (string_view l : category.fields)
+	{
+		//a missing separator is reported when the line is resolved
+		string name(TrimView(l.substr(0, l.find(": "))));
 
-					globalData.targetProfile.headers.insert(
-						globalData.targetProfile.headers.end(),
-						pathResult.begin(),
-						pathResult.end());
+		auto it = find_if(
+			outFields.begin(),
+			outFields.end(),
+			[&name](const FieldLines& f) { return f.name == name; });
 
-					RemoveDuplicates(globalData.targetProfile.headers);
-				}
-				if (fields.contains(string(field_links)))
-				{
-					vector<path> pathResult{};
-					ToPathVector(fields[string(field_links)], pathResult);
+		if (it == outFields.end())
+		{
+			const FieldSchema* schema = Schema::FindField(name);
+			outFields.push_back({ .name = std::move(name), .schema = schema, .lines = { l } });
+			continue;
+		}
 
-					globalData.targetProfile.links.reserve(
-						globalData.targetProfile.links.size()
-						+ pathResult.size());
+		if (!it->schema
+			|| !it->schema->isRepeatable)
+		{
+			KalaMakeCore::CloseOnError(
+				"KALAMAKE",
+				"Field '" + name + "' was duplicated!");
+		}
 
-					globalData.targetProfile.links.insert(
-						globalData.targetProfile.links.end(),
-						pathResult.begin(),
-						pathResult.end());
+		it->lines.push_back(l);
+	}
+}
 
-					RemoveDuplicates(globalData.targetProfile.links);
-				}
-				if (fields.contains(string(field_warning_level)))
-				{
-					vector<string>& values = fields[string(field_warning_level)];
+//Parses a reference name starting right after '${' and moves pos past its closing '}',
+//nested references inside the name are expanded first
+static string ReadReferenceName(
+	string_view value,
+	size_t& pos,
+	vector<string>& resolveStack);
 
-					WarningLevel result{};
-					StringToEnum(values.front(), KalaMake::Core::warningLevels, result);
-					globalData.targetProfile.warningLevel = result;
-				}
-				if (fields.contains(string(field_defines)))
-				{
-					vector<string>& defines = fields[string(field_defines)];
+//Returns the fully expanded value of a reference, expanding it once on first use
+static const string& ResolveReference(
+	string_view fieldValue,
+	const string& name,
+	vector<string>& resolveStack);
 
-					globalData.targetProfile.defines.reserve(
-						globalData.targetProfile.defines.size()
-						+ defines.size());
+static string ExpandReferences(
+	string_view value,
+	vector<string>& resolveStack)
+{
+	string result{};
+	result.reserve(value.size());
 
-					globalData.targetProfile.defines.insert(
-						globalData.targetProfile.defines.end(),
-						defines.begin(),
-						defines.end());
+	size_t pos = 0;
+	while (pos < value.size())
+	{
+		size_t refStart = value.find("${", pos);
+		if (refStart == string_view::npos)
+		{
+			result.append(value.substr(pos));
+			break;
+		}
 
-					RemoveDuplicates(globalData.targetProfile.defines);
-				}
-				if (fields.contains(string(field_compile_flags)))
-				{
-					vector<string>& flags = fields[string(field_compile_flags)];
+		result.append(value.substr(pos, refStart - pos));
+		pos = refStart + 2;
 
-					globalData.targetProfile.compileFlags.reserve(
-						globalData.targetProfile.compileFlags.size()
-						+ flags.size());
+		string name = ReadReferenceName(value, pos, resolveStack);
+		result += ResolveReference(value, name, resolveStack);
+	}
 
-					globalData.targetProfile.compileFlags.insert(
-						globalData.targetProfile.compileFlags.end(),
-						flags.begin(),
-						flags.end());
+	return result;
+}
 
-					RemoveDuplicates(globalData.targetProfile.compileFlags);
-				}
-				if (fields.contains(string(field_link_flags)))
-				{
-					vector<string>& flags = fields[string(field_link_flags)];
+string ReadReferenceName(
+	string_view value,
+	size_t& pos,
+	vector<string>& resolveStack)
+{
+	string name{};
 
-					globalData.targetProfile.linkFlags.reserve(
-						globalData.targetProfile.linkFlags.size()
-						+ flags.size());
+	while (pos < value.size())
+	{
+		char c = value[pos];
 
-					globalData.targetProfile.linkFlags.insert(
-						globalData.targetProfile.linkFlags.end(),
-						flags.begin(),
-						flags.end());
+		if (c == '}')
+		{
+			++pos;
 
-					RemoveDuplicates(globalData.targetProfile.linkFlags);
-				}
-				if (fields.contains(string(field_custom_flags)))
-				{
-					const vector<string>& values = fields[string(field_custom_flags)];
-					vector<CustomFlag> customFlags{};
+			if (name.empty())
+			{
+				KalaMakeCore::CloseOnError(
+					"KALAMAKE",
+					"Failed to find dereference values in field value '" + string(value) + "' because a reference had no value between brackets!");
+			}
+			if (ContainsSpace(name))
+			{
+				KalaMakeCore::CloseOnError(
+					"KALAMAKE",
+					"Failed to find dereference values in field value '" + string(value) + "' because reference '" + name + "' contains whitespace characters!");
+			}
 
-					for (const auto& cf : values)
-					{
-						CustomFlag result{};
-						StringToEnum(cf, KalaMake::Core::customFlags, result);
-						customFlags.push_back(result);
-					}
+			return name;
+		}
 
-					globalData.targetProfile.customFlags.reserve(
-						globalData.targetProfile.customFlags.size()
-						+ customFlags.size());
+		if (c == '$'
+			&& pos + 1 < value.size()
+			&& value[pos + 1] == '{')
+		{
+			pos += 2;
 
-					globalData.targetProfile.customFlags.insert(
-						globalData.targetProfile.customFlags.end(),
-						customFlags.begin(),
-						customFlags.end());
+			string childName = ReadReferenceName(value, pos, resolveStack);
+			name += ResolveReference(value, childName, resolveStack);
 
-					RemoveDuplicates(globalData.targetProfile.customFlags);
-				}
-				if (fields.contains(string(field_pre_build_action)))
-				{
-					const vector<string>& values = fields[string(field_pre_build_action)];
+			continue;
+		}
 
-					globalData.targetProfile.preBuildActions.reserve(
-						globalData.targetProfile.preBuildActions.size()
-						+ values.size());
+		name += c;
+		++pos;
+	}
 
-					globalData.targetProfile.preBuildActions.insert(
-						globalData.targetProfile.preBuildActions.end(),
-						values.begin(),
-						values.end());
-				}
-				if (fields.contains(string(field_post_build_action)))
-				{
-					const vector<string>& values = fields[string(field_post_build_action)];
+	KalaMakeCore::CloseOnError(
+		"KALAMAKE",
+		"Failed to find dereference values in field value '" + string(value) + "' because a reference value was not closed by a closing bracket!");
 
-					globalData.targetProfile.postBuildActions.reserve(
-						globalData.targetProfile.postBuildActions.size()
-						+ values.size());
+	return name;
+}
 
-					globalData.targetProfile.postBuildActions.insert(
-						globalData.targetProfile.postBuildActions.end(),
-						values.begin(),
-						values.end());
-				}
+const string& ResolveReference(
+	string_view fieldValue,
+	const string& name,
+	vector<string>& resolveStack)
+{
+	SessionContext& context = SessionContext::Current();
 
-				if (value == correctTargetProfile) break;
-			}
-		}
+	auto it = context.globalData.references.find(name);
+	if (it == context.globalData.references.end())
+	{
+		KalaMakeCore::CloseOnError(
+			"KALAMAKE",
+			"Failed to find dereference value '" + name + "' in field value '" + string(fieldValue) + "' because it has not been added as a reference!");
 	}
-}
 
-string TranslateReferences(string_view value)
-{
-	//value did not contain any references, skip
-	if (value.find('$') == string_view::npos) return string(value);
+	ReferenceData& ref = it->second;
 
-	string result = string(value);
+	if (ref.state == ReferenceState::R_RESOLVED) return ref.expandedValue;
 
-	function<void(size_t)> replace_ref;
+	if (ref.state == ReferenceState::R_RESOLVING)
+	{
+		string chain{};
+		for (const auto& s : resolveStack) chain += s + " -> ";
+		chain += name;
 
-	replace_ref = [&](size_t start)
-		{
-			size_t refBracketPos = result.find('{', start);
+		KalaMakeCore::CloseOnError(
+			"KALAMAKE",
+			"Reference '" + name + "' refers back to itself through '" + chain + "'!");
+	}
 
-			//find ref start here before the closing bracket and jump to child
-			size_t childRef = result.find('$', refBracketPos + 1);
-			while (childRef != string::npos
-				   && childRef < result.find('}', refBracketPos))
-			{
-				replace_ref(childRef);
-				childRef = result.find('$', refBracketPos + 1);
-			}
+	ref.state = ReferenceState::R_RESOLVING;
+	resolveStack.push_back(name);
 
-			size_t refBracketEndPos = result.find('}', refBracketPos);
-			if (refBracketEndPos == string::npos)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Failed to find dereference values in field value '" + result + "' because a reference value was not closed by a closing bracket!");
-			}
+	//map nodes are stable, so ref stays valid while nested references expand
+	ref.expandedValue = ExpandReferences(ref.value, resolveStack);
 
-			if (refBracketEndPos == refBracketPos + 1)
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Failed to find dereference values in field value '" + result + "' because a reference had no value between brackets!");
-			}
+	resolveStack.pop_back();
+	ref.state = ReferenceState::R_RESOLVED;
+
+	return ref.expandedValue;
+}
 
-			string refValue = result.substr(
-				refBracketPos + 1,
-				refBracketEndPos - refBracketPos - 1);
+string TranslateReferences(string_view value)
+{
+	//value did not contain any references, skip
+	if (value.find("${") == string_view::npos) return string(value);
 
-			if (ContainsSpace(refValue))
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Failed to find dereference values in field value '" + result + "' because reference '" + refValue + "' contains whitespace characters!");
-			}
+	vector<string> resolveStack{};
+	return ExpandReferences(value, resolveStack);
+}
 
-			string replacement{};
-			for (const auto& r : globalData.references)
-			{
-				if (r.name == refValue)
-				{
-					replacement = r.value;
-					break;
-				}
-			}
-			if (replacement.empty())
-			{
-				KalaMakeCore::CloseOnError(
-					"KALAMAKE",
-					"Failed to find dereference value '" + refValue + "' in field value '" + result + "' because it has not been added as a reference!");
-			}
+bool SplitProjectLink(
+	const path& link,
+	path& outProject,
+	string& outProfile)
+{
+	string value = link.string();
 
-			result.replace(
-				start,
-				refBracketEndPos - start + 1,
-				replacement);
-		};
+	size_t projectEnd = value.rfind(project_link_marker);
+	if (projectEnd == string::npos) return false;
 
-	for (size_t i = 0; i < result.size(); i++)
-	{
-		if (result[i] == '$')
-		{
-			if (i + 1 < result.size() 
-				&& result[i + 1] == '{')
-			{
-				replace_ref(i);
-			}
-		}
-	}
+	outProject = value.substr(0, projectEnd + project_link_marker.size() - 1);
+	outProfile = value.substr(projectEnd + project_link_marker.size());
 
-	return result;
-}
\ No newline at end of file
+	return true;
+}
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <sstream>
 #include <filesystem>
+#include <mutex>
 
 #include "log_utils.hpp"
 #include "string_utils.hpp"
@@ -26,6 +27,8 @@ using KalaHeaders::KalaFile::ReadLinesFromFile;
 using KalaHeaders::KalaFile::FileType;
 
 using std::ostringstream;
+using std::mutex;
+using std::lock_guard;
 using std::filesystem::current_path;
 using std::filesystem::exists;
 
@@ -36,10 +39,15 @@ static bool isWindows =
     false;
 #endif
 
+//profiles compiled together share the files in the working directory
+static mutex m_generate{};
+
 namespace KalaMake::Core
 {
     void Generate::GenerateCompileCommands(const vector<CompileCommand>& commands)
     {
+		lock_guard<mutex> lock(m_generate);
+
 		path compComm = current_path() / "compile_commands.json";
 
 		Log::Print(
@@ -118,8 +126,96 @@ namespace KalaMake::Core
 			LogType::LOG_SUCCESS);
     }
 
+    void Generate::GenerateDiagnostics(
+        const vector<Diagnostic>& diagnostics,
+        const path& target)
+    {
+		if (exists(target))
+		{
+			string errorMsg = DeletePath(target);
+
+			if (!errorMsg.empty())
+			{
+				KalaMakeCore::CloseOnError(
+					"GENERATE",
+					"Failed to remove existing diagnostics file '" + target.string() + "'! Reason: " + errorMsg);
+			}
+		}
+
+		//compiler messages can carry any control character, including the escape of ansi colors
+		auto fix_json = [](string_view input) -> string
+			{
+				constexpr string_view hex = "0123456789abcdef";
+
+				string result{};
+				result.reserve(input.size());
+
+				for (char c : input)
+				{
+					switch (c)
+					{
+					case '\\': result += "\\\\"; break;
+					case '"':  result += "\\\""; break;
+					case '\n': result += "\\n"; break;
+					case '\r': result += "\\r"; break;
+					case '\t': result += "\\t"; break;
+					case '\b': result += "\\b"; break;
+					case '\f': result += "\\f"; break;
+					default:
+						if (scast<unsigned char>(c) < 0x20)
+						{
+							result += "\\u00";
+							result += hex[scast<unsigned char>(c) >> 4];
+							result += hex[scast<unsigned char>(c) & 0xF];
+						}
+						else result += c;
+						break;
+					}
+				}
+
+				return result;
+			};
+
+		ostringstream out{};
+
+		out << "[\n";
+
+		for (size_t i = 0; i < diagnostics.size(); ++i)
+		{
+			const Diagnostic& d = diagnostics[i];
+
+			out << "    {\n";
+			out << "        \"file\": \""     << fix_json(d.file.string()) << "\",\n";
+			out << "        \"line\": "        << d.line                    << ",\n";
+			out << "        \"column\": "      << d.column                  << ",\n";
+			out << "        \"severity\": \"" << fix_json(d.severity)      << "\",\n";
+			out << "        \"message\": \""  << fix_json(d.message)       << "\"\n";
+			out << "    }";
+
+			if (i + 1 < diagnostics.size()) out << ",";
+
+			out << "\n";
+		}
+
+		out << "]";
+
+		string errorMsg = CreateNewFile(
+			target,
+			FileType::FILE_TEXT,
+			{ .inText = out.str() });
+
+		if (!errorMsg.empty())
+		{
+			KalaMakeCore::CloseOnError(
+				"GENERATE",
+				"Failed to create diagnostics file '" + target.string() + "'! Reason: " + errorMsg);
+		}
+    }
+
     void Generate::GenerateJavaClassPath(const JavaClassPath& javaData)
     {
+        lock_guard<mutex> lock(m_generate);
+
         auto create_class_path = [&javaData]() -> void
             {
                 path classPath = current_path() / ".classpath";
@@ -253,6 +349,8 @@ namespace KalaMake::Core
         const VSCode_Launch& launch,
         const VSCode_Task& task)
     {
+        lock_guard<mutex> lock(m_generate);
+
         path vscodeDir = current_path() / ".vscode";
 
         if (!exists(vscodeDir))
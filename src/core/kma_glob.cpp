@@ -0,0 +1,747 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <system_error>
+
+#include "core/kma_glob.hpp"
+#include "core/kma_snapshot.hpp"
+
+using KalaMake::Core::GlobPattern;
+using KalaMake::Core::GlobSet;
+using KalaMake::Core::GlobTarget;
+using KalaMake::Core::Glob;
+using KalaMake::Core::DirCache;
+using KalaMake::Core::DirListing;
+using KalaMake::Core::ignore_file_name;
+
+using std::vector;
+using std::string;
+using std::string_view;
+using std::ifstream;
+using std::getline;
+using std::shared_ptr;
+using std::make_shared;
+using std::error_code;
+using std::binary_search;
+using std::sort;
+using std::find;
+using std::filesystem::path;
+using std::filesystem::exists;
+using std::filesystem::is_directory;
+
+using u16 = uint16_t;
+
+//One line of an ignore file, compiled against the dir the file is in
+struct IgnoreRule
+{
+	GlobPattern pattern{};
+	bool negate{};
+	bool dirOnly{};
+};
+
+//Rules of one ignore file, deeper files are checked before their parents
+struct IgnoreScope
+{
+	shared_ptr<const IgnoreScope> parent{};
+	vector<IgnoreRule> rules{};
+};
+
+static string JoinGeneric(
+	string_view dir,
+	string_view name)
+{
+	string result(dir);
+	if (!result.ends_with('/')) result += '/';
+	result += name;
+
+	return result;
+}
+
+static bool IsLiteralSegment(string_view segment)
+{
+	return segment.find_first_of("*?[") == string_view::npos;
+}
+
+//Matches one '[...]' set starting at i, returns false if the set is never closed
+static bool MatchClass(
+	string_view pattern,
+	size_t& i,
+	char c,
+	bool& outMatched)
+{
+	size_t j = i + 1;
+
+	bool negate =
+		j < pattern.size()
+		&& (pattern[j] == '!'
+		|| pattern[j] == '^');
+
+	if (negate) ++j;
+
+	bool matched{};
+	size_t start = j;
+
+	//a ']' right after the opening bracket is a literal
+	while (j < pattern.size()
+		&& (pattern[j] != ']'
+		|| j == start))
+	{
+		if (j + 2 < pattern.size()
+			&& pattern[j + 1] == '-'
+			&& pattern[j + 2] != ']')
+		{
+			if (c >= pattern[j]
+				&& c <= pattern[j + 2])
+			{
+				matched = true;
+			}
+
+			j += 3;
+		}
+		else
+		{
+			if (pattern[j] == c) matched = true;
+			++j;
+		}
+	}
+
+	if (j >= pattern.size()) return false;
+
+	outMatched = matched != negate;
+	i = j + 1;
+
+	return true;
+}
+
+static bool MatchSegment(
+	string_view pattern,
+	string_view name)
+{
+	size_t p = 0;
+	size_t n = 0;
+	size_t starP = string_view::npos;
+	size_t starN = 0;
+
+	while (n < name.size())
+	{
+		if (p < pattern.size())
+		{
+			char pc = pattern[p];
+
+			if (pc == '*')
+			{
+				starP = p++;
+				starN = n;
+				continue;
+			}
+			if (pc == '?')
+			{
+				++p;
+				++n;
+				continue;
+			}
+			if (pc == '[')
+			{
+				size_t next = p;
+				bool matched{};
+
+				if (MatchClass(pattern, next, name[n], matched))
+				{
+					if (matched)
+					{
+						p = next;
+						++n;
+						continue;
+					}
+				}
+				//unclosed sets are literal brackets
+				else if (name[n] == '[')
+				{
+					++p;
+					++n;
+					continue;
+				}
+			}
+			else if (pc == name[n])
+			{
+				++p;
+				++n;
+				continue;
+			}
+		}
+
+		//let the last '*' swallow one more char and try again
+		if (starP != string_view::npos)
+		{
+			p = starP + 1;
+			n = ++starN;
+			continue;
+		}
+
+		return false;
+	}
+
+	while (p < pattern.size()
+		&& pattern[p] == '*')
+	{
+		++p;
+	}
+
+	return p == pattern.size();
+}
+
+static void AddState(
+	vector<u16>& states,
+	u16 state)
+{
+	if (find(states.begin(), states.end(), state) == states.end()) states.push_back(state);
+}
+
+static shared_ptr<const IgnoreScope> ReadIgnoreFile(
+	const string& dir,
+	const string& file,
+	const shared_ptr<const IgnoreScope>& parent)
+{
+	ifstream in(file);
+	if (!in) return parent;
+
+	auto scope = make_shared<IgnoreScope>();
+	scope->parent = parent;
+
+	string line{};
+	while (getline(in, line))
+	{
+		while (!line.empty()
+			&& (line.back() == '\r'
+			|| line.back() == ' '
+			|| line.back() == '\t'))
+		{
+			line.pop_back();
+		}
+
+		if (line.empty()
+			|| line.starts_with('#'))
+		{
+			continue;
+		}
+
+		IgnoreRule rule{};
+
+		string_view text = line;
+
+		if (text.starts_with('!'))
+		{
+			rule.negate = true;
+			text.remove_prefix(1);
+		}
+		if (text.ends_with('/'))
+		{
+			rule.dirOnly = true;
+			text.remove_suffix(1);
+		}
+
+		//like gitignore, a rule with a slash is relative to the ignore file,
+		//a rule without one matches at any depth below it
+		bool anchored = text.find('/') != string_view::npos;
+		if (text.starts_with('/')) text.remove_prefix(1);
+
+		if (text.empty()) continue;
+
+		string full = anchored
+			? JoinGeneric(dir, text)
+			: JoinGeneric(JoinGeneric(dir, "**"), text);
+
+		for (const auto& expanded : Glob::ExpandBraces(full))
+		{
+			rule.pattern = GlobPattern::Compile(expanded);
+			scope->rules.push_back(rule);
+		}
+	}
+
+	return scope;
+}
+
+static bool IsIgnored(
+	const IgnoreScope* scope,
+	string_view genericPath,
+	bool isDir)
+{
+	//the last matching rule of the deepest ignore file decides
+	for (; scope; scope = scope->parent.get())
+	{
+		for (auto it = scope->rules.rbegin(); it != scope->rules.rend(); ++it)
+		{
+			if (it->dirOnly
+				&& !isDir)
+			{
+				continue;
+			}
+
+			if (it->pattern.Matches(genericPath)) return !it->negate;
+		}
+	}
+
+	return false;
+}
+
+namespace KalaMake::Core
+{
+	GlobPattern GlobPattern::Compile(string_view pattern)
+	{
+		GlobPattern result{};
+
+		if (pattern.starts_with('/')) result.root = "/";
+
+		bool inRoot = true;
+
+		size_t start = 0;
+		while (start <= pattern.size())
+		{
+			size_t end = pattern.find('/', start);
+			if (end == string_view::npos) end = pattern.size();
+
+			string_view part = pattern.substr(start, end - start);
+			start = end + 1;
+
+			if (part.empty()
+				|| part == ".")
+			{
+				continue;
+			}
+
+			if (inRoot
+				&& IsLiteralSegment(part))
+			{
+				if (!result.root.empty()
+					&& !result.root.ends_with('/'))
+				{
+					result.root += '/';
+				}
+
+				result.root += part;
+				continue;
+			}
+
+			inRoot = false;
+
+			bool isRecursive = part == "**";
+
+			//'**/**' is the same as '**'
+			if (isRecursive
+				&& !result.segments.empty()
+				&& result.segments.back().isRecursive)
+			{
+				continue;
+			}
+
+			result.segments.push_back(
+				{
+					.text = string(part),
+					.isRecursive = isRecursive,
+					.isLiteral = IsLiteralSegment(part)
+				});
+		}
+
+		result.literal = result.segments.empty();
+
+		return result;
+	}
+
+	bool GlobPattern::Matches(string_view genericPath) const
+	{
+		if (!genericPath.starts_with(root)) return false;
+
+		string_view rest = genericPath.substr(root.size());
+		if (!rest.empty())
+		{
+			if (rest.front() != '/'
+				&& !root.ends_with('/'))
+			{
+				return false;
+			}
+
+			if (rest.front() == '/') rest.remove_prefix(1);
+		}
+
+		vector<u16> states{};
+		vector<u16> next{};
+
+		Start(states);
+
+		size_t start = 0;
+		while (start < rest.size())
+		{
+			size_t end = rest.find('/', start);
+			if (end == string_view::npos) end = rest.size();
+
+			string_view part = rest.substr(start, end - start);
+			start = end + 1;
+
+			if (part.empty()) continue;
+
+			Step(states, part, next);
+			states.swap(next);
+
+			if (states.empty()) return false;
+		}
+
+		return IsMatch(states);
+	}
+
+	void GlobPattern::Start(vector<u16>& outStates) const
+	{
+		outStates.clear();
+		outStates.push_back(0);
+
+		Close(outStates);
+	}
+
+	void GlobPattern::Step(
+		const vector<u16>& states,
+		string_view name,
+		vector<u16>& outStates) const
+	{
+		outStates.clear();
+
+		for (u16 s : states)
+		{
+			if (s >= segments.size()) continue;
+
+			const Segment& segment = segments[s];
+
+			if (segment.isRecursive) AddState(outStates, s);
+			else if (segment.isLiteral
+				? segment.text == name
+				: MatchSegment(segment.text, name))
+			{
+				AddState(outStates, scast<u16>(s + 1));
+			}
+		}
+
+		Close(outStates);
+	}
+
+	bool GlobPattern::IsMatch(const vector<u16>& states) const
+	{
+		return find(states.begin(), states.end(), scast<u16>(segments.size())) != states.end();
+	}
+
+	bool GlobPattern::CanContinue(const vector<u16>& states) const
+	{
+		for (u16 s : states)
+		{
+			if (s < segments.size()) return true;
+		}
+
+		return false;
+	}
+
+	void GlobPattern::Close(vector<u16>& states) const
+	{
+		//'**' can also match zero segments
+		for (size_t i = 0; i < states.size(); ++i)
+		{
+			u16 s = states[i];
+
+			if (s < segments.size()
+				&& segments[s].isRecursive)
+			{
+				AddState(states, scast<u16>(s + 1));
+			}
+		}
+	}
+
+	void GlobSet::Add(string_view pattern)
+	{
+		for (auto& expanded : Glob::ExpandBraces(pattern))
+		{
+			while (expanded.size() > 1
+				&& expanded.ends_with('/'))
+			{
+				expanded.pop_back();
+			}
+
+			if (!Glob::HasWildcards(expanded)) exactPaths.insert(std::move(expanded));
+			else patterns.push_back(GlobPattern::Compile(expanded));
+		}
+	}
+
+	bool GlobSet::Matches(string_view genericPath) const
+	{
+		if (IsEmpty()) return false;
+
+		if (exactPaths.contains(string(genericPath))) return true;
+
+		for (const auto& p : patterns)
+		{
+			if (p.Matches(genericPath)) return true;
+		}
+
+		return false;
+	}
+
+	bool GlobSet::MatchesAnyParent(string_view genericPath) const
+	{
+		if (IsEmpty()) return false;
+
+		string_view current = genericPath;
+
+		while (!current.empty())
+		{
+			if (Matches(current)) return true;
+
+			size_t pos = current.find_last_of('/');
+			if (pos == string_view::npos
+				|| pos == 0)
+			{
+				break;
+			}
+
+			current = current.substr(0, pos);
+		}
+
+		return false;
+	}
+
+	void GlobSet::Clear()
+	{
+		exactPaths.clear();
+		patterns.clear();
+	}
+
+	vector<string> Glob::ExpandBraces(string_view pattern)
+	{
+		size_t open = pattern.find('{');
+		if (open == string_view::npos) return { string(pattern) };
+
+		//find the matching close brace and the top level commas inside it
+		vector<size_t> commas{};
+		size_t close = string_view::npos;
+		size_t depth = 0;
+
+		for (size_t i = open; i < pattern.size(); ++i)
+		{
+			char c = pattern[i];
+
+			if (c == '{') ++depth;
+			else if (c == '}')
+			{
+				if (--depth == 0)
+				{
+					close = i;
+					break;
+				}
+			}
+			else if (c == ','
+				&& depth == 1)
+			{
+				commas.push_back(i);
+			}
+		}
+
+		//unbalanced braces are literal
+		if (close == string_view::npos) return { string(pattern) };
+
+		string_view prefix = pattern.substr(0, open);
+		string_view suffix = pattern.substr(close + 1);
+
+		vector<string> result{};
+
+		size_t altStart = open + 1;
+		commas.push_back(close);
+
+		for (size_t comma : commas)
+		{
+			string combined(prefix);
+			combined += pattern.substr(altStart, comma - altStart);
+			combined += suffix;
+
+			//the alternative or the suffix may have more braces
+			for (auto& expanded : ExpandBraces(combined)) result.push_back(std::move(expanded));
+
+			altStart = comma + 1;
+		}
+
+		return result;
+	}
+
+	bool Glob::HasWildcards(string_view value)
+	{
+		return value.find_first_of("*?[{") != string_view::npos;
+	}
+
+	void Glob::Resolve(
+		string_view pattern,
+		GlobTarget target,
+		const GlobSet& exclusions,
+		vector<path>& outPaths,
+		vector<path>* outVisited)
+	{
+		struct PendingDir
+		{
+			string dir{};
+			vector<u16> states{};
+			shared_ptr<const IgnoreScope> scope{};
+		};
+
+		string ignoreFile(ignore_file_name);
+
+		for (const auto& expanded : ExpandBraces(pattern))
+		{
+			GlobPattern compiled = GlobPattern::Compile(expanded);
+			const string& root = compiled.GetRoot();
+
+			error_code ec{};
+
+			if (compiled.IsLiteral())
+			{
+				bool isDir = is_directory(root, ec);
+				bool wanted = target == GlobTarget::G_DIRS
+					? isDir
+					: (!isDir && exists(root, ec));
+
+				if (wanted
+					&& !exclusions.MatchesAnyParent(root))
+				{
+					outPaths.emplace_back(root);
+				}
+
+				continue;
+			}
+
+			if (!is_directory(root, ec)
+				|| exclusions.MatchesAnyParent(root))
+			{
+				continue;
+			}
+
+			PendingDir first{ .dir = root };
+			compiled.Start(first.states);
+
+			if (target == GlobTarget::G_DIRS
+				&& compiled.IsMatch(first.states))
+			{
+				outPaths.emplace_back(root);
+			}
+
+			size_t firstResult = outPaths.size();
+
+			//walked one depth at a time so every dir of a level is listed in parallel
+			vector<PendingDir> level{};
+			level.push_back(std::move(first));
+
+			vector<PendingDir> nextLevel{};
+			vector<path> levelDirs{};
+			vector<const DirListing*> listings{};
+			vector<u16> next{};
+
+			while (!level.empty())
+			{
+				levelDirs.clear();
+				for (const auto& p : level) levelDirs.emplace_back(p.dir);
+
+				DirCache::ListMany(levelDirs, listings);
+
+				nextLevel.clear();
+
+				for (size_t i = 0; i < level.size(); ++i)
+				{
+					PendingDir& current = level[i];
+					const DirListing& listing = *listings[i];
+
+					if (outVisited) outVisited->emplace_back(current.dir);
+
+					shared_ptr<const IgnoreScope> scope = current.scope;
+
+					if (binary_search(
+						listing.files.begin(),
+						listing.files.end(),
+						ignoreFile))
+					{
+						string file = JoinGeneric(current.dir, ignoreFile);
+						scope = ReadIgnoreFile(current.dir, file, scope);
+
+						if (outVisited) outVisited->emplace_back(file);
+					}
+
+					if (target == GlobTarget::G_FILES)
+					{
+						for (const auto& f : listing.files)
+						{
+							if (f == ignoreFile) continue;
+
+							compiled.Step(current.states, f, next);
+							if (!compiled.IsMatch(next)) continue;
+
+							string full = JoinGeneric(current.dir, f);
+
+							if (exclusions.Matches(full)
+								|| IsIgnored(scope.get(), full, false))
+							{
+								continue;
+							}
+
+							outPaths.emplace_back(std::move(full));
+						}
+					}
+
+					for (const auto& d : listing.dirs)
+					{
+						compiled.Step(current.states, d, next);
+
+						//nothing below this dir can match, skip the whole subtree
+						if (next.empty()) continue;
+
+						string full = JoinGeneric(current.dir, d);
+
+						if (exclusions.Matches(full)
+							|| IsIgnored(scope.get(), full, true))
+						{
+							continue;
+						}
+
+						if (target == GlobTarget::G_DIRS
+							&& compiled.IsMatch(next))
+						{
+							outPaths.emplace_back(full);
+						}
+
+						if (compiled.CanContinue(next))
+						{
+							nextLevel.push_back(
+								{
+									.dir = std::move(full),
+									.states = next,
+									.scope = scope
+								});
+						}
+					}
+				}
+
+				level.swap(nextLevel);
+			}
+
+			//sorted so the results do not depend on the walk order
+			sort(outPaths.begin() + firstResult, outPaths.end());
+		}
+	}
+
+	void Glob::WalkFiles(
+		const path& root,
+		const GlobSet& exclusions,
+		vector<path>& outFiles,
+		vector<path>* outVisited)
+	{
+		Resolve(
+			JoinGeneric(root.lexically_normal().generic_string(), "**"),
+			GlobTarget::G_FILES,
+			exclusions,
+			outFiles,
+			outVisited);
+	}
+}
@@ -0,0 +1,650 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+
+#include "log_utils.hpp"
+#include "file_utils.hpp"
+
+#include "core/kma_jobs.hpp"
+#include "core/kma_context.hpp"
+
+using KalaHeaders::KalaLog::Log;
+using KalaHeaders::KalaLog::LogType;
+
+using KalaHeaders::KalaFile::ReadLinesFromFile;
+using KalaHeaders::KalaFile::CreateNewFile;
+using KalaHeaders::KalaFile::FileType;
+
+using KalaMake::Core::JobPool;
+using KalaMake::Core::JobUsage;
+using KalaMake::Core::SessionContext;
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::unordered_map;
+using std::unordered_set;
+using std::from_chars;
+using std::clamp;
+using std::min;
+using std::size;
+using std::sort;
+using std::ifstream;
+using std::getline;
+using std::ostringstream;
+using std::to_string;
+using std::mutex;
+using std::unique_lock;
+using std::lock_guard;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::filesystem::path;
+
+using u16 = uint16_t;
+using u64 = uint64_t;
+
+//values stored before the name on each line of the usage file
+constexpr size_t usage_counter_count = 10;
+
+//how many of the most expensive jobs the summary lists
+constexpr size_t summary_job_count = 5;
+
+//Waits for a free slot of the session bound to the calling thread and takes it
+static void AcquireSlot();
+
+//Gives the slot back to the next waiting job of the same session
+static void ReleaseSlot();
+
+//Runs the command through the shell like system does and fills the counters of outUsage,
+//the child only runs on pinnedCpus if it is set
+static int RunMeasured(
+	const string& command,
+	JobUsage& outUsage,
+	const void* pinnedCpus);
+
+#ifdef __linux__
+//First line of a sysfs or procfs file, empty if it cannot be read
+static string ReadFirstLine(const string& filePath);
+
+//Cpu numbers of a list like '0-3,8,10-11'
+static vector<int> ParseCpuList(string_view list);
+
+//Rounded up cpu.max quota of the cgroup of this process and its parents, 0 if none is set
+static u64 GetCgroupCpuLimit();
+
+//Allowed cpus of the fastest core type, nullptr if every allowed cpu is of the same type
+static const cpu_set_t* GetPerformanceCpus();
+#endif
+
+//Seconds with two decimals
+static string FormatMicros(u64 micros);
+
+//Bytes in the largest unit that keeps the value above one
+static string FormatBytes(u64 bytes);
+
+namespace KalaMake::Core
+{
+	void JobPool::SetCapacity(u16 newCapacity)
+	{
+		SessionContext& context = SessionContext::Current();
+
+		lock_guard<mutex> lock(context.m_jobs);
+		context.jobCapacity = newCapacity;
+
+		context.slotFreed.notify_all();
+	}
+
+	u16 JobPool::GetCapacity()
+	{
+		SessionContext& context = SessionContext::Current();
+
+		lock_guard<mutex> lock(context.m_jobs);
+		return context.jobCapacity;
+	}
+
+	u16 JobPool::GetDefaultJobCount()
+	{
+		static const u16 jobCount = []() -> u16
+			{
+				u64 count{};
+
+#if defined(_WIN32)
+				DWORD length{};
+				GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &length);
+
+				vector<char> buffer(length);
+				if (GetLogicalProcessorInformationEx(
+					RelationProcessorCore,
+					reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data()),
+					&length))
+				{
+					for (DWORD offset = 0; offset < length; ++count)
+					{
+						offset += reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset)->Size;
+					}
+				}
+
+				if (count == 0) count = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#elif defined(__APPLE__)
+				int physical{};
+				size_t size = sizeof(physical);
+
+				if (sysctlbyname("hw.physicalcpu", &physical, &size, nullptr, 0) == 0) count = scast<u64>(physical);
+				else count = scast<u64>(sysconf(_SC_NPROCESSORS_ONLN));
+#elif defined(__linux__)
+				//smt siblings share one core, which counts once however many of its threads are allowed
+				cpu_set_t allowed{};
+				if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+				{
+					unordered_set<string> cores{};
+					for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+					{
+						if (!CPU_ISSET(cpu, &allowed)) continue;
+
+						string topology = "/sys/devices/system/cpu/cpu" + to_string(cpu) + "/topology/";
+
+						string siblings = ReadFirstLine(topology + "core_cpus_list");
+						if (siblings.empty()) siblings = ReadFirstLine(topology + "thread_siblings_list");
+						if (siblings.empty()) siblings = to_string(cpu);
+
+						cores.insert(siblings);
+					}
+
+					count = cores.size();
+				}
+				else count = scast<u64>(sysconf(_SC_NPROCESSORS_ONLN));
+
+				u64 limit = GetCgroupCpuLimit();
+				if (limit != 0) count = min(count, limit);
+#else
+				count = scast<u64>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+
+				return scast<u16>(clamp<u64>(count, 1, UINT16_MAX));
+			}();
+
+		return jobCount;
+	}
+
+	int JobPool::Run(const string& command)
+	{
+		AcquireSlot();
+
+		int result = system(command.c_str());
+
+		ReleaseSlot();
+
+		return result;
+	}
+
+	int JobPool::Run(
+		const string& command,
+		JobUsage& outUsage,
+		bool pinToPerformanceCores)
+	{
+		const void* pinnedCpus{};
+
+#ifdef __linux__
+		if (pinToPerformanceCores) pinnedCpus = GetPerformanceCpus();
+#endif
+
+		AcquireSlot();
+
+		auto start = steady_clock::now();
+
+		int result = RunMeasured(
+			command,
+			outUsage,
+			pinnedCpus);
+
+		outUsage.wallMicros = scast<u64>(duration_cast<microseconds>(steady_clock::now() - start).count());
+
+		ReleaseSlot();
+
+		return result;
+	}
+
+	path JobPool::GetUsagePath(
+		const path& buildPath,
+		string_view profile)
+	{
+		return buildPath / ("kalamake-" + string(profile) + ".usage");
+	}
+
+	string JobPool::SaveUsage(
+		const path& usagePath,
+		const vector<JobUsage>& jobs)
+	{
+		//each line is 'wall|user|system|rss|voluntary|involuntary|blockreads|blockwrites|reads|writes|name',
+		//the name is last because it is the only value that can contain '|'
+		vector<string> lines{};
+		if (exists(usagePath)) ReadLinesFromFile(usagePath, lines);
+
+		unordered_map<string, size_t> newJobs{};
+		for (size_t i = 0; i < jobs.size(); ++i) newJobs[jobs[i].name] = i;
+
+		ostringstream out{};
+
+		for (const auto& l : lines)
+		{
+			//the name starts after the separator of the last counter
+			size_t split = string::npos;
+			size_t from = 0;
+			for (size_t i = 0; i < usage_counter_count; ++i)
+			{
+				split = l.find('|', from);
+				if (split == string::npos) break;
+
+				from = split + 1;
+			}
+
+			if (split == string::npos
+				|| newJobs.contains(l.substr(split + 1)))
+			{
+				continue;
+			}
+
+			out << l << "\n";
+		}
+
+		for (const auto& j : jobs)
+		{
+			out << j.wallMicros
+				<< "|" << j.userMicros
+				<< "|" << j.systemMicros
+				<< "|" << j.peakRssKiB
+				<< "|" << j.voluntarySwitches
+				<< "|" << j.involuntarySwitches
+				<< "|" << j.blockReads
+				<< "|" << j.blockWrites
+				<< "|" << j.readBytes
+				<< "|" << j.writeBytes
+				<< "|" << j.name << "\n";
+		}
+
+		return CreateNewFile(
+			usagePath,
+			FileType::FILE_TEXT,
+			{ .inText = out.str() });
+	}
+
+	string JobPool::Describe(const JobUsage& usage)
+	{
+		return FormatMicros(usage.userMicros) + " user, "
+			+ FormatMicros(usage.systemMicros) + " system, "
+			+ FormatMicros(usage.wallMicros) + " wall, "
+			+ FormatBytes(usage.peakRssKiB * 1024) + " rss, "
+			+ FormatBytes(usage.readBytes) + " read, "
+			+ FormatBytes(usage.writeBytes) + " written";
+	}
+
+	void JobPool::PrintUsage(
+		const vector<JobUsage>& jobs,
+		string_view target)
+	{
+		if (jobs.empty()) return;
+
+		JobUsage total{};
+		const JobUsage* peak = &jobs[0];
+
+		for (const auto& j : jobs)
+		{
+			total.wallMicros          += j.wallMicros;
+			total.userMicros          += j.userMicros;
+			total.systemMicros        += j.systemMicros;
+			total.voluntarySwitches   += j.voluntarySwitches;
+			total.involuntarySwitches += j.involuntarySwitches;
+			total.blockReads          += j.blockReads;
+			total.blockWrites         += j.blockWrites;
+			total.readBytes           += j.readBytes;
+			total.writeBytes          += j.writeBytes;
+
+			if (j.peakRssKiB > peak->peakRssKiB) peak = &j;
+		}
+
+		Log::Print(
+			"Resource use of '" + to_string(jobs.size()) + "' jobs: "
+			+ FormatMicros(total.userMicros) + " user, "
+			+ FormatMicros(total.systemMicros) + " system, "
+			+ FormatMicros(total.wallMicros) + " wall, peak rss "
+			+ FormatBytes(peak->peakRssKiB * 1024) + " in '" + path(peak->name).filename().string() + "', "
+			+ FormatBytes(total.readBytes) + " read, "
+			+ FormatBytes(total.writeBytes) + " written, "
+			+ to_string(total.blockReads) + "/" + to_string(total.blockWrites) + " disk blocks, "
+			+ to_string(total.voluntarySwitches) + "/" + to_string(total.involuntarySwitches) + " voluntary/involuntary switches.",
+			target,
+			LogType::LOG_INFO);
+
+		if (jobs.size() < 2) return;
+
+		vector<const JobUsage*> sorted{};
+		for (const auto& j : jobs) sorted.push_back(&j);
+
+		sort(
+			sorted.begin(),
+			sorted.end(),
+			[](const JobUsage* a, const JobUsage* b)
+			{
+				return a->userMicros + a->systemMicros > b->userMicros + b->systemMicros;
+			});
+
+		string list{};
+		for (size_t i = 0; i < min(sorted.size(), summary_job_count); ++i)
+		{
+			const JobUsage& j = *sorted[i];
+			u64 cpu = j.userMicros + j.systemMicros;
+
+			//a job that spent much less time on the cpu than it took waited on i/o or for a core
+			u64 busy = j.wallMicros == 0
+				? 100
+				: min<u64>(cpu * 100 / j.wallMicros, 100);
+
+			list += "\n    " + path(j.name).filename().string()
+				+ ": " + Describe(j) + " (" + to_string(busy) + "% busy)";
+		}
+
+		Log::Print(
+			"Most expensive jobs by cpu time:" + list,
+			target,
+			LogType::LOG_INFO);
+	}
+}
+
+void AcquireSlot()
+{
+	SessionContext& context = SessionContext::Current();
+
+	unique_lock<mutex> lock(context.m_jobs);
+	context.slotFreed.wait(lock, [&context]()
+		{
+			return context.jobCapacity == 0
+				|| context.runningJobs < context.jobCapacity;
+		});
+
+	++context.runningJobs;
+}
+
+void ReleaseSlot()
+{
+	SessionContext& context = SessionContext::Current();
+
+	{
+		lock_guard<mutex> lock(context.m_jobs);
+		--context.runningJobs;
+	}
+	context.slotFreed.notify_one();
+}
+
+int RunMeasured(
+	const string& command,
+	JobUsage& outUsage,
+	const void* pinnedCpus)
+{
+#ifdef _WIN32
+	return system(command.c_str());
+#else
+	const char* commandText = command.c_str();
+
+	pid_t pid = fork();
+	if (pid < 0) return -1;
+
+	if (pid == 0)
+	{
+#ifdef __linux__
+		//the compiler and linker processes started by the shell inherit the affinity
+		if (pinnedCpus) sched_setaffinity(0, sizeof(cpu_set_t), scast<const cpu_set_t*>(pinnedCpus));
+#endif
+
+		execl("/bin/sh", "sh", "-c", commandText, scast<char*>(nullptr));
+		_exit(127);
+	}
+
+	//the i/o counters of the process are gone once it is reaped,
+	//so it is waited for first and only reaped after they were read.
+	//Systems without /proc leave the byte counts at zero
+	siginfo_t info{};
+	while (waitid(P_PID, scast<id_t>(pid), &info, WEXITED | WNOWAIT) != 0
+		&& errno == EINTR)
+	{
+	}
+
+	ifstream io("/proc/" + to_string(pid) + "/io");
+	string line{};
+	while (getline(io, line))
+	{
+		size_t split = line.find(": ");
+		if (split == string::npos) continue;
+
+		string_view key = string_view(line).substr(0, split);
+
+		u64* target = key == "rchar"
+			? &outUsage.readBytes
+			: key == "wchar"
+			? &outUsage.writeBytes
+			: nullptr;
+
+		if (target) from_chars(line.data() + split + 2, line.data() + line.size(), *target);
+	}
+
+	int status{};
+	rusage usage{};
+	while (wait4(pid, &status, 0, &usage) < 0)
+	{
+		if (errno != EINTR) return -1;
+	}
+
+	outUsage.userMicros          = scast<u64>(usage.ru_utime.tv_sec) * 1000000 + scast<u64>(usage.ru_utime.tv_usec);
+	outUsage.systemMicros        = scast<u64>(usage.ru_stime.tv_sec) * 1000000 + scast<u64>(usage.ru_stime.tv_usec);
+#ifdef __APPLE__
+	//macOS reports bytes instead of KiB
+	outUsage.peakRssKiB          = scast<u64>(usage.ru_maxrss) / 1024;
+#else
+	outUsage.peakRssKiB          = scast<u64>(usage.ru_maxrss);
+#endif
+	outUsage.voluntarySwitches   = scast<u64>(usage.ru_nvcsw);
+	outUsage.involuntarySwitches = scast<u64>(usage.ru_nivcsw);
+	outUsage.blockReads          = scast<u64>(usage.ru_inblock);
+	outUsage.blockWrites         = scast<u64>(usage.ru_oublock);
+
+	return status;
+#endif
+}
+
+string FormatMicros(u64 micros)
+{
+	u64 hundredths = (micros + 5000) / 10000;
+	string fraction = to_string(hundredths % 100);
+	if (fraction.size() < 2) fraction.insert(0, "0");
+
+	return to_string(hundredths / 100) + "." + fraction + "s";
+}
+
+string FormatBytes(u64 bytes)
+{
+	constexpr string_view units[] = { "B", "KiB", "MiB", "GiB" };
+
+	size_t unit = 0;
+	u64 whole = bytes;
+	while (whole >= 1024
+		&& unit + 1 < size(units))
+	{
+		whole /= 1024;
+		++unit;
+	}
+
+	return to_string(whole) + " " + string(units[unit]);
+}
+
+#ifdef __linux__
+string ReadFirstLine(const string& filePath)
+{
+	ifstream file(filePath);
+
+	string line{};
+	getline(file, line);
+
+	return line;
+}
+
+vector<int> ParseCpuList(string_view list)
+{
+	vector<int> cpus{};
+
+	size_t start = 0;
+	while (start < list.size())
+	{
+		size_t end = list.find(',', start);
+		if (end == string_view::npos) end = list.size();
+
+		string_view range = list.substr(start, end - start);
+		size_t dash = range.find('-');
+
+		int first{};
+		int last{};
+		from_chars(range.data(), range.data() + min(dash, range.size()), first);
+
+		if (dash == string_view::npos) last = first;
+		else from_chars(range.data() + dash + 1, range.data() + range.size(), last);
+
+		for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) cpus.push_back(cpu);
+
+		start = end + 1;
+	}
+
+	return cpus;
+}
+
+u64 GetCgroupCpuLimit()
+{
+	//cgroup v2 lists the cgroup of the process as '0::/path'
+	ifstream cgroups("/proc/self/cgroup");
+
+	string cgroup{};
+	string line{};
+	while (getline(cgroups, line))
+	{
+		if (line.starts_with("0::")) cgroup = line.substr(3);
+	}
+
+	if (cgroup.empty()) return 0;
+
+	//a parent quota limits every cgroup below it, so the smallest one counts
+	u64 limit{};
+	path dir = "/sys/fs/cgroup";
+	path relative = path(cgroup).relative_path();
+	if (!relative.empty()) dir /= relative;
+
+	while (true)
+	{
+		//'max 100000' has no quota, '150000 100000' allows one and a half cpus
+		string cpuMax = ReadFirstLine((dir / "cpu.max").string());
+		size_t split = cpuMax.find(' ');
+
+		u64 quota{};
+		u64 period{};
+		if (split != string::npos
+			&& from_chars(cpuMax.data(), cpuMax.data() + split, quota).ec == std::errc{}
+			&& from_chars(cpuMax.data() + split + 1, cpuMax.data() + cpuMax.size(), period).ec == std::errc{}
+			&& period != 0)
+		{
+			u64 cpus = (quota + period - 1) / period;
+			limit = limit == 0 ? cpus : min(limit, cpus);
+		}
+
+		if (dir == "/sys/fs/cgroup"
+			|| !dir.has_relative_path())
+		{
+			break;
+		}
+
+		dir = dir.parent_path();
+	}
+
+	return limit;
+}
+
+const cpu_set_t* GetPerformanceCpus()
+{
+	static const cpu_set_t* performanceCpus = []() -> const cpu_set_t*
+		{
+			static cpu_set_t result{};
+
+			cpu_set_t allowed{};
+			if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return nullptr;
+
+			vector<int> fastest{};
+
+			//intel hybrid cpus list their performance cores directly,
+			//other hybrid cpus such as arm big.LITTLE give the bigger cores a higher capacity
+			string coreCpus = ReadFirstLine("/sys/devices/cpu_core/cpus");
+			if (!coreCpus.empty()) fastest = ParseCpuList(coreCpus);
+			else
+			{
+				u64 highest{};
+				for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+				{
+					if (!CPU_ISSET(cpu, &allowed)) continue;
+
+					string capacityText = ReadFirstLine("/sys/devices/system/cpu/cpu" + to_string(cpu) + "/cpu_capacity");
+
+					u64 capacity{};
+					from_chars(capacityText.data(), capacityText.data() + capacityText.size(), capacity);
+
+					if (capacity > highest)
+					{
+						highest = capacity;
+						fastest.clear();
+					}
+					if (capacity == highest) fastest.push_back(cpu);
+				}
+			}
+
+			CPU_ZERO(&result);
+			for (int cpu : fastest)
+			{
+				if (CPU_ISSET(cpu, &allowed)) CPU_SET(cpu, &result);
+			}
+
+			//nothing to pin to if every allowed cpu is already a performance core, or none of them is
+			int count = CPU_COUNT(&result);
+			if (count == 0
+				|| count == CPU_COUNT(&allowed))
+			{
+				return nullptr;
+			}
+
+			return &result;
+		}();
+
+	return performanceCpus;
+}
+#endif
@@ -0,0 +1,163 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+#include "core_utils.hpp"
+
+#include "core/kma_mapped_file.hpp"
+
+using std::exchange;
+
+namespace KalaMake::Core
+{
+	MappedFile::~MappedFile() { Close(); }
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other) return *this;
+
+		Close();
+
+		data = exchange(other.data, nullptr);
+		size = exchange(other.size, 0);
+#ifdef _WIN32
+		fileHandle = exchange(other.fileHandle, nullptr);
+		mappingHandle = exchange(other.mappingHandle, nullptr);
+#endif
+
+		return *this;
+	}
+
+	string MappedFile::Open(const path& filePath)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileW(
+			filePath.wstring().c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr);
+
+		if (file == INVALID_HANDLE_VALUE) return "Failed to open file for mapping!";
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return "Failed to get file size for mapping!";
+		}
+
+		fileHandle = file;
+
+		//empty files cannot be mapped
+		if (fileSize.QuadPart == 0) return {};
+
+		HANDLE mapping = CreateFileMappingW(
+			file,
+			nullptr,
+			PAGE_READONLY,
+			0,
+			0,
+			nullptr);
+
+		if (!mapping)
+		{
+			Close();
+			return "Failed to create file mapping!";
+		}
+
+		mappingHandle = mapping;
+
+		void* view = MapViewOfFile(
+			mapping,
+			FILE_MAP_READ,
+			0,
+			0,
+			0);
+
+		if (!view)
+		{
+			Close();
+			return "Failed to map view of file!";
+		}
+
+		data = scast<const char*>(view);
+		size = scast<size_t>(fileSize.QuadPart);
+#else
+		int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1) return "Failed to open file for mapping!";
+
+		struct stat st{};
+		if (fstat(fd, &st) != 0)
+		{
+			close(fd);
+			return "Failed to get file size for mapping!";
+		}
+
+		//empty files cannot be mapped
+		if (st.st_size == 0)
+		{
+			close(fd);
+			return {};
+		}
+
+		void* view = mmap(
+			nullptr,
+			scast<size_t>(st.st_size),
+			PROT_READ,
+			MAP_PRIVATE,
+			fd,
+			0);
+
+		//the mapping keeps its own reference to the file
+		close(fd);
+
+		if (view == MAP_FAILED) return "Failed to map file!";
+
+		madvise(view, scast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+		data = scast<const char*>(view);
+		size = scast<size_t>(st.st_size);
+#endif
+
+		return {};
+	}
+
+	void MappedFile::Close()
+	{
+#ifdef _WIN32
+		if (data) UnmapViewOfFile(data);
+		if (mappingHandle) CloseHandle(mappingHandle);
+		if (fileHandle) CloseHandle(fileHandle);
+
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+#else
+		if (data) munmap(const_cast<char*>(data), size);
+#endif
+
+		data = nullptr;
+		size = 0;
+	}
+}
@@ -0,0 +1,67 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+
+#include "core_utils.hpp"
+
+#include "core/kma_schema.hpp"
+
+using KalaHeaders::KalaCore::ContainsValue;
+
+using KalaMake::Core::Schema;
+using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::ProfileData;
+using KalaMake::Core::field_schema;
+using KalaMake::Core::custom_flag_values;
+using KalaMake::Core::CustomFlag;
+
+using std::string;
+using std::string_view;
+
+using u8 = uint8_t;
+
+namespace KalaMake::Core
+{
+	void Schema::CheckLanguage(
+		const ProfileData& profile,
+		u8 language,
+		string_view languageName,
+		string_view target)
+	{
+		for (const auto& f : field_schema)
+		{
+			if ((f.requiredIn & language)
+				&& !f.isSet(profile))
+			{
+				KalaMakeCore::CloseOnError(
+					target,
+					"Field '" + string(f.name) + "' must be assigned in " + string(languageName) + "!");
+			}
+		}
+
+		for (const auto& f : field_schema)
+		{
+			if (!(f.supportedIn & language)
+				&& f.isSet(profile))
+			{
+				KalaMakeCore::CloseOnError(
+					target,
+					"Field '" + string(f.name) + "' is not supported in " + string(languageName) + "!");
+			}
+		}
+
+		for (const auto& c : custom_flag_values)
+		{
+			if (!(c.supportedIn & language)
+				&& ContainsValue(profile.customFlags, scast<CustomFlag>(c.value)))
+			{
+				KalaMakeCore::CloseOnError(
+					target,
+					"Custom flag '" + string(c.name) + "' is not supported in " + string(languageName) + "!");
+			}
+		}
+	}
+}
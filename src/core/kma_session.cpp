@@ -0,0 +1,71 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <exception>
+
+#include "core/kma_session.hpp"
+
+using KalaMake::Core::BuildSession;
+using KalaMake::Core::BuildResult;
+using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::KalaMakeError;
+using KalaMake::Core::StartType;
+
+using std::string;
+using std::vector;
+using std::mutex;
+using std::lock_guard;
+using std::exception;
+
+namespace KalaMake::Core
+{
+	BuildResult BuildSession::Validate() { return Run(StartType::S_VALIDATE); }
+	BuildResult BuildSession::Compile() { return Run(StartType::S_COMPILE); }
+	BuildResult BuildSession::Check() { return Run(StartType::S_CHECK); }
+	BuildResult BuildSession::Clean() { return Run(StartType::S_CLEAN); }
+
+	BuildResult BuildSession::Run(StartType type)
+	{
+		lock_guard<mutex> lock(m_calls);
+
+		vector<string> params{};
+
+		switch (type)
+		{
+		case StartType::S_VALIDATE:
+			params = { "validate", projectFile.string(), profile };
+			break;
+		case StartType::S_COMPILE:
+			params = { "compile", projectFile.string(), profile };
+			break;
+		case StartType::S_CHECK:
+			params = { "check", projectFile.string(), profile };
+			break;
+		default:
+			params = { "clean", projectFile.string() };
+			break;
+		}
+
+		try
+		{
+			KalaMakeCore::OpenFile(context, type, params);
+		}
+		catch (const KalaMakeError& e)
+		{
+			return { .success = false, .error = { e.GetTarget(), e.what() } };
+		}
+		catch (const exception& e)
+		{
+			return { .success = false, .error = { "KALAMAKE", e.what() } };
+		}
+
+		if (type != StartType::S_CLEAN) data = context.globalData;
+
+		return { .success = true };
+	}
+}
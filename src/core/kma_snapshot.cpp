@@ -0,0 +1,596 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <unordered_map>
+
+#include "core_utils.hpp"
+
+#include "core/kma_snapshot.hpp"
+#include "core/kma_mapped_file.hpp"
+#include "core/kma_walk.hpp"
+#include "core/kma_schema.hpp"
+#include "core/kma_context.hpp"
+
+using KalaMake::Core::Snapshot;
+using KalaMake::Core::DirCache;
+using KalaMake::Core::DirListing;
+using KalaMake::Core::MappedFile;
+using KalaMake::Core::Walker;
+using KalaMake::Core::GlobalData;
+using KalaMake::Core::ProfileData;
+using KalaMake::Core::ReferenceData;
+using KalaMake::Core::ReferenceState;
+using KalaMake::Core::field_schema;
+using KalaMake::Core::SessionContext;
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::filesystem::path;
+using std::filesystem::directory_iterator;
+using std::filesystem::directory_options;
+using std::filesystem::file_time_type;
+using std::unordered_map;
+using std::sort;
+using std::ofstream;
+using std::ifstream;
+using std::ios;
+using std::streamsize;
+using std::error_code;
+using std::filesystem::last_write_time;
+using std::filesystem::rename;
+using std::filesystem::remove;
+
+using u8 = uint8_t;
+using u32 = uint32_t;
+using u64 = uint64_t;
+using i64 = int64_t;
+
+constexpr string_view snapshot_magic = "KMSNAP";
+constexpr string_view dir_cache_magic = "KMDIRS";
+
+//bump whenever GlobalData or the layout below changes
+constexpr u32 snapshot_format_version = 6;
+constexpr u32 dir_cache_format_version = 1;
+
+//a listing taken within this many seconds of the directory changing
+//could miss a change made in the same timestamp tick, so it is never trusted later
+constexpr i64 dir_cache_settle_seconds = 2;
+
+//time stored for listings that must be read again next time
+constexpr i64 dir_cache_untrusted = -2;
+
+//
+// WRITE
+//
+
+static void WriteBytes(string& out, const void* data, size_t size)
+{
+	out.append(scast<const char*>(data), size);
+}
+
+template<typename T>
+static void WriteValue(string& out, T value)
+{
+	WriteBytes(out, &value, sizeof(T));
+}
+
+static void WriteString(string& out, string_view value)
+{
+	WriteValue<u64>(out, value.size());
+	WriteBytes(out, value.data(), value.size());
+}
+
+static void WriteStrings(string& out, const vector<string>& values)
+{
+	WriteValue<u64>(out, values.size());
+	for (const auto& v : values) WriteString(out, v);
+}
+
+//Every field is stored as the same text values it is parsed from,
+//in schema order so a new field only needs its schema row
+static void WriteProfile(string& out, const ProfileData& p)
+{
+	WriteString(out, p.profileName);
+
+	vector<string> values{};
+	for (const auto& f : field_schema)
+	{
+		values.clear();
+		f.collect(p, f, values);
+
+		WriteStrings(out, values);
+	}
+}
+
+//
+// READ
+//
+
+//Reads values in the order they were written,
+//any read past the end marks the whole snapshot as invalid
+struct SnapshotReader
+{
+	string_view data{};
+	size_t offset{};
+	bool failed{};
+
+	bool ReadBytes(void* out, size_t size)
+	{
+		if (failed
+			|| data.size() - offset < size)
+		{
+			failed = true;
+			return false;
+		}
+
+		memcpy(out, data.data() + offset, size);
+		offset += size;
+
+		return true;
+	}
+
+	template<typename T>
+	T ReadValue()
+	{
+		T value{};
+		ReadBytes(&value, sizeof(T));
+		return value;
+	}
+
+	template<typename E>
+	E ReadEnum() { return scast<E>(ReadValue<u8>()); }
+
+	string ReadString()
+	{
+		u64 size = ReadValue<u64>();
+		if (failed
+			|| data.size() - offset < size)
+		{
+			failed = true;
+			return {};
+		}
+
+		string value(data.substr(offset, size));
+		offset += size;
+
+		return value;
+	}
+
+	vector<string> ReadStrings()
+	{
+		u64 count = ReadValue<u64>();
+
+		vector<string> values{};
+		for (u64 i = 0; i < count && !failed; ++i) values.push_back(ReadString());
+
+		return values;
+	}
+};
+
+static void ReadProfile(SnapshotReader& in, ProfileData& p)
+{
+	p.profileName = in.ReadString();
+
+	for (const auto& f : field_schema)
+	{
+		vector<string> values = in.ReadStrings();
+		if (in.failed) return;
+
+		if (!values.empty()) f.assign(p, f, values);
+	}
+}
+
+//Missing paths return -1 so they still compare equal if they stay missing
+static i64 GetWriteTime(const path& target)
+{
+	error_code ec{};
+
+	auto time = last_write_time(target, ec);
+	if (ec) return -1;
+
+	return scast<i64>(time.time_since_epoch().count());
+}
+
+static bool IsSettled(i64 time)
+{
+	if (time < 0) return false;
+
+	i64 now = scast<i64>(file_time_type::clock::now().time_since_epoch().count());
+	i64 settle = scast<i64>(std::chrono::duration_cast<file_time_type::duration>(
+		std::chrono::seconds(dir_cache_settle_seconds)).count());
+
+	return now - time > settle;
+}
+
+static bool IsCurrent(
+	const DirListing& listing,
+	i64 time)
+{
+	return listing.time == time
+		&& time != dir_cache_untrusted;
+}
+
+//Sorted listing of dir, only touches its arguments so it can run on any thread
+static DirListing ReadListing(
+	const path& dir,
+	i64 time)
+{
+	DirListing listing{};
+
+	error_code ec{};
+	for (auto e = directory_iterator(dir, directory_options::skip_permission_denied, ec);
+		!ec && e != directory_iterator();
+		e.increment(ec))
+	{
+		error_code typeEc{};
+
+		if (e->is_symlink(typeEc))
+		{
+			//symlinked files are sources too, symlinked dirs are not walked
+			if (e->is_regular_file(typeEc)) listing.files.push_back(e->path().filename().string());
+		}
+		else if (e->is_directory(typeEc)) listing.dirs.push_back(e->path().filename().string());
+		else if (e->is_regular_file(typeEc)) listing.files.push_back(e->path().filename().string());
+	}
+
+	sort(listing.files.begin(), listing.files.end());
+	sort(listing.dirs.begin(), listing.dirs.end());
+
+	listing.time = IsSettled(time) ? time : dir_cache_untrusted;
+
+	return listing;
+}
+
+//Writes next to the target and swaps it in
+//so an interrupted save never leaves a half-written cache file
+static string WriteCacheFile(
+	const path& target,
+	const string& content)
+{
+	path tempPath = target;
+	tempPath += ".tmp";
+
+	{
+		ofstream file(tempPath, ios::binary | ios::trunc);
+		if (!file) return "Failed to open '" + tempPath.string() + "' for writing!";
+
+		file.write(content.data(), scast<std::streamsize>(content.size()));
+		if (!file) return "Failed to write to '" + tempPath.string() + "'!";
+	}
+
+	error_code ec{};
+	rename(tempPath, target, ec);
+	if (ec)
+	{
+		remove(tempPath, ec);
+		return "Failed to replace '" + target.string() + "'!";
+	}
+
+	return {};
+}
+
+namespace KalaMake::Core
+{
+	u64 Snapshot::GetKey(
+		string_view content,
+		const path& projectFile,
+		string_view profile)
+	{
+		//64-bit FNV-1a
+		u64 hash = 14695981039346656037ull;
+
+		auto add = [&hash](string_view value)
+			{
+				for (char c : value)
+				{
+					hash ^= scast<u8>(c);
+					hash *= 1099511628211ull;
+				}
+
+				//separator so 'ab' + 'c' and 'a' + 'bc' differ
+				hash ^= 0xFFu;
+				hash *= 1099511628211ull;
+			};
+
+		add(content);
+		add(projectFile.string());
+		add(profile);
+
+		return hash;
+	}
+
+	u64 Snapshot::HashFile(const path& target)
+	{
+		ifstream in(target, ios::binary);
+		if (!in) return 0;
+
+		u64 hash = 14695981039346656037ull;
+
+		char buffer[65536];
+		while (in.read(buffer, sizeof(buffer))
+			|| in.gcount() > 0)
+		{
+			streamsize count = in.gcount();
+			for (streamsize i = 0; i < count; ++i)
+			{
+				hash ^= scast<u8>(buffer[i]);
+				hash *= 1099511628211ull;
+			}
+		}
+
+		return hash;
+	}
+
+	path Snapshot::GetPath(
+		const path& buildPath,
+		string_view profile)
+	{
+		return buildPath / ("kalamake-" + string(profile) + ".snapshot");
+	}
+
+	bool Snapshot::Load(
+		const path& snapshotPath,
+		u64 key,
+		GlobalData& outData)
+	{
+		MappedFile file{};
+		if (!file.Open(snapshotPath).empty()) return false;
+
+		SnapshotReader in{ .data = file.GetView() };
+
+		char magic[snapshot_magic.size()]{};
+		in.ReadBytes(magic, sizeof(magic));
+
+		if (in.failed
+			|| string_view(magic, sizeof(magic)) != snapshot_magic
+			|| in.ReadValue<u32>() != snapshot_format_version
+			|| in.ReadValue<u64>() != key)
+		{
+			return false;
+		}
+
+		//every directory and ignore file that was read must still look the same,
+		//otherwise a source or header could have been added, removed or ignored
+		u64 dirCount = in.ReadValue<u64>();
+		for (u64 i = 0; i < dirCount && !in.failed; ++i)
+		{
+			path dir = in.ReadString();
+			i64 time = in.ReadValue<i64>();
+
+			if (in.failed
+				|| GetWriteTime(dir) != time)
+			{
+				return false;
+			}
+		}
+
+		GlobalData data{};
+
+		data.projectFile = in.ReadString();
+		ReadProfile(in, data.targetProfile);
+
+		u64 refCount = in.ReadValue<u64>();
+		for (u64 i = 0; i < refCount && !in.failed; ++i)
+		{
+			ReferenceData ref{};
+			ref.name          = in.ReadString();
+			ref.value         = in.ReadString();
+			ref.expandedValue = in.ReadString();
+			ref.state         = in.ReadEnum<ReferenceState>();
+
+			string name = ref.name;
+			data.references.emplace(std::move(name), std::move(ref));
+		}
+
+		if (in.failed
+			|| in.offset != in.data.size())
+		{
+			return false;
+		}
+
+		outData = std::move(data);
+		return true;
+	}
+
+	string Snapshot::Save(
+		const path& snapshotPath,
+		u64 key,
+		const GlobalData& data,
+		const vector<path>& traversedPaths)
+	{
+		string out{};
+
+		WriteBytes(out, snapshot_magic.data(), snapshot_magic.size());
+		WriteValue<u32>(out, snapshot_format_version);
+		WriteValue<u64>(out, key);
+
+		WriteValue<u64>(out, traversedPaths.size());
+		for (const auto& d : traversedPaths)
+		{
+			WriteString(out, d.string());
+			WriteValue<i64>(out, GetWriteTime(d));
+		}
+
+		WriteString(out, data.projectFile.string());
+		WriteProfile(out, data.targetProfile);
+
+		WriteValue<u64>(out, data.references.size());
+		for (const auto& [_, ref] : data.references)
+		{
+			WriteString(out, ref.name);
+			WriteString(out, ref.value);
+			WriteString(out, ref.expandedValue);
+			WriteValue<u8>(out, scast<u8>(ref.state));
+		}
+
+		return WriteCacheFile(snapshotPath, out);
+	}
+
+	path DirCache::GetPath(const path& buildPath)
+	{
+		return buildPath / "kalamake-dirs.cache";
+	}
+
+	void DirCache::Load(const path& cachePath)
+	{
+		Clear();
+
+		MappedFile file{};
+		if (!file.Open(cachePath).empty()) return;
+
+		SnapshotReader in{ .data = file.GetView() };
+
+		char magic[dir_cache_magic.size()]{};
+		in.ReadBytes(magic, sizeof(magic));
+
+		if (in.failed
+			|| string_view(magic, sizeof(magic)) != dir_cache_magic
+			|| in.ReadValue<u32>() != dir_cache_format_version)
+		{
+			return;
+		}
+
+		unordered_map<string, DirListing> listings{};
+
+		u64 count = in.ReadValue<u64>();
+		listings.reserve(scast<size_t>(count));
+
+		for (u64 i = 0; i < count && !in.failed; ++i)
+		{
+			string dir = in.ReadString();
+
+			DirListing listing{};
+			listing.time  = in.ReadValue<i64>();
+			listing.files = in.ReadStrings();
+			listing.dirs  = in.ReadStrings();
+
+			listings.emplace(std::move(dir), std::move(listing));
+		}
+
+		if (in.failed
+			|| in.offset != in.data.size())
+		{
+			return;
+		}
+
+		SessionContext::Current().dirListings = std::move(listings);
+	}
+
+	string DirCache::Save(const path& cachePath)
+	{
+		SessionContext& context = SessionContext::Current();
+
+		if (!context.dirListingsChanged) return {};
+
+		string out{};
+
+		WriteBytes(out, dir_cache_magic.data(), dir_cache_magic.size());
+		WriteValue<u32>(out, dir_cache_format_version);
+
+		WriteValue<u64>(out, context.dirListings.size());
+		for (const auto& [dir, listing] : context.dirListings)
+		{
+			WriteString(out, dir);
+			WriteValue<i64>(out, listing.time);
+			WriteStrings(out, listing.files);
+			WriteStrings(out, listing.dirs);
+		}
+
+		string result = WriteCacheFile(cachePath, out);
+		if (result.empty()) context.dirListingsChanged = false;
+
+		return result;
+	}
+
+	void DirCache::Clear()
+	{
+		SessionContext& context = SessionContext::Current();
+
+		context.dirListings.clear();
+		context.dirListingsChanged = false;
+	}
+
+	const DirListing& DirCache::List(const path& dir)
+	{
+		SessionContext& context = SessionContext::Current();
+
+		string key = dir.lexically_normal().string();
+		i64 time = GetWriteTime(dir);
+
+		auto it = context.dirListings.find(key);
+		if (it != context.dirListings.end()
+			&& IsCurrent(it->second, time))
+		{
+			return it->second;
+		}
+
+		DirListing listing = ReadListing(dir, time);
+
+		context.dirListingsChanged = true;
+
+		if (it != context.dirListings.end())
+		{
+			it->second = std::move(listing);
+			return it->second;
+		}
+
+		return context.dirListings.emplace(std::move(key), std::move(listing)).first->second;
+	}
+
+	void DirCache::ListMany(
+		const vector<path>& dirs,
+		vector<const DirListing*>& outListings)
+	{
+		SessionContext& context = SessionContext::Current();
+
+		size_t count = dirs.size();
+
+		vector<string> keys(count);
+		vector<DirListing> listings(count);
+
+		//u8 instead of bool so every thread writes its own byte
+		vector<u8> isOutdated(count);
+
+		//the map is only read while the workers run
+		Walker::ForEach(
+			count,
+			[&context, &dirs, &keys, &listings, &isOutdated](size_t i)
+			{
+				keys[i] = dirs[i].lexically_normal().string();
+				i64 time = GetWriteTime(dirs[i]);
+
+				auto it = context.dirListings.find(keys[i]);
+				if (it != context.dirListings.end()
+					&& IsCurrent(it->second, time))
+				{
+					return;
+				}
+
+				listings[i] = ReadListing(dirs[i], time);
+				isOutdated[i] = 1;
+			});
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!isOutdated[i]) continue;
+
+			context.dirListings.insert_or_assign(keys[i], std::move(listings[i]));
+			context.dirListingsChanged = true;
+		}
+
+		//looked up only after every insert so a dir listed twice never points to a replaced entry
+		outListings.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			outListings[i] = &context.dirListings.find(keys[i])->second;
+		}
+	}
+}
@@ -0,0 +1,171 @@
+//Copyright(C) 2026 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <mutex>
+
+#include "core_utils.hpp"
+
+#include "core/kma_walk.hpp"
+#include "core/kma_snapshot.hpp"
+#include "core/kma_context.hpp"
+
+using KalaMake::Core::Walker;
+using KalaMake::Core::WalkedFile;
+using KalaMake::Core::DirCache;
+using KalaMake::Core::DirListing;
+using KalaMake::Core::SessionContext;
+
+using std::vector;
+using std::function;
+using std::atomic;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::min;
+using std::clamp;
+using std::sort;
+using std::error_code;
+using std::filesystem::path;
+using std::filesystem::file_time_type;
+using std::filesystem::last_write_time;
+
+using u16 = uint16_t;
+
+//more threads than this only queue up on the same disk
+constexpr u16 max_walk_threads = 16;
+
+//below this many items starting threads costs more than the work itself
+constexpr size_t min_items_per_thread = 8;
+
+namespace KalaMake::Core
+{
+	u16 Walker::GetThreadCount()
+	{
+		static const u16 threadCount = scast<u16>(clamp(
+			thread::hardware_concurrency(),
+			1u,
+			scast<unsigned int>(max_walk_threads)));
+
+		return threadCount;
+	}
+
+	void Walker::ForEach(
+		size_t count,
+		const function<void(size_t)>& job)
+	{
+		size_t threadCount = min(
+			scast<size_t>(GetThreadCount()),
+			count / min_items_per_thread);
+
+		if (threadCount < 2)
+		{
+			for (size_t i = 0; i < count; ++i) job(i);
+			return;
+		}
+
+		atomic<size_t> next{};
+		vector<thread> workers{};
+		workers.reserve(threadCount - 1);
+
+		SessionContext& context = SessionContext::Current();
+
+		auto work = [&context, &next, &job, count]()
+			{
+				SessionContext::Scope scope(context);
+
+				while (true)
+				{
+					size_t idx = next++;
+					if (idx >= count) break;
+
+					job(idx);
+				}
+			};
+
+		for (size_t i = 1; i < threadCount; ++i) workers.emplace_back(work);
+
+		//the calling thread works too instead of only waiting
+		work();
+
+		for (auto& w : workers) w.join();
+	}
+
+	void Walker::GetWriteTimes(
+		const vector<path>& targets,
+		vector<file_time_type>& outTimes)
+	{
+		outTimes.assign(targets.size(), file_time_type::min());
+
+		ForEach(
+			targets.size(),
+			[&targets, &outTimes](size_t i)
+			{
+				error_code ec{};
+
+				file_time_type time = last_write_time(targets[i], ec);
+				if (!ec) outTimes[i] = time;
+			});
+	}
+
+	void Walker::Walk(
+		const vector<path>& roots,
+		vector<WalkedFile>& outFiles)
+	{
+		vector<path> level = roots;
+		vector<path> nextLevel{};
+		vector<path> files{};
+		vector<const DirListing*> listings{};
+
+		{
+			//profiles compiled together walk through the same directory cache,
+			//listings could be replaced while another walk still reads them
+			lock_guard<mutex> lock(SessionContext::Current().m_walk);
+
+			while (!level.empty())
+			{
+				DirCache::ListMany(level, listings);
+
+				nextLevel.clear();
+
+				for (size_t i = 0; i < level.size(); ++i)
+				{
+					const DirListing& listing = *listings[i];
+
+					for (const auto& f : listing.files) files.push_back(level[i] / f);
+					for (const auto& d : listing.dirs) nextLevel.push_back(level[i] / d);
+				}
+
+				level.swap(nextLevel);
+			}
+		}
+
+		vector<file_time_type> times{};
+		GetWriteTimes(files, times);
+
+		size_t first = outFiles.size();
+		outFiles.reserve(first + files.size());
+
+		for (size_t i = 0; i < files.size(); ++i)
+		{
+			outFiles.push_back(
+				{
+					.filePath = std::move(files[i]),
+					.time = times[i]
+				});
+		}
+
+		sort(
+			outFiles.begin() + first,
+			outFiles.end(),
+			[](const WalkedFile& a, const WalkedFile& b)
+			{
+				return a.filePath < b.filePath;
+			});
+	}
+}
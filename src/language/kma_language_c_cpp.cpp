@@ -5,11 +5,18 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <fstream>
+#include <condition_variable>
+#include <unordered_map>
 #include <filesystem>
 #include <atomic>
 #include <mutex>
 #include <thread>
 #include <sstream>
+#include <exception>
+#include <charconv>
+#include <system_error>
 
 #include "core_utils.hpp"
 #include "log_utils.hpp"
@@ -18,9 +25,14 @@
 
 #include "language/kma_language.hpp"
 #include "core/kma_core.hpp"
+#include "core/kma_schema.hpp"
 #include "core/kma_generate.hpp"
+#include "core/kma_jobs.hpp"
+#include "core/kma_action.hpp"
+#include "core/kma_walk.hpp"
+#include "core/kma_snapshot.hpp"
+#include "core/kma_context.hpp"
 
-using KalaHeaders::KalaCore::EnumToString;
 using KalaHeaders::KalaCore::RemoveDuplicates;
 using KalaHeaders::KalaCore::ContainsValue;
 
@@ -29,12 +41,20 @@ using KalaHeaders::KalaLog::LogType;
 
 using KalaHeaders::KalaFile::CreateNewDirectory;
 using KalaHeaders::KalaFile::RenamePath;
+using KalaHeaders::KalaFile::DeletePath;
+using KalaHeaders::KalaFile::ReadLinesFromFile;
+using KalaHeaders::KalaFile::CreateNewFile;
+using KalaHeaders::KalaFile::FileType;
 
 using KalaHeaders::KalaString::RemoveFromString;
 using KalaHeaders::KalaString::ContainsAlpha;
 
 using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::Schema;
+using KalaMake::Core::FieldType;
+using KalaMake::Core::language_c_cpp;
 using KalaMake::Language::GlobalData;
+using KalaMake::Core::ProfileData;
 using KalaMake::Core::BinaryType;
 using KalaMake::Core::CompilerLauncherType;
 using KalaMake::Core::CompilerType;
@@ -44,13 +64,23 @@ using KalaMake::Core::BuildType;
 using KalaMake::Core::WarningLevel;
 using KalaMake::Core::CustomFlag;
 using KalaMake::Core::Generate;
+using KalaMake::Core::JobPool;
+using KalaMake::Core::JobUsage;
+using KalaMake::Core::BuildAction;
+using KalaMake::Core::Action;
 using KalaMake::Core::CompileCommand;
+using KalaMake::Core::Diagnostic;
 using KalaMake::Core::VSCode_Launch;
 using KalaMake::Core::VSCode_Task;
+using KalaMake::Core::Walker;
+using KalaMake::Core::WalkedFile;
+using KalaMake::Core::Snapshot;
+using KalaMake::Core::SessionContext;
 
 using std::string;
 using std::string_view;
 using std::vector;
+using std::unordered_map;
 using std::filesystem::path;
 using std::filesystem::current_path;
 using std::filesystem::relative;
@@ -61,14 +91,39 @@ using std::filesystem::is_directory;
 using std::filesystem::last_write_time;
 using std::filesystem::file_time_type;
 using std::filesystem::directory_iterator;
-using std::filesystem::recursive_directory_iterator;
+using std::filesystem::equivalent;
+using std::filesystem::copy_file;
+using std::filesystem::copy_options;
+using std::from_chars;
+using std::error_code;
 using std::min;
+using std::max;
+using std::sort;
+using std::any_of;
+using std::replace;
+using std::erase;
+using std::erase_if;
+using std::unique;
+using std::stable_partition;
+using std::ifstream;
+using std::getline;
+using std::unique_lock;
+using std::lock_guard;
+using std::condition_variable;
 using std::atomic;
 using std::thread;
 using std::mutex;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
 using std::ostringstream;
+using std::istringstream;
+using std::to_string;
 
+using u8 = uint8_t;
 using u16 = uint16_t;
+using u64 = uint64_t;
+using i64 = int64_t;
 
 static bool isWindows = 
 #ifdef _WIN32
@@ -79,6 +134,29 @@ static bool isWindows =
 
 constexpr string_view objFolderName = "obj";
 
+//stored next to each output with the hashes of the objects and links it was last linked from
+constexpr string_view inputHashesExtension = ".inputs";
+
+//stored next to each shared library with its exported symbols, only rewritten when they change
+constexpr string_view interfaceExtension = ".ifs";
+
+//profile-guided builds keep their instrumented variant and training data inside the build path
+constexpr string_view pgoGenerateFolderName = "pgo-generate";
+constexpr string_view pgoDataFolderName = "pgo-data";
+constexpr string_view pgoMergedName = "pgo.profdata";
+
+//compile flag of instrumented objects, executables and shared libraries link with it to get the profiling runtime
+constexpr string_view pgoGenerateFlag = "fprofile-generate";
+
+//llvm-bolt keeps the linked executable and its profile next to the optimized output
+constexpr string_view preBoltExtension = ".prebolt";
+constexpr string_view boltProfileExtension = ".fdata";
+constexpr string_view perfDataExtension = ".perf.data";
+constexpr string_view profiledExtension = ".profiled";
+
+//the workload finds the executable it has to run in this environment variable
+constexpr string_view boltBinaryVariable = "KALAMAKE_BOLT_BINARY";
+
 //gcc + linux-gnu
 constexpr string_view target_type_linux_gnu_gcc = "x86_64-linux-gnu-gcc";
 //g++ + linux-gnu
@@ -105,13 +183,217 @@ constexpr string_view target_type_win_msvc_clang = "x86_64-pc-windows-msvc";
 //zig + windows-msvc
 constexpr string_view target_type_win_msvc_zig = "x86_64-windows-msvc";
 
-static vector<CompileCommand> commands{};
+//What the link step did with one output
+enum class LinkResult : u8
+{
+	L_LINKED = 0u,
+
+	//no input was newer than the output
+	L_UP_TO_DATE = 1u,
+
+	//newer inputs had the same bytes as in the last link
+	L_SAME_CONTENT = 2u
+};
+
+//What an object or linked file looked like when its output was last linked or found content-identical
+struct LinkInput
+{
+	//hash of the object, or of the interface of a shared library that has one
+	u64 hash{};
+
+	//write time of the object or linked file when it was hashed,
+	//an input still at this time is not hashed again
+	i64 time{};
+};
+
+//What every compile and link job of a profile used, stored in its build path after linking
+struct UsedJobs
+{
+	vector<JobUsage> jobs{};
+	mutex m_jobs;
+};
+
+//Generators of a profile that run on their own thread alongside compilation
+struct GeneratorRun
+{
+	vector<BuildAction> actions{};
+
+	//set for each generator once it finished, didRun is false if its outputs were up to date
+	vector<bool> isDone{};
+	vector<bool> didRun{};
+
+	//the error of a failed generator is rethrown once every compile worker stopped
+	bool isFailed{};
+	exception_ptr error{};
+
+	mutex m_generators;
+	condition_variable finished{};
+	thread runner{};
+};
+
+//thread local because profiles compiled together each run on their own thread
+static thread_local vector<CompileCommand> commands{};
 
-static file_time_type kmakeTime{};
+static thread_local file_time_type kmakeTime{};
+
+//objects older than the profile data of a profile-guided build are recompiled
+static thread_local file_time_type profileDataTime{};
 
 static void PreCheck(GlobalData& globalData);
 
-static void Compile_Final(const GlobalData& globalData);
+//True if the extension is a source file that the standard can compile
+static bool IsSourceFile(
+	StandardType standard,
+	const path& target);
+
+//Indexes of the generators whose outputs the file includes, directly or through other includes
+//found next to it or in the header dirs. Results are kept in cache by path
+static const vector<size_t>& FindGeneratedIncludes(
+	const path& file,
+	const vector<path>& includeDirs,
+	const unordered_map<string, size_t>& generatedFiles,
+	unordered_map<string, vector<size_t>>& cache);
+
+//Returns true if at least one output was linked
+static bool Compile_Final(const GlobalData& globalData);
+
+//Runs a compile or link job that writes output and keeps what it used
+static bool RunMeasured(
+	const string& command,
+	const path& output,
+	bool pinToPerformanceCores,
+	UsedJobs& usedJobs);
+
+//Compiles every found and generated source of the profile, or only checks them if checkOnly is set.
+//Returns the object files
+static vector<path> CompileSources(
+	const GlobalData& globalData,
+	const vector<string>& generators,
+	UsedJobs& usedJobs);
+
+//Adds the source outputs of the generators after the found sources,
+//returns every generator output by path with the index of the generator that writes it
+static unordered_map<string, size_t> AddGeneratedSources(
+	const GlobalData& globalData,
+	const vector<BuildAction>& generatorActions,
+	vector<path>& sources);
+
+//Indexes of the generators each source waits for, the ones that write it or a file it includes
+static vector<vector<size_t>> GetGeneratorWaits(
+	const GlobalData& globalData,
+	const vector<path>& sources,
+	const vector<BuildAction>& generatorActions,
+	const unordered_map<string, size_t>& generatedFiles);
+
+//Runs the generators on their own thread, each finished generator wakes the waiting compile workers
+static void StartGenerators(
+	const GlobalData& globalData,
+	const vector<string>& generators,
+	GeneratorRun& run);
+
+//Blocks until the given generators finished, returns false if a generator failed.
+//Sets outIsRegenerated if one of them ran and outNewest to the newest write time of their outputs
+static bool WaitForGenerators(
+	GeneratorRun& run,
+	const vector<size_t>& indexes,
+	bool& outIsRegenerated,
+	file_time_type& outNewest);
+
+//Joins the generator thread and rethrows the error of a failed generator
+static void FinishGenerators(GeneratorRun& run);
+
+//Links the profile and each of its targets, targets link on their own threads
+static vector<LinkResult> LinkTargets(
+	const GlobalData& globalData,
+	const vector<GlobalData>& targets,
+	const vector<path>& objFiles,
+	UsedJobs& usedJobs);
+
+//Links one output from the objects of the profile
+static LinkResult LinkOutput(
+	const GlobalData& globalData,
+	const vector<path>& objFiles,
+	UsedJobs& usedJobs);
+
+//Inputs newer than the output are compared by content before relinking,
+//so a recompile that produced the same object does not cost a link.
+//Sets outSameContent if changed inputs were hashed and found identical
+static bool NeedsLink(
+	const GlobalData& globalData,
+	const path& output,
+	const vector<path>& objects,
+	bool& outSameContent);
+
+//Runs llvm-bolt on the linked executables, saves the job usage and runs the post build actions,
+//returns true if at least one output was linked or optimized
+static bool RunPostLink(
+	const GlobalData& globalData,
+	const vector<GlobalData>& targets,
+	vector<LinkResult>& linkResults,
+	const UsedJobs& usedJobs);
+
+//Builds an instrumented variant, trains it and builds the profile with the collected data
+static void CompilePGO(const GlobalData& globalData);
+
+//Builds the profile once per microarch level at the same time, sharing the jobs of the profile
+static void CompileVariants(const GlobalData& globalData);
+
+//Microarch levels of the profile sorted from the baseline up, without duplicates
+static vector<string> GetMicroarchLevels(const ProfileData& profile);
+
+//One build per microarch level. The lowest level builds into the build path like a profile without variants,
+//the others build into '<buildpath>/<level>' without exports, post build actions and plain pre build actions
+static vector<GlobalData> GetMicroarchVariants(const GlobalData& globalData);
+
+//Adds the flags that compile with the data pgotraining collected,
+//false if the training has not written any data yet
+static bool AddProfileUseFlags(ProfileData& profile);
+
+//Replaces the executable with a llvm-bolt optimized copy that is laid out by a profile of the workload,
+//returns false if neither the linked executable nor the workload changed since the last run
+static bool OptimizeWithBolt(
+	const GlobalData& globalData,
+	bool isLinked);
+
+//Everything of a compile command up to the source and object paths,
+//shared by every source of the profile
+static string GetCompileCommand(const GlobalData& globalData);
+
+//The executable or library that linking writes to the build path
+static path GetOutputPath(const GlobalData& globalData);
+
+//Hash and time of every object and linked file by path from the last successful link,
+//inputs that were rewritten with the same bytes do not relink the output
+static unordered_map<string, LinkInput> ReadInputHashes(const path& output);
+
+//Hashes every object and linked file after a link
+static void WriteInputHashes(
+	const GlobalData& globalData,
+	const path& output,
+	const vector<path>& objects);
+
+static void SaveInputHashes(
+	const path& output,
+	const unordered_map<string, LinkInput>& inputs);
+
+static i64 GetInputTime(const path& target);
+
+//Writes the exported dynamic symbols of a shared library without their addresses,
+//the file keeps its old bytes and time when only function bodies changed
+static void WriteInterface(const path& output);
+
+//What a link is compared by, the interface of a shared library if it has one
+static path GetLinkInput(const path& link);
+
+static void CompileFile_Final(
+	const GlobalData& globalData,
+	const path& source,
+	bool exportDiagnostics);
+
+//Reads 'file:line:col: error: message' and 'file(line,col): error C1234: message' lines
+static bool ParseDiagnostic(
+	string_view line,
+	Diagnostic& out);
 
 static void GenerateSteps(const GlobalData& globalData)
 {
@@ -162,9 +444,46 @@ namespace KalaMake::Language
 	void LanguageCore::Compile_C_CPP(GlobalData& globalData)
 	{
 		commands.clear();
+		profileDataTime = file_time_type::min();
+
+		PreCheck(globalData);
+
+		if (!globalData.checkOnly
+			&& !globalData.targetProfile.microarch.empty())
+		{
+			CompileVariants(globalData);
+		}
+		else if (!globalData.checkOnly
+			&& !globalData.targetProfile.pgoTraining.empty())
+		{
+			CompilePGO(globalData);
+		}
+		else Compile_Final(globalData);
+	}
+
+	path LanguageCore::GetOutput_C_CPP(const GlobalData& globalData)
+	{
+		path outputPath = GetOutputPath(globalData);
+
+		//windows links against the import library of a dll
+		if (outputPath.extension() == ".dll")
+		{
+			return outputPath.parent_path() / (outputPath.stem().string() + ".lib");
+		}
+
+		return outputPath;
+	}
 
+	void LanguageCore::CompileFile_C_CPP(
+		GlobalData& globalData,
+		const path& source,
+		bool exportDiagnostics)
+	{
 		PreCheck(globalData);
-		Compile_Final(globalData);
+		CompileFile_Final(
+			globalData,
+			source,
+			exportDiagnostics);
 	}
 }
 
@@ -174,18 +493,6 @@ void PreCheck(GlobalData& globalData)
 	// ENSURE REQUIRED FIELDS ARE NOT MISSING
 	//
 
-    if (globalData.targetProfile.standard == StandardType::S_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_C_CPP",
-			"Field 'standard' must be assigned in C and C++!");
-    }
-	if (globalData.targetProfile.buildType == BuildType::B_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_C_CPP",
-			"Field 'buildtype' must be assigned in C and C++!");
-    }
 	if (globalData.targetProfile.targetType == TargetType::T_INVALID)
 	{
 #ifdef _WIN32
@@ -195,58 +502,23 @@ void PreCheck(GlobalData& globalData)
 #endif
 	}
 
-    //
-    // ENSURE UNSUPPORTED FIELDS ARE NOT USED
-    //
+	//
+	// ENSURE REQUIRED FIELDS ARE SET AND UNSUPPORTED FIELDS ARE NOT USED
+	//
 
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PACKAGE_JAR))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_C_CPP",
-			"Custom flag 'package-jar' is not supported in C and C++!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_JAVA_WIN_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_C_CPP",
-			"Custom flag 'java-win-console' is not supported in C and C++!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_EXPORT_JAVA_SLN))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_C_CPP",
-			"Custom flag 'export-java-sln' is not supported in C and C++!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PYTHON_ONE_FILE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_C_CPP",
-			"Custom flag 'python-one-file' is not supported in C and C++!");
-	}
+	Schema::CheckLanguage(
+		globalData.targetProfile,
+		language_c_cpp,
+		"C and C++",
+		"LANGUAGE_C_CPP");
 
 	//
 	// VERIFY COMPILER LOGIC
 	//
 
-	string_view compilerStr{};
-	EnumToString(
-		globalData.targetProfile.compiler,
-		KalaMakeCore::GetCompilerTypes(),
-		compilerStr);
-
-	string_view targetTypeStr{};
-	EnumToString(
-		globalData.targetProfile.targetType,
-		KalaMakeCore::GetTargetTypes(),
-		targetTypeStr);
+	string_view compilerStr = Schema::GetValueName(
+		FieldType::T_COMPILER,
+		globalData.targetProfile.compiler);
 
 #ifdef _WIN32
 	auto has_env = [](string_view env) -> bool
@@ -286,34 +558,65 @@ void PreCheck(GlobalData& globalData)
 	}
 #endif
 
+	if (!globalData.targetProfile.pgoTraining.empty()
+		&& (globalData.targetProfile.compiler == CompilerType::C_CL
+		|| globalData.targetProfile.compiler == CompilerType::C_CLANG_CL))
+	{
+		KalaMakeCore::CloseOnError(
+			"LANGUAGE_C_CPP",
+			"Field 'pgotraining' is not supported by MSVC compiler '" + string(compilerStr) + "'!");
+	}
+
+	if (!globalData.targetProfile.microarch.empty())
+	{
+		if (globalData.targetProfile.compiler == CompilerType::C_CL
+			|| globalData.targetProfile.compiler == CompilerType::C_CLANG_CL)
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Field 'microarch' is not supported by MSVC compiler '" + string(compilerStr) + "'!");
+		}
+
+		//both run the output path of the profile, which only holds the lowest level
+		if (!globalData.targetProfile.pgoTraining.empty()
+			|| !globalData.targetProfile.boltWorkload.empty())
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Field 'microarch' cannot be combined with 'pgotraining' or 'boltworkload'!");
+		}
+	}
+
+	if (!globalData.targetProfile.boltWorkload.empty())
+	{
+		if (isWindows)
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Field 'boltworkload' is only supported on Linux!");
+		}
+
+		bool hasExecutable = globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE;
+		for (const auto& t : globalData.targetProfile.targets)
+		{
+			if (t.binaryType == BinaryType::B_EXECUTABLE) hasExecutable = true;
+		}
+
+		if (!hasExecutable)
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Field 'boltworkload' requires an executable binarytype or target!");
+		}
+	}
+
 	//
 	// FILTER OUT BAD SOURCE FILES 
 	//
 
 	StandardType standard = globalData.targetProfile.standard;
-	bool isCLanguage =
-		standard == StandardType::C_89
-		|| standard == StandardType::C_99
-		|| standard == StandardType::C_11
-		|| standard == StandardType::C_17
-		|| standard == StandardType::C_23;
-
-	bool isCPPLanguage =
-		standard == StandardType::CPP_14
-		|| standard == StandardType::CPP_17
-		|| standard == StandardType::CPP_20
-		|| standard == StandardType::CPP_23
-		|| standard == StandardType::CPP_26;
-
-	auto should_exclude = [](const path& target) -> bool
-		{
-			return (target.string().starts_with('!'));
-		};
 
-	auto should_remove = [
-		isCLanguage, 
-		isCPPLanguage](
-		const path& target) -> bool
+	auto should_remove = [standard](const path& target) -> bool
 		{
 			if (!exists(target)
 				|| is_directory(target)
@@ -323,80 +626,15 @@ void PreCheck(GlobalData& globalData)
 				return true;
 			}
 
-			if (!isCLanguage
-				&& !isCPPLanguage)
-			{
-				return true;
-			}
-
-			string extension = target.extension().string();
-
-			if (isCLanguage)
-			{
-				if (target.extension() != ".c")
-				{
-					return true;
-
-					
-				}
-			}
-			if (isCPPLanguage)
-			{
-				if (target.extension() != ".c"
-					&& target.extension() != ".cpp"
-					&& target.extension() != ".cc"
-					&& target.extension() != ".cxx")
-				{
-					return true;
-				}
-			}
-
-			return false;
+			return !IsSourceFile(standard, target);
 		};
 
 	bool foundInvalid{};
 	vector<path>& sources = globalData.targetProfile.sources;
-	vector<path> exclusions{};
 	vector<path> finalSources{};
 
 	for (const auto& target : sources)
 	{
-		if (should_exclude(target))
-		{
-			string withoutExclamation = target.string().substr(1);
-
-			auto itMatch = find(
-				sources.begin(),
-				sources.end(),
-				path((withoutExclamation)));
-
-			if (itMatch == sources.end())
-			{
-				withoutExclamation = (current_path() / withoutExclamation).string();
-
-				itMatch = find(
-					sources.begin(),
-					sources.end(),
-					path((withoutExclamation)));
-
-				if (itMatch == sources.end())
-				{
-					KalaMakeCore::CloseOnError(
-						"LANGUAGE_C_CPP",
-						"Cannot ignore target '" + target.string() + "' if it hasn't already been added to sources list!");
-				}
-			}
-
-			exclusions.push_back(withoutExclamation);
-
-			Log::Print(
-				"Ignoring excluded source script path '" + (*itMatch).string() + "'.",
-				"LANGUAGE_C_CPP",
-				LogType::LOG_INFO);
-
-			foundInvalid = true;
-			continue;
-		}
 		if (should_remove(target))
 		{
 			Log::Print(
@@ -433,7 +671,15 @@ void PreCheck(GlobalData& globalData)
 		finalSources.push_back(target);
 	}
 
-	if (finalSources.empty())
+	//generators can write every source during the build
+	bool hasGenerators{};
+	for (const auto& a : globalData.targetProfile.preBuildActions)
+	{
+		if (Action::IsGenerator(a)) hasGenerators = true;
+	}
+
+	if (finalSources.empty()
+		&& !hasGenerators)
 	{
 		KalaMakeCore::CloseOnError(
 			"LANGUAGE_C_CPP",
@@ -442,1000 +688,2780 @@ void PreCheck(GlobalData& globalData)
 
 	if (foundInvalid) 
 	{
-		if (!exclusions.empty())
-		{
-			finalSources.erase(
-				remove_if(
-					finalSources.begin(),
-					finalSources.end(),
-					[&exclusions](const path& p)
-					{
-						return find(exclusions.begin(), exclusions.end(), p) != exclusions.end();
-					}),
-				finalSources.end());
-		}
-
 		globalData.targetProfile.sources = std::move(finalSources);
 
 		Log::Print("\n===========================================================================\n");
 	}
 }
 
-void Compile_Final(const GlobalData& globalData)
+bool IsSourceFile(
+	StandardType standard,
+	const path& target)
 {
-	bool isMSVC = 
-		globalData.targetProfile.compiler == CompilerType::C_CL
-		|| globalData.targetProfile.compiler == CompilerType::C_CLANG_CL;
+	bool isCLanguage =
+		standard == StandardType::C_89
+		|| standard == StandardType::C_99
+		|| standard == StandardType::C_11
+		|| standard == StandardType::C_17
+		|| standard == StandardType::C_23;
 
-	string frontArg = isMSVC
-		? "/"
-		: "-";
+	bool isCPPLanguage =
+		standard == StandardType::CPP_14
+		|| standard == StandardType::CPP_17
+		|| standard == StandardType::CPP_20
+		|| standard == StandardType::CPP_23
+		|| standard == StandardType::CPP_26;
 
-	//
-	// PRE BUILD ACTIONS
-	//
+	const path extension = target.extension();
 
-	if (!globalData.targetProfile.preBuildActions.empty())
+	if (isCLanguage) return extension == ".c";
+
+	if (isCPPLanguage)
 	{
-		Log::Print(
-			"Starting to run pre build actions.",
-			"LANGUAGE_C_CPP",
-			LogType::LOG_INFO);
+		return extension == ".c"
+			|| extension == ".cpp"
+			|| extension == ".cc"
+			|| extension == ".cxx";
+	}
 
-		for (const auto& a : globalData.targetProfile.preBuildActions)
-		{
-			Log::Print("\naction: " + a);
+	return false;
+}
 
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_C_CPP",
-					"Failed to run pre build action '" + a + "'!");
-			}
-		}
+const vector<size_t>& FindGeneratedIncludes(
+	const path& file,
+	const vector<path>& includeDirs,
+	const unordered_map<string, size_t>& generatedFiles,
+	unordered_map<string, vector<size_t>>& cache)
+{
+	string key = file.lexically_normal().string();
 
-		Log::Print(" ");
+	auto found = cache.find(key);
+	if (found != cache.end()) return found->second;
 
-		Log::Print(
-			"Finished all pre build actions!",
-			"LANGUAGE_C_CPP",
-			LogType::LOG_SUCCESS);
+	//the empty entry stops include cycles, references to map values stay valid while it grows
+	vector<size_t>& result = cache[key];
 
-		Log::Print("\n===========================================================================\n");
-	}
+	ifstream in(file);
+	if (!in) return result;
 
-	//
-	// COMPILE
-	//
+	vector<size_t> indexes{};
+	vector<path> candidates{};
 
-	auto compile = [&isMSVC, &frontArg, &globalData]() -> vector<path>
+	string line{};
+	while (getline(in, line))
+	{
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == string::npos
+			|| line[pos] != '#')
 		{
-			string command{};
-
-			//set compiler launcher
+			continue;
+		}
 
-			if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID)
-			{
-				string_view compilerLauncher{};
-				EnumToString(globalData.targetProfile.compilerLauncher, KalaMakeCore::GetCompilerLauncherTypes(), compilerLauncher);
+		pos = line.find_first_not_of(" \t", pos + 1);
+		if (pos == string::npos
+			|| line.compare(pos, 7, "include") != 0)
+		{
+			continue;
+		}
 
-				command += string(compilerLauncher) + " ";
-			}
+		size_t open = line.find_first_of("\"<", pos + 7);
+		if (open == string::npos) continue;
 
-			//set compiler
+		size_t close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+		if (close == string::npos) continue;
 
-			string_view compiler{};
-			string targetTriple{};
+		path name = line.substr(open + 1, close - open - 1);
 
-			EnumToString(globalData.targetProfile.compiler, KalaMakeCore::GetCompilerTypes(), compiler);
+		//quoted includes are looked up next to the including file first
+		candidates.clear();
+		if (line[open] == '"') candidates.push_back(file.parent_path() / name);
+		for (const auto& d : includeDirs) candidates.push_back(d / name);
 
-			if (globalData.targetProfile.targetType == TargetType::T_LINUX_GNU)
-			{
-				if (compiler == "gcc")      compiler = target_type_linux_gnu_gcc;
-				else if (compiler == "g++") compiler = target_type_linux_gnu_gpp;
-				else                        targetTriple = target_type_linux_gnu_clang_zig;
-			}
-			else if (globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
-			{
-				if (compiler == "gcc")      compiler = target_type_linux_musl_gcc;
-				else if (compiler == "g++") compiler = target_type_linux_musl_gpp;
-				else                        targetTriple = target_type_linux_musl_clang_zig;
-			}
-			else if (globalData.targetProfile.targetType == TargetType::T_WINDOWS_GNU)
-			{
-				if (compiler == "gcc")      compiler = target_type_win_gnu_gcc;
-				else if (compiler == "g++") compiler = target_type_win_gnu_gpp;
-				else                        targetTriple = target_type_win_gnu_clang_zig;
-			}
-			else
+		for (const auto& c : candidates)
+		{
+			auto generated = generatedFiles.find(c.lexically_normal().string());
+			if (generated != generatedFiles.end())
 			{
-				if (compiler == "clang"
-					|| compiler == "clang++")
-				{
-					targetTriple = target_type_win_msvc_clang;
-				}
-				else targetTriple = target_type_win_msvc_zig;
+				indexes.push_back(generated->second);
+				break;
 			}
 
-			command += string(compiler);
-
-			if (compiler == "zig")
+			error_code ec{};
+			if (is_regular_file(c, ec))
 			{
-				StandardType standardType = globalData.targetProfile.standard;
+				const vector<size_t>& nested = FindGeneratedIncludes(
+					c,
+					includeDirs,
+					generatedFiles,
+					cache);
 
-				if (standardType == StandardType::C_89
-					|| standardType == StandardType::C_99
-					|| standardType == StandardType::C_11
-					|| standardType == StandardType::C_17
-					|| standardType == StandardType::C_23)
-				{
-					command += " cc";
-				}
-				else if (standardType == StandardType::CPP_14
-					|| standardType == StandardType::CPP_17
-					|| standardType == StandardType::CPP_20
-					|| standardType == StandardType::CPP_23
-					|| standardType == StandardType::CPP_26)
-				{
-					command += " c++";
-				}
+				indexes.insert(indexes.end(), nested.begin(), nested.end());
+				break;
 			}
+		}
+	}
 
-			//-target only for clang/clang++/zig
-			if (!targetTriple.empty()) command += " -target " + targetTriple;
+	sort(indexes.begin(), indexes.end());
+	indexes.erase(unique(indexes.begin(), indexes.end()), indexes.end());
 
-			//set standard
+	result = std::move(indexes);
+	return result;
+}
 
-			string_view standard{};
-			EnumToString(globalData.targetProfile.standard, KalaMakeCore::GetStandardTypes(), standard);
+string GetCompileCommand(const GlobalData& globalData)
+{
+	bool isMSVC = 
+		globalData.targetProfile.compiler == CompilerType::C_CL
+		|| globalData.targetProfile.compiler == CompilerType::C_CLANG_CL;
 
-            if (!standard.starts_with("c"))
-            {
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_C_CPP",
-					"Unsupported standard type '" + string(standard) + "' was passed to C/C++ compiler!");
-            }
+	string frontArg = isMSVC
+		? "/"
+		: "-";
 
-			string standardArg = isMSVC
-				? frontArg + "std:"
-				: frontArg + "std=";
+	string command{};
 
-			command += " " + standardArg + string(standard);
+	//set compiler launcher
 
-			//set compile flags and warning level
+	if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID)
+	{
+		string_view compilerLauncher = Schema::GetValueName(FieldType::T_COMPILER_LAUNCHER, globalData.targetProfile.compilerLauncher);
 
-			vector<string> finalFlags = globalData.targetProfile.compileFlags;
+		command += string(compilerLauncher) + " ";
+	}
 
-#ifdef _WIN32
-			string runtimeFlag{};
+	//set compiler
 
-			if (isMSVC)
-			{
-				runtimeFlag = ContainsValue(
-					globalData.targetProfile.customFlags, 
-					CustomFlag::F_MSVC_STATIC_RUNTIME) ? "MT" : "MD";
-				
-				finalFlags.push_back(globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_DEBUG
-					? runtimeFlag + "d"
-					: runtimeFlag);
-			}
-			else
-			{
-				runtimeFlag = ContainsValue(
-					globalData.targetProfile.customFlags, 
-					CustomFlag::F_MSVC_STATIC_RUNTIME) ? "fms-runtime-lib=static" : "fms-runtime-lib=dll";
+	string_view compiler = Schema::GetValueName(FieldType::T_COMPILER, globalData.targetProfile.compiler);
+	string targetTriple{};
 
-				finalFlags.push_back(runtimeFlag);
-			}
-#endif
+	if (globalData.targetProfile.targetType == TargetType::T_LINUX_GNU)
+	{
+		if (compiler == "gcc")      compiler = target_type_linux_gnu_gcc;
+		else if (compiler == "g++") compiler = target_type_linux_gnu_gpp;
+		else                        targetTriple = target_type_linux_gnu_clang_zig;
+	}
+	else if (globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
+	{
+		if (compiler == "gcc")      compiler = target_type_linux_musl_gcc;
+		else if (compiler == "g++") compiler = target_type_linux_musl_gpp;
+		else                        targetTriple = target_type_linux_musl_clang_zig;
+	}
+	else if (globalData.targetProfile.targetType == TargetType::T_WINDOWS_GNU)
+	{
+		if (compiler == "gcc")      compiler = target_type_win_gnu_gcc;
+		else if (compiler == "g++") compiler = target_type_win_gnu_gpp;
+		else                        targetTriple = target_type_win_gnu_clang_zig;
+	}
+	else
+	{
+		if (compiler == "clang"
+			|| compiler == "clang++")
+		{
+			targetTriple = target_type_win_msvc_clang;
+		}
+		else targetTriple = target_type_win_msvc_zig;
+	}
 
-			//always enable exceptions for msvc
-			if (isMSVC) finalFlags.push_back("EHsc");
+	command += string(compiler);
 
-			if (ContainsValue(
-				globalData.targetProfile.customFlags, 
-				CustomFlag::F_WARNINGS_AS_ERRORS))
-			{
-				if (isMSVC) finalFlags.push_back("WX");
-				else        finalFlags.push_back("Werror");
+	if (compiler == "zig")
+	{
+		StandardType standardType = globalData.targetProfile.standard;
+
+		if (standardType == StandardType::C_89
+			|| standardType == StandardType::C_99
+			|| standardType == StandardType::C_11
+			|| standardType == StandardType::C_17
+			|| standardType == StandardType::C_23)
+		{
+			command += " cc";
+		}
+		else if (standardType == StandardType::CPP_14
+			|| standardType == StandardType::CPP_17
+			|| standardType == StandardType::CPP_20
+			|| standardType == StandardType::CPP_23
+			|| standardType == StandardType::CPP_26)
+		{
+			command += " c++";
+		}
+	}
+
+	//-target only for clang/clang++/zig
+	if (!targetTriple.empty()) command += " -target " + targetTriple;
+
+	//set standard
+
+	string_view standard = Schema::GetValueName(FieldType::T_STANDARD, globalData.targetProfile.standard);
+
+    if (!standard.starts_with("c"))
+    {
+		KalaMakeCore::CloseOnError(
+			"LANGUAGE_C_CPP",
+			"Unsupported standard type '" + string(standard) + "' was passed to C/C++ compiler!");
+    }
+
+	string standardArg = isMSVC
+		? frontArg + "std:"
+		: frontArg + "std=";
+
+	command += " " + standardArg + string(standard);
+
+	//set compile flags and warning level
+
+	vector<string> finalFlags = globalData.targetProfile.compileFlags;
+
+#ifdef _WIN32
+	string runtimeFlag{};
+
+	if (isMSVC)
+	{
+		runtimeFlag = ContainsValue(
+			globalData.targetProfile.customFlags, 
+			CustomFlag::F_MSVC_STATIC_RUNTIME) ? "MT" : "MD";
+		
+		finalFlags.push_back(globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_DEBUG
+			? runtimeFlag + "d"
+			: runtimeFlag);
+	}
+	else
+	{
+		runtimeFlag = ContainsValue(
+			globalData.targetProfile.customFlags, 
+			CustomFlag::F_MSVC_STATIC_RUNTIME) ? "fms-runtime-lib=static" : "fms-runtime-lib=dll";
+
+		finalFlags.push_back(runtimeFlag);
+	}
+#endif
+
+	//always enable exceptions for msvc
+	if (isMSVC) finalFlags.push_back("EHsc");
+
+	if (ContainsValue(
+		globalData.targetProfile.customFlags, 
+		CustomFlag::F_WARNINGS_AS_ERRORS))
+	{
+		if (isMSVC) finalFlags.push_back("WX");
+		else        finalFlags.push_back("Werror");
+	}
+
+	//always use NDEBUG for release, minsizerel and reldebug
+	if (globalData.targetProfile.buildType != BuildType::B_DEBUG)
+	{
+		finalFlags.push_back("DNDEBUG");
+	}
+
+	bool generateSymbols = ContainsValue(
+		globalData.targetProfile.customFlags,
+		CustomFlag::F_GENERATE_SYMBOLS);
+
+	switch (globalData.targetProfile.buildType)
+	{
+	case BuildType::B_DEBUG:
+	{
+		if (isMSVC)
+		{
+			finalFlags.push_back("Zi"); //generate full debugging info
+			finalFlags.push_back("Od"); //turn off all code optimizations
+		}
+		else
+		{
+			finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
+#ifdef _WIN32
+			finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
+#endif
+			finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
+			finalFlags.push_back("O0"); //turn off all code optimizations
+		}
+		break;
+	}
+	case BuildType::B_RELDEBUG:
+	{
+		if (isMSVC)
+		{
+			finalFlags.push_back("Zi"); //generate full debugging info
+			finalFlags.push_back("O2"); //full speed optimization
+			finalFlags.push_back("Oy-"); //force MSVC to preseve stack frame structures
+		}
+		else
+		{
+			finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
+#ifdef _WIN32
+			finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
+#endif
+			finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
+			finalFlags.push_back("O2"); //full speed optimization
+		}
+		break;
+	}
+	case BuildType::B_RELEASE:
+	{
+		if (isMSVC)
+		{
+			if (generateSymbols) finalFlags.push_back("Zi"); //generate full debugging info
+			finalFlags.push_back("O2"); //full speed optimization
+			if (generateSymbols) finalFlags.push_back("Oy-"); //force MSVC to preseve stack frame structures
+		}
+		else
+		{
+			if (generateSymbols)
+			{
+				finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
+#ifdef _WIN32
+				finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
+#endif
+				finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
+			}
+			finalFlags.push_back("O2"); //full speed optimization
+		}
+		break;
+	}
+	case BuildType::B_MINSIZEREL:
+	{
+		if (isMSVC)
+		{
+			if (generateSymbols) finalFlags.push_back("Zi"); //generate full debugging info
+			finalFlags.push_back("O1"); //size optimization
+			if (generateSymbols) finalFlags.push_back("Oy-"); //force MSVC to preseve stack frame structures
+		}
+		else
+		{
+			if (generateSymbols)
+			{
+				finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
+#ifdef _WIN32
+				finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
+#endif
+				finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
+			}
+			finalFlags.push_back("Os"); //size optimization
+		}
+		break;
+	}
+
+	default: break;
+	}
+
+	switch (globalData.targetProfile.warningLevel)
+	{
+	case WarningLevel::W_BASIC:
+	{
+		if (isMSVC) finalFlags.push_back("W1");
+		else        finalFlags.push_back("Wall");
+		break;
+	}
+	case WarningLevel::W_NORMAL:
+	{
+		if (isMSVC) finalFlags.push_back("W3");
+		else
+		{
+			finalFlags.push_back("Wall");
+			finalFlags.push_back("Wextra");
+		}
+		break;
+	}
+	case WarningLevel::W_STRONG:
+	{
+		if (isMSVC) finalFlags.push_back("W4");
+		else
+		{
+			finalFlags.push_back("Wall");
+			finalFlags.push_back("Wextra");
+			finalFlags.push_back("Wpedantic");
+		}
+		break;
+	}
+	case WarningLevel::W_STRICT:
+	{
+		if (isMSVC)
+		{
+			finalFlags.push_back("W4");
+			finalFlags.push_back("permissive-");
+		}
+		else
+		{
+			finalFlags.push_back("Wall");
+			finalFlags.push_back("Wextra");
+			finalFlags.push_back("Wpedantic");
+			finalFlags.push_back("Wconversion");
+			finalFlags.push_back("Wsign-conversion");
+		}
+		break;
+	}
+	case WarningLevel::W_ALL:
+	{
+		if (isMSVC) finalFlags.push_back("Wall");
+		else if (globalData.targetProfile.compiler == CompilerType::C_CLANG
+				|| globalData.targetProfile.compiler == CompilerType::C_CLANGPP
+				|| globalData.targetProfile.compiler == CompilerType::C_ZIG)
+		{
+			finalFlags.push_back("Weverything");
+		}
+		else
+		{
+			finalFlags.push_back("Wall");
+			finalFlags.push_back("Wextra");
+			finalFlags.push_back("Wpedantic");
+			finalFlags.push_back("Wconversion");
+			finalFlags.push_back("Wsign-conversion");
+		}
+		break;
+	}
+
+	default: break;
+	}
+
+	RemoveDuplicates(finalFlags);
+	for (const auto& f : finalFlags)
+	{
+		command += " " + frontArg + f;
+	}
+
+	//set defines
+
+	string defineArg = frontArg + "D";
+
+	for (const auto& d : globalData.targetProfile.defines)
+	{
+		command += " " + defineArg + d;
+	}
+
+	//set headers
+
+	if (!globalData.targetProfile.headers.empty())
+	{
+		for (const auto& h : globalData.targetProfile.headers)
+		{
+			command += " " + frontArg + "I\"" + h.string() + "\"";
+		}
+	}
+
+	//compile-time shared flag for object file,
+	//objects are shared by every target so one shared target is enough
+	bool isShared = globalData.targetProfile.binaryType == BinaryType::B_SHARED;
+	for (const auto& t : globalData.targetProfile.targets)
+	{
+		if (t.binaryType == BinaryType::B_SHARED) isShared = true;
+	}
+
+	if (!isMSVC
+		&& !isWindows
+		&& isShared)
+	{
+		command += " -fPIC";
+	}
+
+	//check only parses and analyzes, no object file is written
+	if (globalData.checkOnly) command += isMSVC ? " /Zs" : " -fsyntax-only";
+	else                      command += " " + frontArg + "c";
+
+	return command;
+}
+
+bool Compile_Final(const GlobalData& globalData)
+{
+	//
+	// PRE BUILD ACTIONS
+	//
+
+	//pre build actions with declared outputs are generators that run alongside compilation
+	vector<string> preBuildActions{};
+	vector<string> generators{};
+
+	for (const auto& a : globalData.targetProfile.preBuildActions)
+	{
+		if (Action::IsGenerator(a)) generators.push_back(a);
+		else preBuildActions.push_back(a);
+	}
+
+	if (!preBuildActions.empty())
+	{
+		Log::Print(
+			"Starting to run pre build actions.",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_INFO);
+
+		Action::RunAll(
+			globalData,
+			preBuildActions,
+			false,
+			"LANGUAGE_C_CPP",
+			"pre build");
+
+		Log::Print(" ");
+
+		Log::Print(
+			"Finished all pre build actions!",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_SUCCESS);
+
+		Log::Print("\n===========================================================================\n");
+	}
+
+	UsedJobs usedJobs{};
+
+	//
+	// COMPILE
+	//
+
+	vector<path> objFiles = CompileSources(
+		globalData,
+		generators,
+		usedJobs);
+
+	if (globalData.checkOnly)
+	{
+		Log::Print(
+			"Finished checking '" + to_string(globalData.targetProfile.sources.size()) + "' sources, no errors were found!",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_SUCCESS);
+
+		return false;
+	}
+
+	//
+	// LINK
+	//
+
+	//targets share the objects and flags of the profile, only their binary differs
+	vector<GlobalData> targets{ globalData };
+	for (const auto& t : globalData.targetProfile.targets)
+	{
+		GlobalData& target = targets.emplace_back(globalData);
+		target.targetProfile.binaryType = t.binaryType;
+		target.targetProfile.binaryName = t.binaryName;
+	}
+
+	vector<LinkResult> linkResults = LinkTargets(
+		globalData,
+		targets,
+		objFiles,
+		usedJobs);
+
+	//
+	// BOLT AND POST BUILD ACTIONS
+	//
+
+	return RunPostLink(
+		globalData,
+		targets,
+		linkResults,
+		usedJobs);
+}
+
+bool RunMeasured(
+	const string& command,
+	const path& output,
+	bool pinToPerformanceCores,
+	UsedJobs& usedJobs)
+{
+	JobUsage usage{ .name = output.string() };
+
+	if (JobPool::Run(
+		command,
+		usage,
+		pinToPerformanceCores) != 0)
+	{
+		return false;
+	}
+
+	Log::Print(
+		"Wrote '" + output.filename().string() + "' with " + JobPool::Describe(usage) + ".",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_INFO);
+
+	lock_guard<mutex> lock(usedJobs.m_jobs);
+	usedJobs.jobs.push_back(std::move(usage));
+
+	return true;
+}
+
+vector<path> CompileSources(
+	const GlobalData& globalData,
+	const vector<string>& generators,
+	UsedJobs& usedJobs)
+{
+	bool isMSVC =
+		globalData.targetProfile.compiler == CompilerType::C_CL
+		|| globalData.targetProfile.compiler == CompilerType::C_CLANG_CL;
+
+	string command = GetCompileCommand(globalData);
+
+	//compile
+
+	path buildPath = globalData.targetProfile.buildPath / objFolderName;
+
+	if (!globalData.checkOnly
+		&& !exists(buildPath))
+	{
+		string errorMsg = CreateNewDirectory(buildPath);
+		if (!errorMsg.empty())
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Failed to create new obj dir for compilation! Reason: " + errorMsg);
+		}
+	}
+
+	string extension = isMSVC
+		? ".obj"
+		: ".o";
+
+	string objFront = isMSVC
+		? "/Fo:"
+		: "-o";
+
+	vector<path> compiledObj{};
+	mutex m_compiledObj;
+
+	//check keeps going after errors so every broken source is reported at once
+	vector<path> failedSources{};
+
+	kmakeTime = last_write_time(globalData.projectFile);
+	file_time_type newestHeaderTime = file_time_type::min();
+
+	//generated sources join the found ones, which stay first so workers
+	//have something to compile while the generators still run
+	GeneratorRun generatorRun{};
+	generatorRun.actions = Action::Resolve(
+		globalData,
+		generators,
+		"LANGUAGE_C_CPP",
+		"generator");
+
+	vector<path> sources = globalData.targetProfile.sources;
+	unordered_map<string, size_t> generatedFiles = AddGeneratedSources(
+		globalData,
+		generatorRun.actions,
+		sources);
+
+	if (sources.empty())
+	{
+		KalaMakeCore::CloseOnError(
+			"LANGUAGE_C_CPP",
+			"No sources were found and no generator declares a source output!");
+	}
+
+	vector<vector<size_t>> waitsFor = GetGeneratorWaits(
+		globalData,
+		sources,
+		generatorRun.actions,
+		generatedFiles);
+
+	vector<size_t> order(sources.size());
+	for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+
+	stable_partition(
+		order.begin(),
+		order.end(),
+		[&waitsFor](size_t i) { return waitsFor[i].empty(); });
+
+	vector<WalkedFile> headerFiles{};
+	Walker::Walk(globalData.targetProfile.headers, headerFiles);
+
+	for (const auto& h : headerFiles)
+	{
+		const path& ext = h.filePath.extension();
+
+		//sources that include generated headers recompile when their generator runs,
+		//so the newer header must not recompile every other source on the next build
+		if (generatedFiles.contains(h.filePath.lexically_normal().string())) continue;
+
+		if (ext == ".h"
+			|| ext == ".hpp")
+		{
+			newestHeaderTime = max(
+				newestHeaderTime,
+				h.time);
+		}
+	}
+
+	newestHeaderTime = max(
+		newestHeaderTime,
+		profileDataTime);
+
+	//compile workers have their own thread local kmakeTime, so they get a copy
+	auto needs_compile = [&newestHeaderTime, projectFileTime = kmakeTime](
+		const path& source,
+		const path& object
+		) -> bool
+		{
+			if (!exists(object)) return true;
+
+			const file_time_type objTime = last_write_time(object);
+			const file_time_type srcTime = last_write_time(source);
+
+			return objTime < projectFileTime
+				|| objTime < srcTime
+				|| objTime < newestHeaderTime;
+		};
+
+	auto generate = [
+		&globalData,
+		&sources,
+		&buildPath,
+		&extension,
+		&command,
+		&objFront]() -> void
+		{
+			if (ContainsValue(globalData.targetProfile.customFlags,CustomFlag::F_EXPORT_COMPILE_COMMANDS))
+			{
+				path fullBuildPath = buildPath.is_absolute()
+					? buildPath
+					: current_path() / buildPath;
+
+				for (size_t i = 0; i < sources.size(); i++)
+				{
+					const path& s = sources[i];
+
+					path objPath = fullBuildPath / (s.stem().string() + extension);
+
+					string perFileCommand = command;
+
+					perFileCommand += " \"" + s.string() + "\"";
+					perFileCommand += " " + objFront + " \"" + objPath.string() + "\"";
+
+					commands.push_back(
+					{
+						.dir = globalData.projectFile.parent_path(),
+						.command = RemoveFromString(perFileCommand, "\"", true),
+						.file = s,
+						.output = objPath.string()
+					});
+				}
+			}
+
+			GenerateSteps(globalData);
+		};
+
+	auto compile = [
+		&globalData,
+		&sources,
+		&waitsFor,
+		&generatorRun,
+		&buildPath,
+		&extension,
+		&command,
+		&objFront,
+		needs_compile,
+		&usedJobs,
+		&compiledObj,
+		&m_compiledObj,
+		&failedSources]
+		(size_t targetIndex) -> void
+		{
+			const path& s = sources[targetIndex];
+
+			//a generator that ran rewrote this source or something it includes,
+			//generated files can also be newer than the object if another build ran the generator
+			bool isRegenerated{};
+			file_time_type newestGenerated = file_time_type::min();
+
+			//the generator error is reported once every worker stopped
+			if (!waitsFor[targetIndex].empty()
+				&& !WaitForGenerators(
+					generatorRun,
+					waitsFor[targetIndex],
+					isRegenerated,
+					newestGenerated))
+			{
+				return;
+			}
+
+			if (globalData.checkOnly)
+			{
+				string checkCommand = command + " \"" + s.string() + "\"";
+
+				Log::Print(
+					"Starting to check via '" + checkCommand + "'.",
+					"LANGUAGE_C_CPP",
+					LogType::LOG_INFO);
+
+				if (JobPool::Run(checkCommand) != 0)
+				{
+					m_compiledObj.lock();
+					failedSources.push_back(s);
+					m_compiledObj.unlock();
+				}
+
+				return;
+			}
+
+			path objPath = buildPath / (s.stem().string() + extension);
+
+			string perFileCommand = command;
+
+			perFileCommand += " \"" + s.string() + "\"";
+			perFileCommand += " " + objFront + " \"" + objPath.string() + "\"";
+
+			if (isRegenerated
+				|| needs_compile(s, objPath)
+				|| last_write_time(objPath) < newestGenerated)
+			{
+				Log::Print(
+					"Starting to compile via '" + perFileCommand + "'.",
+					"LANGUAGE_C_CPP",
+					LogType::LOG_INFO);
+
+				if (!RunMeasured(perFileCommand, objPath, false, usedJobs))
+				{
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_C_CPP",
+						"Failed to compile object file '" + objPath.string() + "'!");
+				}
+			}
+			else
+			{
+				Log::Print(
+					"Skipping compilation of object file '" + objPath.string() + "' because it is newer than its source and header files.\n",
+					"LANGUAGE_C_CPP",
+					LogType::LOG_INFO);
+			}
+
+			m_compiledObj.lock();
+			compiledObj.push_back(objPath);
+			m_compiledObj.unlock();
+		};
+
+	if (!globalData.checkOnly) generate();
+
+	StartGenerators(
+		globalData,
+		generators,
+		generatorRun);
+
+	if (sources.size() == 1
+		&& generators.empty())
+	{
+		compile(0);
+	}
+	else
+	{
+		u16 max_jobs = min(
+			scast<size_t>(globalData.targetProfile.jobs),
+			sources.size());
+
+		atomic<int> next{};
+		vector<thread> workers{};
+
+		//errors cannot leave a worker thread, the first one is rethrown after all workers stopped
+		exception_ptr firstError{};
+		mutex m_firstError;
+
+		SessionContext& context = SessionContext::Current();
+
+		for (u16 i = 0; i < max_jobs; ++i)
+		{
+			workers.emplace_back([
+				&context,
+				&next,
+				&order,
+				&firstError,
+				&m_firstError,
+				compile]
+				{
+					SessionContext::Scope scope(context);
+
+					while (true)
+					{
+						int idx = next++;
+
+						if (scast<size_t>(idx) >= order.size()) break;
+
+						try
+						{
+							compile(order[idx]);
+						}
+						catch (...)
+						{
+							m_firstError.lock();
+							if (!firstError) firstError = current_exception();
+							m_firstError.unlock();
+
+							//stop handing out sources to the other workers
+							next = scast<int>(order.size());
+							break;
+						}
+					}
+				});
+		}
+
+		for (auto& w : workers) w.join();
+
+		FinishGenerators(generatorRun);
+
+		if (firstError) rethrow_exception(firstError);
+	}
+
+	if (!failedSources.empty())
+	{
+		string failedList{};
+		for (const auto& f : failedSources) failedList += "\n    " + f.string();
+
+		KalaMakeCore::CloseOnError(
+			"LANGUAGE_C_CPP",
+			"Found errors in '" + to_string(failedSources.size()) + "' of '" + to_string(sources.size()) + "' sources:" + failedList);
+	}
+
+	return compiledObj;
+}
+
+unordered_map<string, size_t> AddGeneratedSources(
+	const GlobalData& globalData,
+	const vector<BuildAction>& generatorActions,
+	vector<path>& sources)
+{
+	unordered_map<string, size_t> generatedFiles{};
+	unordered_map<string, size_t> sourceIndexes{};
+
+	for (size_t i = 0; i < sources.size(); ++i) sourceIndexes[sources[i].lexically_normal().string()] = i;
+
+	for (size_t g = 0; g < generatorActions.size(); ++g)
+	{
+		for (const auto& o : generatorActions[g].outputs)
+		{
+			string key = o.string();
+			generatedFiles.try_emplace(key, g);
+
+			if (IsSourceFile(globalData.targetProfile.standard, o)
+				&& !sourceIndexes.contains(key))
+			{
+				sourceIndexes[key] = sources.size();
+				sources.push_back(o);
 			}
+		}
+	}
+
+	return generatedFiles;
+}
+
+vector<vector<size_t>> GetGeneratorWaits(
+	const GlobalData& globalData,
+	const vector<path>& sources,
+	const vector<BuildAction>& generatorActions,
+	const unordered_map<string, size_t>& generatedFiles)
+{
+	vector<vector<size_t>> waitsFor(sources.size());
+
+	if (generatorActions.empty()) return waitsFor;
+
+	bool hasGeneratedHeaders = any_of(
+		generatedFiles.begin(),
+		generatedFiles.end(),
+		[&globalData](const auto& f)
+		{
+			return !IsSourceFile(globalData.targetProfile.standard, f.first);
+		});
+
+	unordered_map<string, vector<size_t>> includeCache{};
+
+	for (size_t i = 0; i < sources.size(); ++i)
+	{
+		auto generated = generatedFiles.find(sources[i].lexically_normal().string());
+		if (generated != generatedFiles.end()) waitsFor[i].push_back(generated->second);
+
+		if (hasGeneratedHeaders)
+		{
+			const vector<size_t>& included = FindGeneratedIncludes(
+				sources[i],
+				globalData.targetProfile.headers,
+				generatedFiles,
+				includeCache);
+
+			waitsFor[i].insert(waitsFor[i].end(), included.begin(), included.end());
+		}
+	}
+
+	return waitsFor;
+}
+
+void StartGenerators(
+	const GlobalData& globalData,
+	const vector<string>& generators,
+	GeneratorRun& run)
+{
+	run.isDone.assign(run.actions.size(), false);
+	run.didRun.assign(run.actions.size(), false);
+
+	if (generators.empty()) return;
+
+	Log::Print(
+		"Running '" + to_string(generators.size()) + "' generators alongside compilation.",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_INFO);
+
+	run.runner = thread([
+		&context = SessionContext::Current(),
+		&globalData,
+		&generators,
+		&run]
+		{
+			SessionContext::Scope scope(context);
+
+			try
+			{
+				Action::RunAll(
+					globalData,
+					generators,
+					false,
+					"LANGUAGE_C_CPP",
+					"generator",
+					[&run](size_t index, bool ran)
+					{
+						{
+							lock_guard<mutex> lock(run.m_generators);
+							run.isDone[index] = true;
+							run.didRun[index] = ran;
+						}
+						run.finished.notify_all();
+					});
+			}
+			catch (...)
+			{
+				{
+					lock_guard<mutex> lock(run.m_generators);
+					run.error = current_exception();
+					run.isFailed = true;
+				}
+				run.finished.notify_all();
+			}
+		});
+}
+
+bool WaitForGenerators(
+	GeneratorRun& run,
+	const vector<size_t>& indexes,
+	bool& outIsRegenerated,
+	file_time_type& outNewest)
+{
+	unique_lock<mutex> lock(run.m_generators);
+	run.finished.wait(lock, [&run, &indexes]()
+		{
+			if (run.isFailed) return true;
+
+			for (size_t g : indexes)
+			{
+				if (!run.isDone[g]) return false;
+			}
+			return true;
+		});
+
+	if (run.isFailed) return false;
+
+	for (size_t g : indexes)
+	{
+		if (run.didRun[g]) outIsRegenerated = true;
+
+		for (const auto& o : run.actions[g].outputs)
+		{
+			error_code ec{};
+			file_time_type time = last_write_time(o, ec);
+			if (!ec) outNewest = max(outNewest, time);
+		}
+	}
+
+	return true;
+}
+
+void FinishGenerators(GeneratorRun& run)
+{
+	if (run.runner.joinable()) run.runner.join();
+
+	if (run.error) rethrow_exception(run.error);
+}
+
+vector<LinkResult> LinkTargets(
+	const GlobalData& globalData,
+	const vector<GlobalData>& targets,
+	const vector<path>& objFiles,
+	UsedJobs& usedJobs)
+{
+	vector<LinkResult> linkResults(targets.size(), LinkResult::L_UP_TO_DATE);
+
+	if (targets.size() == 1)
+	{
+		linkResults[0] = LinkOutput(
+			targets[0],
+			objFiles,
+			usedJobs);
+
+		return linkResults;
+	}
+
+	vector<path> outputs{};
+	for (const auto& t : targets)
+	{
+		path outputPath = GetOutputPath(t);
+
+		if (ContainsValue(outputs, outputPath))
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"More than one target of profile '" + globalData.targetProfile.profileName + "' links to '" + outputPath.string() + "'!");
+		}
+
+		outputs.push_back(outputPath);
+	}
+
+	exception_ptr firstError{};
+	mutex m_firstError;
+
+	SessionContext& context = SessionContext::Current();
+
+	vector<thread> linkers{};
+	for (size_t i = 0; i < targets.size(); ++i)
+	{
+		linkers.emplace_back([
+			i,
+			&context,
+			&targets,
+			&linkResults,
+			&objFiles,
+			&usedJobs,
+			&firstError,
+			&m_firstError,
+			projectFileTime = kmakeTime]
+			{
+				SessionContext::Scope scope(context);
+
+				//linker threads have their own thread local kmakeTime
+				kmakeTime = projectFileTime;
+
+				try
+				{
+					linkResults[i] = LinkOutput(
+						targets[i],
+						objFiles,
+						usedJobs);
+				}
+				catch (...)
+				{
+					m_firstError.lock();
+					if (!firstError) firstError = current_exception();
+					m_firstError.unlock();
+				}
+			});
+	}
+
+	for (auto& l : linkers) l.join();
+
+	if (firstError) rethrow_exception(firstError);
+
+	return linkResults;
+}
+
+LinkResult LinkOutput(
+	const GlobalData& globalData,
+	const vector<path>& objFiles,
+	UsedJobs& usedJobs)
+{
+	bool isMSVC =
+		globalData.targetProfile.compiler == CompilerType::C_CL
+		|| globalData.targetProfile.compiler == CompilerType::C_CLANG_CL;
+
+	string frontArg = isMSVC
+		? "/"
+		: "-";
+
+	string sharedArg = globalData.targetProfile.binaryType == BinaryType::B_SHARED
+		? (isMSVC ? "/LD" : "-shared")
+		: string{};
+
+	string command{};
+
+	//set compiler launcher
+
+	if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID
+		&& globalData.targetProfile.binaryType != BinaryType::B_STATIC)
+	{
+		string_view compilerLauncher = Schema::GetValueName(FieldType::T_COMPILER_LAUNCHER, globalData.targetProfile.compilerLauncher);
+
+		command += string(compilerLauncher) + " ";
+	}
+
+	//set compiler
+
+	string compiler{};
+	string targetTriple{};
+
+	if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE
+		|| globalData.targetProfile.binaryType == BinaryType::B_SHARED)
+	{
+		string_view nonStaticCompiler = Schema::GetValueName(FieldType::T_COMPILER, globalData.targetProfile.compiler);
+
+		if (globalData.targetProfile.targetType == TargetType::T_LINUX_GNU)
+		{
+			if (nonStaticCompiler == "gcc")      compiler = target_type_linux_gnu_gcc;
+			else if (nonStaticCompiler == "g++") compiler = target_type_linux_gnu_gpp;
+			else
+			{
+				compiler = nonStaticCompiler;
+				targetTriple = target_type_linux_gnu_clang_zig;
+			}
+		}
+		else if (globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
+		{
+			if (nonStaticCompiler == "gcc")      compiler = target_type_linux_musl_gcc;
+			else if (nonStaticCompiler == "g++") compiler = target_type_linux_musl_gpp;
+			else
+			{
+				compiler = nonStaticCompiler;
+				targetTriple = target_type_linux_musl_clang_zig;
+			}
+		}
+		else if (globalData.targetProfile.targetType == TargetType::T_WINDOWS_GNU)
+		{
+			if (nonStaticCompiler == "gcc")      compiler = target_type_win_gnu_gcc;
+			else if (nonStaticCompiler == "g++") compiler = target_type_win_gnu_gpp;
+			else
+			{
+				compiler = nonStaticCompiler;
+				targetTriple = target_type_win_gnu_clang_zig;
+			}
+		}
+		else
+		{
+			compiler = nonStaticCompiler;
+			if (compiler == "clang"
+				|| compiler == "clang++")
+			{
+				targetTriple = target_type_win_msvc_clang;
+			}
+			else targetTriple = target_type_win_msvc_zig;
+		}
+	}
+	else
+	{
+#ifdef _WIN32
+		compiler = "lib";
+#else
+		compiler = "ar rcs";
+#endif
+	}
+
+	command += compiler;
+
+	if (compiler == "zig")
+	{
+		StandardType standardType = globalData.targetProfile.standard;
+
+		if (standardType == StandardType::C_89
+			|| standardType == StandardType::C_99
+			|| standardType == StandardType::C_11
+			|| standardType == StandardType::C_17
+			|| standardType == StandardType::C_23)
+		{
+			command += " cc";
+		}
+		else if (standardType == StandardType::CPP_14
+			|| standardType == StandardType::CPP_17
+			|| standardType == StandardType::CPP_20
+			|| standardType == StandardType::CPP_23
+			|| standardType == StandardType::CPP_26)
+		{
+			command += " c++";
+		}
+	}
+
+	//-target only for clang/clang++/zig
+	if (!targetTriple.empty()) command += " -target " + targetTriple;
+
+	//set output
+
+	string outputArgFront{};
+	string outputArg{};
+
+	if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE
+		|| globalData.targetProfile.binaryType == BinaryType::B_SHARED)
+	{
+		//link-time shared flag for output
+		outputArgFront = globalData.targetProfile.binaryType == BinaryType::B_SHARED
+			? (isMSVC ? "/LD " : "-shared " )
+			: string{};
+
+		outputArg = isMSVC
+			? "/Fe:"
+			: "-o ";
+	}
+	else
+	{
+		if (compiler == "lib") outputArg = "/OUT:";
+	}
+
+	path buildPath = globalData.targetProfile.buildPath;
+	path outputPath = GetOutputPath(globalData);
+
+	if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE
+		&& !isWindows)
+	{
+		command += " -Wl,-rpath,\\$ORIGIN";
 
-			//always use NDEBUG for release, minsizerel and reldebug
-			if (globalData.targetProfile.buildType != BuildType::B_DEBUG)
+		//shared libraries with microarch variants are found by name, so glibc can pick a variant
+		for (const path& l : globalData.targetProfile.links)
+		{
+			if (l.extension() == ".so"
+				&& exists(l.parent_path() / "glibc-hwcaps"))
 			{
-				finalFlags.push_back("DNDEBUG");
+				command += " -Wl,-rpath,\"" + l.parent_path().string() + "\"";
 			}
+		}
+	}
+	else if (globalData.targetProfile.binaryType == BinaryType::B_SHARED
+		&& isWindows
+		&& (globalData.targetProfile.compiler == CompilerType::C_GCC
+		|| globalData.targetProfile.compiler == CompilerType::C_GPP))
+	{
+		command += " -Wl,--out-implib," + (buildPath / (outputPath.stem().string() + ".lib")).string();
+	}
+
+	command += " " + outputArgFront + outputArg + "\"" + outputPath.string() + "\"";
+
+	//add object files
+	
+	for (const auto& o : objFiles)
+	{
+		command += " \"" + o.string() + "\"";
+	}
 
-			bool generateSymbols = ContainsValue(
-				globalData.targetProfile.customFlags,
-				CustomFlag::F_GENERATE_SYMBOLS);
+	//set links
 
-			switch (globalData.targetProfile.buildType)
+	if (!globalData.targetProfile.links.empty())
+	{
+		for (const path& l : globalData.targetProfile.links)
+		{
+			if (is_directory(l))
 			{
-			case BuildType::B_DEBUG:
+				if (isMSVC) command += " /LIBPATH:\"" + l.string() + "\"";
+				else        command += " -L\"" + l.string() + "\"";
+			}
+			else if (l.has_extension())
 			{
-				if (isMSVC)
-				{
-					finalFlags.push_back("Zi"); //generate full debugging info
-					finalFlags.push_back("Od"); //turn off all code optimizations
-				}
+				if (ContainsAlpha(l.extension().string())) command += " \"" + l.string() + "\"";
 				else
 				{
-					finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
-#ifdef _WIN32
-					finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
-#endif
-					finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
-					finalFlags.push_back("O0"); //turn off all code optimizations
+					if (isMSVC) command += " " + l.string() + ".lib";
+					else        command += " -l" + l.string();
 				}
-				break;
 			}
-			case BuildType::B_RELDEBUG:
+			else
 			{
-				if (isMSVC)
-				{
-					finalFlags.push_back("Zi"); //generate full debugging info
-					finalFlags.push_back("O2"); //full speed optimization
-					finalFlags.push_back("Oy-"); //force MSVC to preseve stack frame structures
-				}
-				else
-				{
-					finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
-#ifdef _WIN32
-					finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
-#endif
-					finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
-					finalFlags.push_back("O2"); //full speed optimization
-				}
-				break;
+				if (isMSVC) command += " " + l.string() + ".lib";
+				else        command += " -l" + l.string();
+			}
+		}
+	}
+
+	//set link flags
+
+	vector<string> finalFlags = globalData.targetProfile.linkFlags;
+
+	//llvm-bolt needs the relocations to move code inside and between functions
+	if (!globalData.targetProfile.boltWorkload.empty()
+		&& globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE)
+	{
+		finalFlags.push_back("Wl,--emit-relocs");
+	}
+
+	if (globalData.targetProfile.binaryType != BinaryType::B_STATIC)
+	{
+		//instrumented objects need the profiling runtime, static archives are never linked
+		for (const auto& f : globalData.targetProfile.compileFlags)
+		{
+			if (f.starts_with(pgoGenerateFlag)) finalFlags.push_back(f);
+		}
+
+		if (isMSVC)
+		{
+			if (globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_DEBUG
+				|| globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_RELDEBUG
+				|| ContainsValue(globalData.targetProfile.customFlags, CustomFlag::F_GENERATE_SYMBOLS))
+			{
+				finalFlags.push_back("DEBUG");
 			}
-			case BuildType::B_RELEASE:
+			else finalFlags.push_back("RELEASE");
+		}
+		else
+		{
+			if (globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_DEBUG
+				|| globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_RELDEBUG
+				|| ContainsValue(globalData.targetProfile.customFlags, CustomFlag::F_GENERATE_SYMBOLS))
 			{
-				if (isMSVC)
+				finalFlags.push_back("g");
+
+				if (globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
+					|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
 				{
-					if (generateSymbols) finalFlags.push_back("Zi"); //generate full debugging info
-					finalFlags.push_back("O2"); //full speed optimization
-					if (generateSymbols) finalFlags.push_back("Oy-"); //force MSVC to preseve stack frame structures
+					finalFlags.push_back("rdynamic");
 				}
-				else
-				{
-					if (generateSymbols)
-					{
-						finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
+			}
+		}
+	}
+
 #ifdef _WIN32
-						finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
+	if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE
+		&& ContainsValue(globalData.targetProfile.customFlags, CustomFlag::F_NO_CONSOLE))
+	{
+		if (isMSVC)
+		{
+			finalFlags.push_back("SUBSYSTEM:WINDOWS");
+			finalFlags.push_back("ENTRY:mainCRTStartup");
+		}
+		else finalFlags.push_back("Wl,-subsystem:windows,-entry:mainCRTStartup");
+	}
 #endif
-						finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
-					}
-					finalFlags.push_back("O2"); //full speed optimization
-				}
-				break;
-			}
-			case BuildType::B_MINSIZEREL:
+
+	if (isMSVC
+		&& !finalFlags.empty())
+	{
+		finalFlags.insert(finalFlags.begin(), "link");
+	}
+
+	RemoveDuplicates(finalFlags);
+	for (const auto& f : finalFlags)
+	{
+		command += " " + frontArg + f;
+	}
+
+	//link
+
+	Log::Print("===========================================================================\n");
+
+	bool sameContent{};
+
+	if (NeedsLink(globalData, outputPath, objFiles, sameContent))
+	{
+		Log::Print(
+			"Starting to link via '" + command + "'.",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_INFO);
+
+		Log::Print(" ");
+
+		//links often run alone at the end of a build, pin-links keeps them off efficiency cores
+		if (!RunMeasured(
+			command,
+			outputPath,
+			ContainsValue(globalData.targetProfile.customFlags, CustomFlag::F_PIN_LINKS),
+			usedJobs))
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Failed to link '" + outputPath.string() + "'!");
+		}
+
+		if (isWindows
+			&& globalData.targetProfile.binaryType == BinaryType::B_SHARED
+			&& globalData.targetProfile.compiler == CompilerType::C_ZIG)
+		{
+			for (auto& f : directory_iterator(globalData.targetProfile.buildPath))
 			{
-				if (isMSVC)
-				{
-					if (generateSymbols) finalFlags.push_back("Zi"); //generate full debugging info
-					finalFlags.push_back("O1"); //size optimization
-					if (generateSymbols) finalFlags.push_back("Oy-"); //force MSVC to preseve stack frame structures
-				}
-				else
+				path file = path(f);
+				if (file.extension() == ".lib")
 				{
-					if (generateSymbols)
+					string err = RenamePath(file, globalData.targetProfile.binaryName + ".lib");
+					if (!err.empty())
 					{
-						finalFlags.push_back("g"); //full symbols for GCC, CLang and Zig
-#ifdef _WIN32
-						finalFlags.push_back("gcodeview"); //generate Microsoft format debug data
-#endif
-						finalFlags.push_back("fno-omit-frame-pointer"); //allows to trace the exact function and script line that caused an error
+						KalaMakeCore::CloseOnError(
+							"LANGUAGE_C_CPP",
+							"Failed to rename Zig-created lib! Reason: " + err);
 					}
-					finalFlags.push_back("Os"); //size optimization
 				}
-				break;
 			}
+		}
 
-			default: break;
-			}
+		if (outputPath.extension() == ".so") WriteInterface(outputPath);
 
-			switch (globalData.targetProfile.warningLevel)
-			{
-			case WarningLevel::W_BASIC:
-			{
-				if (isMSVC) finalFlags.push_back("W1");
-				else        finalFlags.push_back("Wall");
-				break;
-			}
-			case WarningLevel::W_NORMAL:
+		WriteInputHashes(globalData, outputPath, objFiles);
+
+		Log::Print(
+			"Finished linking to output '" + outputPath.string() + "'!",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_SUCCESS);
+
+		return LinkResult::L_LINKED;
+	}
+
+	if (sameContent)
+	{
+		Log::Print(
+			"Skipping linking of output '" + outputPath.string() + "' because its recompiled objects and links did not change.",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_INFO);
+
+		return LinkResult::L_SAME_CONTENT;
+	}
+
+	Log::Print(
+		"Skipping linking of output '" + outputPath.string() + "' because there are no new object files.",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_INFO);
+
+	return LinkResult::L_UP_TO_DATE;
+}
+
+bool NeedsLink(
+	const GlobalData& globalData,
+	const path& output,
+	const vector<path>& objects,
+	bool& outSameContent)
+{
+	if (!exists(output)) return true;
+
+	file_time_type exeTime = last_write_time(output);
+
+	if (exeTime < kmakeTime) return true;
+
+	vector<path> newerInputs{};
+
+	for (const auto& o : objects)
+	{
+		if (!exists(o)) return true;
+
+		if (last_write_time(o) > exeTime) newerInputs.push_back(o);
+	}
+
+	for (const auto& l : globalData.targetProfile.links)
+	{
+		if (exists(l)
+			&& last_write_time(l) > exeTime)
+		{
+			newerInputs.push_back(l);
+		}
+	}
+
+	if (newerInputs.empty()) return false;
+
+	unordered_map<string, LinkInput> inputHashes = ReadInputHashes(output);
+	if (inputHashes.empty()) return true;
+
+	//inputs still at the time they had when they were last found identical are not hashed again
+	vector<path> changedInputs{};
+	vector<i64> changedTimes{};
+
+	for (const auto& i : newerInputs)
+	{
+		auto it = inputHashes.find(i.string());
+		if (it == inputHashes.end()) return true;
+
+		i64 time = GetInputTime(i);
+		if (it->second.time == time) continue;
+
+		changedInputs.push_back(i);
+		changedTimes.push_back(time);
+	}
+
+	//every newer input was already found identical by an earlier build, nothing was recompiled since
+	if (changedInputs.empty()) return false;
+
+	outSameContent = true;
+
+	vector<u64> newerHashes{};
+	newerHashes.resize(changedInputs.size());
+
+	Walker::ForEach(
+		changedInputs.size(),
+		[&changedInputs, &newerHashes](size_t i)
+		{
+			newerHashes[i] = Snapshot::HashFile(GetLinkInput(changedInputs[i]));
+		});
+
+	for (size_t i = 0; i < changedInputs.size(); ++i)
+	{
+		LinkInput& input = inputHashes[changedInputs[i].string()];
+		if (input.hash != newerHashes[i]) return true;
+
+		input.time = changedTimes[i];
+	}
+
+	//like a restat, the next build compares the new times instead of hashing these inputs again
+	SaveInputHashes(output, inputHashes);
+
+	return false;
+}
+
+bool RunPostLink(
+	const GlobalData& globalData,
+	const vector<GlobalData>& targets,
+	vector<LinkResult>& linkResults,
+	const UsedJobs& usedJobs)
+{
+	if (!globalData.targetProfile.boltWorkload.empty())
+	{
+		for (size_t i = 0; i < targets.size(); ++i)
+		{
+			if (targets[i].targetProfile.binaryType != BinaryType::B_EXECUTABLE) continue;
+
+			//a new layout is a new binary for the post build actions
+			if (OptimizeWithBolt(
+				targets[i],
+				linkResults[i] == LinkResult::L_LINKED))
 			{
-				if (isMSVC) finalFlags.push_back("W3");
-				else
-				{
-					finalFlags.push_back("Wall");
-					finalFlags.push_back("Wextra");
-				}
-				break;
+				linkResults[i] = LinkResult::L_LINKED;
 			}
-			case WarningLevel::W_STRONG:
+		}
+	}
+
+	if (!usedJobs.jobs.empty())
+	{
+		JobPool::PrintUsage(usedJobs.jobs, "LANGUAGE_C_CPP");
+
+		string errorMsg = JobPool::SaveUsage(
+			JobPool::GetUsagePath(
+				globalData.targetProfile.buildPath,
+				globalData.targetProfile.profileName),
+			usedJobs.jobs);
+
+		if (!errorMsg.empty())
+		{
+			Log::Print(
+				"Failed to save job usage! Reason: " + errorMsg,
+				"LANGUAGE_C_CPP",
+				LogType::LOG_WARNING);
+		}
+	}
+
+	bool relinked{};
+	for (LinkResult r : linkResults)
+	{
+		if (r == LinkResult::L_LINKED) relinked = true;
+	}
+
+	//each action decides for itself, relink actions skip and declared actions check their outputs
+	if (!globalData.targetProfile.postBuildActions.empty())
+	{
+		Log::Print("\n===========================================================================\n");
+
+		Log::Print(
+			"Starting to run post build actions.",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_INFO);
+
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.postBuildActions,
+			relinked,
+			"LANGUAGE_C_CPP",
+			"post build");
+
+		Log::Print(" ");
+
+		Log::Print(
+			"Finished all post build actions!",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_SUCCESS);
+	}
+
+	return relinked;
+}
+
+void CompilePGO(const GlobalData& globalData)
+{
+	//gcc writes a gcda file next to each object, clang writes profraw files that are merged into one file
+	bool isGCC =
+		globalData.targetProfile.compiler == CompilerType::C_GCC
+		|| globalData.targetProfile.compiler == CompilerType::C_GPP;
+
+	const path& buildPath = globalData.targetProfile.buildPath;
+	path generatePath = buildPath / pgoGenerateFolderName;
+	path mergedPath = buildPath / pgoMergedName;
+
+	path dataPath = isGCC
+		? generatePath / objFolderName
+		: buildPath / pgoDataFolderName;
+
+	string_view dataExtension = isGCC
+		? ".gcda"
+		: ".profraw";
+
+	auto quoted = [](string_view flag, const path& target) -> string
+		{
+			return string(flag) + "\"" + target.string() + "\"";
+		};
+
+	//profile data files of a directory and the newest of their times, min if there are none
+	auto find_data = [&dataExtension](
+		const path& dir,
+		vector<path>& outFiles) -> file_time_type
+		{
+			file_time_type newest = file_time_type::min();
+
+			error_code ec{};
+			if (!is_directory(dir, ec)) return newest;
+
+			for (const auto& f : directory_iterator(dir))
 			{
-				if (isMSVC) finalFlags.push_back("W4");
-				else
-				{
-					finalFlags.push_back("Wall");
-					finalFlags.push_back("Wextra");
-					finalFlags.push_back("Wpedantic");
-				}
-				break;
+				const path& file = f.path();
+				if (file.extension() != dataExtension) continue;
+
+				newest = max(newest, last_write_time(file));
+				outFiles.push_back(file);
 			}
-			case WarningLevel::W_STRICT:
+
+			return newest;
+		};
+
+	//
+	// INSTRUMENTED BUILD
+	//
+
+	GlobalData instrumented = globalData;
+	ProfileData& instrumentedProfile = instrumented.targetProfile;
+
+	instrumentedProfile.buildPath = generatePath;
+	instrumentedProfile.postBuildActions.clear();
+	instrumentedProfile.boltWorkload.clear();
+
+	//only the optimized build exports project files
+	erase(instrumentedProfile.customFlags, CustomFlag::F_EXPORT_COMPILE_COMMANDS);
+	erase(instrumentedProfile.customFlags, CustomFlag::F_EXPORT_VSCODE_SLN);
+
+	string generateFlag = isGCC
+		? string(pgoGenerateFlag)
+		: quoted(string(pgoGenerateFlag) + "=", dataPath);
+
+	//the link adds it to executables and shared libraries, archivers reject it
+	instrumentedProfile.compileFlags.push_back(generateFlag);
+
+	Log::Print(
+		"Starting to build the instrumented variant of profile '" + globalData.targetProfile.profileName + "' into '" + generatePath.string() + "'.",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_INFO);
+
+	Log::Print("\n===========================================================================\n");
+
+	bool relinked = Compile_Final(instrumented);
+
+	//
+	// TRAINING
+	//
+
+	vector<path> usedData{};
+	bool hasData = isGCC
+		? find_data(buildPath / objFolderName, usedData) != file_time_type::min()
+		: exists(mergedPath);
+
+	Log::Print("\n===========================================================================\n");
+
+	if (!relinked
+		&& hasData)
+	{
+		Log::Print(
+			"Skipping training because the instrumented binaries did not change.",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_INFO);
+	}
+	else
+	{
+		//counts of older binaries would be added to the new ones
+		vector<path> oldData{};
+		find_data(dataPath, oldData);
+
+		for (const auto& f : oldData)
+		{
+			string errorMsg = DeletePath(f);
+			if (!errorMsg.empty())
 			{
-				if (isMSVC)
-				{
-					finalFlags.push_back("W4");
-					finalFlags.push_back("permissive-");
-				}
-				else
-				{
-					finalFlags.push_back("Wall");
-					finalFlags.push_back("Wextra");
-					finalFlags.push_back("Wpedantic");
-					finalFlags.push_back("Wconversion");
-					finalFlags.push_back("Wsign-conversion");
-				}
-				break;
+				KalaMakeCore::CloseOnError(
+					"LANGUAGE_C_CPP",
+					"Failed to remove old profile data '" + f.string() + "'! Reason: " + errorMsg);
 			}
-			case WarningLevel::W_ALL:
+		}
+
+		Log::Print(
+			"Starting to run training commands.",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_INFO);
+
+		Action::RunAll(
+			instrumented,
+			globalData.targetProfile.pgoTraining,
+			true,
+			"LANGUAGE_C_CPP",
+			"training");
+
+		vector<path> dataFiles{};
+		find_data(dataPath, dataFiles);
+
+		if (dataFiles.empty())
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Training did not write any profile data to '" + dataPath.string() + "'! Training commands must run the instrumented binaries.");
+		}
+
+		//files that end up with the same bytes keep their time,
+		//so training that produced the same counts does not rebuild the optimized objects
+		auto replace_if_changed = [](
+			const path& source,
+			const path& target) -> void
 			{
-				if (isMSVC) finalFlags.push_back("Wall");
-				else if (globalData.targetProfile.compiler == CompilerType::C_CLANG
-						|| globalData.targetProfile.compiler == CompilerType::C_CLANGPP
-						|| globalData.targetProfile.compiler == CompilerType::C_ZIG)
+				if (exists(target)
+					&& Snapshot::HashFile(source) == Snapshot::HashFile(target))
 				{
-					finalFlags.push_back("Weverything");
+					return;
 				}
-				else
+
+				error_code ec{};
+				copy_file(source, target, copy_options::overwrite_existing, ec);
+
+				if (ec)
 				{
-					finalFlags.push_back("Wall");
-					finalFlags.push_back("Wextra");
-					finalFlags.push_back("Wpedantic");
-					finalFlags.push_back("Wconversion");
-					finalFlags.push_back("Wsign-conversion");
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_C_CPP",
+						"Failed to copy profile data to '" + target.string() + "'! Reason: " + ec.message());
 				}
-				break;
-			}
+			};
 
-			default: break;
-			}
+		if (isGCC)
+		{
+			//gcc looks for the gcda file next to the object it compiles
+			path objPath = buildPath / objFolderName;
 
-			RemoveDuplicates(finalFlags);
-			for (const auto& f : finalFlags)
+			if (!exists(objPath))
 			{
-				command += " " + frontArg + f;
+				string errorMsg = CreateNewDirectory(objPath);
+				if (!errorMsg.empty())
+				{
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_C_CPP",
+						"Failed to create new obj dir for profile data! Reason: " + errorMsg);
+				}
 			}
 
-			//set defines
+			for (const auto& f : dataFiles) replace_if_changed(f, objPath / f.filename());
+		}
+		else
+		{
+			path newMergedPath = dataPath / pgoMergedName;
+
+			string command = "llvm-profdata merge " + quoted("-output=", newMergedPath);
+			for (const auto& f : dataFiles) command += " \"" + f.string() + "\"";
 
-			string defineArg = frontArg + "D";
+			Log::Print(
+				"Starting to merge profile data via '" + command + "'.",
+				"LANGUAGE_C_CPP",
+				LogType::LOG_INFO);
 
-			for (const auto& d : globalData.targetProfile.defines)
+			if (JobPool::Run(command) != 0)
 			{
-				command += " " + defineArg + d;
+				KalaMakeCore::CloseOnError(
+					"LANGUAGE_C_CPP",
+					"Failed to merge profile data to '" + newMergedPath.string() + "'!");
 			}
 
-			//set headers
+			replace_if_changed(newMergedPath, mergedPath);
+		}
+
+		Log::Print(
+			"Finished training with '" + to_string(dataFiles.size()) + "' profile data files!",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_SUCCESS);
+	}
+
+	//
+	// OPTIMIZED BUILD
+	//
+
+	GlobalData optimized = globalData;
+	ProfileData& optimizedProfile = optimized.targetProfile;
+
+	//plain pre build actions already ran for the instrumented build, generators are up to date
+	erase_if(optimizedProfile.preBuildActions, [](const string& a) { return !Action::IsGenerator(a); });
+
+	AddProfileUseFlags(optimizedProfile);
+
+	if (isGCC)
+	{
+		usedData.clear();
+		profileDataTime = find_data(buildPath / objFolderName, usedData);
+	}
+	else profileDataTime = last_write_time(mergedPath);
+
+	Log::Print("\n===========================================================================\n");
+
+	Log::Print(
+		"Starting to build profile '" + globalData.targetProfile.profileName + "' with its profile data.",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_INFO);
+
+	Log::Print("\n===========================================================================\n");
+
+	Compile_Final(optimized);
+}
+
+void CompileVariants(const GlobalData& globalData)
+{
+	vector<string> levels = GetMicroarchLevels(globalData.targetProfile);
+	vector<GlobalData> variants = GetMicroarchVariants(globalData);
+
+	const path& buildPath = globalData.targetProfile.buildPath;
 
-			if (!globalData.targetProfile.headers.empty())
+	//glibc loads the best level of a shared library it finds in glibc-hwcaps next to it,
+	//which checks the cpu once at startup so nothing else has to dispatch
+	bool useHWCaps =
+		globalData.targetProfile.binaryType == BinaryType::B_SHARED
+		&& globalData.targetProfile.targetType == TargetType::T_LINUX_GNU;
+
+	bool hasGenerators = any_of(
+		globalData.targetProfile.preBuildActions.begin(),
+		globalData.targetProfile.preBuildActions.end(),
+		[](const string& a) { return Action::IsGenerator(a); });
+
+	Log::Print(
+		"Compiling profile '" + globalData.targetProfile.profileName + "' for '" + to_string(levels.size()) + "' microarch levels.",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_INFO);
+
+	Log::Print("\n===========================================================================\n");
+
+	//generators write the same files for every level, so they run with the lowest level
+	//before the other levels start and find them up to date
+	size_t firstParallel = hasGenerators ? 1 : 0;
+	for (size_t i = 0; i < firstParallel; ++i) Compile_Final(variants[i]);
+
+	//variants share the jobs of the profile unless a workspace already limits all jobs
+	u16 oldCapacity = JobPool::GetCapacity();
+	if (oldCapacity == 0) JobPool::SetCapacity(globalData.targetProfile.jobs);
+
+	exception_ptr firstError{};
+	mutex m_firstError;
+
+	SessionContext& context = SessionContext::Current();
+
+	vector<thread> builders{};
+	for (size_t i = firstParallel; i < variants.size(); ++i)
+	{
+		builders.emplace_back([
+			&context,
+			&variant = variants[i],
+			&firstError,
+			&m_firstError]
 			{
-				for (const auto& h : globalData.targetProfile.headers)
+				SessionContext::Scope scope(context);
+
+				profileDataTime = file_time_type::min();
+
+				try
 				{
-					command += " " + frontArg + "I\"" + h.string() + "\"";
+					Compile_Final(variant);
 				}
-			}
+				catch (...)
+				{
+					m_firstError.lock();
+					if (!firstError) firstError = current_exception();
+					m_firstError.unlock();
+				}
+			});
+	}
 
-			//compile
+	for (auto& b : builders) b.join();
 
-			path buildPath = globalData.targetProfile.buildPath / objFolderName;
+	if (oldCapacity == 0) JobPool::SetCapacity(0);
 
-			if (!exists(buildPath))
+	if (firstError) rethrow_exception(firstError);
+
+	if (useHWCaps)
+	{
+		for (size_t i = 1; i < variants.size(); ++i)
+		{
+			path output = GetOutputPath(variants[i]);
+			path hwcapsPath = buildPath / "glibc-hwcaps" / levels[i];
+			path target = hwcapsPath / output.filename();
+
+			if (exists(target)
+				&& Snapshot::HashFile(output) == Snapshot::HashFile(target))
 			{
-				string errorMsg = CreateNewDirectory(buildPath);
+				continue;
+			}
+
+			if (!exists(hwcapsPath))
+			{
+				string errorMsg = CreateNewDirectory(hwcapsPath);
 				if (!errorMsg.empty())
 				{
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_C_CPP",
-						"Failed to create new obj dir for compilation! Reason: " + errorMsg);
+						"Failed to create glibc-hwcaps dir '" + hwcapsPath.string() + "'! Reason: " + errorMsg);
 				}
 			}
 
-			string binaryName = globalData.targetProfile.binaryName;
+			error_code ec{};
+			copy_file(output, target, copy_options::overwrite_existing, ec);
 
-			string extension = isMSVC
-				? ".obj"
-				: ".o";
+			if (ec)
+			{
+				KalaMakeCore::CloseOnError(
+					"LANGUAGE_C_CPP",
+					"Failed to copy '" + output.string() + "' to '" + target.string() + "'! Reason: " + ec.message());
+			}
+		}
+	}
+
+	Log::Print(
+		"Finished compiling profile '" + globalData.targetProfile.profileName + "' for '" + to_string(levels.size()) + "' microarch levels!",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_SUCCESS);
+}
+
+vector<string> GetMicroarchLevels(const ProfileData& profile)
+{
+	vector<string> levels = profile.microarch;
+
+	//level names sort from the baseline up
+	sort(levels.begin(), levels.end());
+	levels.erase(unique(levels.begin(), levels.end()), levels.end());
+
+	return levels;
+}
+
+vector<GlobalData> GetMicroarchVariants(const GlobalData& globalData)
+{
+	vector<string> levels = GetMicroarchLevels(globalData.targetProfile);
+
+	bool useHWCaps =
+		globalData.targetProfile.binaryType == BinaryType::B_SHARED
+		&& globalData.targetProfile.targetType == TargetType::T_LINUX_GNU;
+
+	vector<GlobalData> variants{};
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		GlobalData& variant = variants.emplace_back(globalData);
+		ProfileData& profile = variant.targetProfile;
+
+		//zig names cpu models with underscores
+		string level = levels[i];
+		if (profile.compiler == CompilerType::C_ZIG) replace(level.begin(), level.end(), '-', '_');
+
+		profile.compileFlags.push_back("march=" + level);
+
+		//binaries linking any variant record only its name, which glibc then looks up in glibc-hwcaps
+		if (useHWCaps) profile.linkFlags.push_back("Wl,-soname," + GetOutputPath(globalData).filename().string());
+
+		if (i == 0) continue;
+
+		profile.buildPath = globalData.targetProfile.buildPath / levels[i];
+		profile.postBuildActions.clear();
+
+		erase(profile.customFlags, CustomFlag::F_EXPORT_COMPILE_COMMANDS);
+		erase(profile.customFlags, CustomFlag::F_EXPORT_VSCODE_SLN);
+
+		erase_if(profile.preBuildActions, [](const string& a) { return !Action::IsGenerator(a); });
+	}
+
+	return variants;
+}
+
+bool AddProfileUseFlags(ProfileData& profile)
+{
+	const path& buildPath = profile.buildPath;
+
+	if (profile.compiler == CompilerType::C_GCC
+		|| profile.compiler == CompilerType::C_GPP)
+	{
+		profile.compileFlags.push_back("fprofile-use");
+
+		//sources the training never reached have no gcda file
+		profile.compileFlags.push_back("Wno-missing-profile");
+
+		//gcc finds the gcda file that was copied next to each object by the object path
+		error_code ec{};
+		if (!is_directory(buildPath / objFolderName, ec)) return false;
+
+		for (const auto& f : directory_iterator(buildPath / objFolderName))
+		{
+			if (f.path().extension() == ".gcda") return true;
+		}
+
+		return false;
+	}
+
+	path mergedPath = buildPath / pgoMergedName;
+	profile.compileFlags.push_back("fprofile-use=\"" + mergedPath.string() + "\"");
+
+	return exists(mergedPath);
+}
+
+bool OptimizeWithBolt(
+	const GlobalData& globalData,
+	bool isLinked)
+{
+	path outputPath = GetOutputPath(globalData);
+
+	path linkedPath = outputPath;
+	linkedPath += preBoltExtension;
+
+	path profilePath = outputPath;
+	profilePath += boltProfileExtension;
+
+	auto close_if_failed = [](const string& errorMsg, const string& reason) -> void
+		{
+			if (errorMsg.empty()) return;
+
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				reason + " Reason: " + errorMsg);
+		};
+
+	Log::Print("\n===========================================================================\n");
 
-			//compile-time shared flag for object file
-			if (!isMSVC
-				&& !isWindows
-				&& globalData.targetProfile.binaryType == BinaryType::B_SHARED)
+	if (isLinked)
+	{
+		//llvm-bolt always starts from the linked executable, the output is rewritten by every run
+		if (exists(linkedPath)) close_if_failed(DeletePath(linkedPath), "Failed to remove old executable '" + linkedPath.string() + "'!");
+
+		close_if_failed(
+			RenamePath(outputPath, linkedPath.filename().string()),
+			"Failed to keep linked executable '" + linkedPath.string() + "'!");
+	}
+	else
+	{
+		//the workload lives in the kmake file, so a newer kmake file means a new profile
+		error_code ec{};
+		file_time_type profileTime = last_write_time(profilePath, ec);
+
+		bool isCurrent =
+			!ec
+			&& exists(outputPath)
+			&& exists(linkedPath)
+			&& profileTime >= kmakeTime
+			&& profileTime >= last_write_time(linkedPath);
+
+		if (isCurrent)
+		{
+			Log::Print(
+				"Skipping llvm-bolt for '" + outputPath.string() + "' because neither the executable nor its workload changed.",
+				"LANGUAGE_C_CPP",
+				LogType::LOG_INFO);
+
+			return false;
+		}
+
+		if (!exists(linkedPath))
+		{
+			KalaMakeCore::CloseOnError(
+				"LANGUAGE_C_CPP",
+				"Linked executable '" + linkedPath.string() + "' for llvm-bolt is missing! Clean the build path and compile again.");
+		}
+	}
+
+	auto run = [](const string& command, const string& failMessage) -> void
+		{
+			Log::Print(
+				"Starting to run '" + command + "'.",
+				"LANGUAGE_C_CPP",
+				LogType::LOG_INFO);
+
+			if (JobPool::Run(command) != 0)
 			{
-				command += " -fPIC";
+				KalaMakeCore::CloseOnError(
+					"LANGUAGE_C_CPP",
+					failMessage);
 			}
+		};
 
-			command += " " + frontArg + "c";
-			string objFront = isMSVC
-				? "/Fo:"
-				: "-o";
+	auto quoted = [](const path& target) -> string
+		{
+			return "\"" + target.string() + "\"";
+		};
+
+	string workload = Action::Resolve(
+		globalData,
+		{ globalData.targetProfile.boltWorkload },
+		"LANGUAGE_C_CPP",
+		"bolt workload")[0].command;
+
+	if (exists(profilePath)) close_if_failed(DeletePath(profilePath), "Failed to remove old profile '" + profilePath.string() + "'!");
 
-			vector<path> compiledObj{};
-			mutex m_compiledObj;
+	//the executable being profiled never takes the output path, a failed step
+	//leaves the output missing or at its last optimized binary instead of shipping it
+	path profiledPath = outputPath;
+	profiledPath += profiledExtension;
 
-			kmakeTime = last_write_time(globalData.projectFile);
-			file_time_type newestHeaderTime = file_time_type::min();
-			for (const auto& dir : globalData.targetProfile.headers)
+	path boltedPath = outputPath;
+	boltedPath += ".bolt";
+
+	string runWorkload = "export " + string(boltBinaryVariable) + "=" + quoted(profiledPath) + " && ";
+
+	try
+	{
+		//
+		// PROFILE
+		//
+
+		bool isProfiled{};
+
+		if (JobPool::Run("perf --version > /dev/null 2>&1") == 0)
+		{
+			error_code ec{};
+			copy_file(linkedPath, profiledPath, copy_options::overwrite_existing, ec);
+			if (ec) close_if_failed(ec.message(), "Failed to copy linked executable to '" + profiledPath.string() + "'!");
+
+			path perfPath = outputPath;
+			perfPath += perfDataExtension;
+
+			//branch records give llvm-bolt the taken edges, not every machine has them
+			string record = runWorkload + "perf record -e cycles:u -j any,u -o " + quoted(perfPath) + " -- " + workload;
+
+			Log::Print(
+				"Starting to profile the workload via '" + record + "'.",
+				"LANGUAGE_C_CPP",
+				LogType::LOG_INFO);
+
+			if (JobPool::Run(record) == 0)
 			{
-				for (const auto& entry : recursive_directory_iterator(dir))
-				{
-					if (!entry.is_regular_file()) continue;
+				run(
+					"perf2bolt -p " + quoted(perfPath) + " -o " + quoted(profilePath) + " " + quoted(profiledPath),
+					"Failed to convert perf profile '" + perfPath.string() + "' for llvm-bolt!");
+
+				isProfiled = true;
+			}
+			else
+			{
+				Log::Print(
+					"Failed to record the workload with perf, profiling an instrumented executable instead.",
+					"LANGUAGE_C_CPP",
+					LogType::LOG_WARNING);
+			}
+		}
 
-					const path& p = entry.path();
-					const path& ext = p.extension();
+		if (!isProfiled)
+		{
+			run(
+				"llvm-bolt " + quoted(linkedPath) + " -instrument -instrumentation-file=" + quoted(profilePath) + " -o " + quoted(profiledPath),
+				"Failed to instrument '" + linkedPath.string() + "' with llvm-bolt!");
 
-					if (ext == ".h"
-						|| ext == ".hpp")
-					{
-						newestHeaderTime = max(
-							newestHeaderTime,
-							last_write_time(p));
-					}
-				}
+			run(
+				runWorkload + workload,
+				"Failed to run bolt workload '" + workload + "'!");
+
+			if (!exists(profilePath))
+			{
+				KalaMakeCore::CloseOnError(
+					"LANGUAGE_C_CPP",
+					"Bolt workload did not write a profile to '" + profilePath.string() + "'! The workload must run the executable in $" + string(boltBinaryVariable) + ".");
 			}
+		}
 
-			auto needs_compile = [&newestHeaderTime](
-				const path& source,
-				const path& object
-				) -> bool
-				{
-					if (!exists(object)) return true;
-
-					const file_time_type objTime = last_write_time(object);
-					const file_time_type srcTime = last_write_time(source);
-
-					return objTime < kmakeTime
-						|| objTime < srcTime
-						|| objTime < newestHeaderTime;
-				};
-
-			auto generate = [
-				&globalData,
-				&buildPath,
-				&extension,
-				&command,
-				&objFront]() -> void
-				{
-					if (ContainsValue(globalData.targetProfile.customFlags,CustomFlag::F_EXPORT_COMPILE_COMMANDS))
-					{
-						path fullBuildPath = buildPath.is_absolute()
-							? buildPath
-							: current_path() / buildPath;
+		//
+		// OPTIMIZE
+		//
 
-						for (size_t i = 0; i < globalData.targetProfile.sources.size(); i++)
-						{
-							const path& s = globalData.targetProfile.sources[i];
-
-							path objPath = fullBuildPath / (s.stem().string() + extension);
-							
-							string perFileCommand = command;
-
-							perFileCommand += " \"" + s.string() + "\"";
-							perFileCommand += " " + objFront + " \"" + objPath.string() + "\"";
-
-							commands.push_back(
-							{
-								.dir = globalData.projectFile.parent_path(),
-								.command = RemoveFromString(perFileCommand, "\"", true),
-								.file = s,
-								.output = objPath.string()
-							});
-						}
-					}
+		run(
+			"llvm-bolt " + quoted(linkedPath)
+			+ " -o " + quoted(boltedPath)
+			+ " -data=" + quoted(profilePath)
+			+ " -reorder-blocks=ext-tsp -reorder-functions=hfsort -split-functions -split-all-cold -split-eh -dyno-stats",
+			"Failed to optimize '" + outputPath.string() + "' with llvm-bolt!");
+	}
+	catch (...)
+	{
+		//a profile left behind would be newer than the executable and skip llvm-bolt next time
+		if (exists(profilePath))  DeletePath(profilePath);
+		if (exists(profiledPath)) DeletePath(profiledPath);
+		if (exists(boltedPath))   DeletePath(boltedPath);
 
-					GenerateSteps(globalData);
-				};
-
-			auto compile = [
-				&globalData,
-				&buildPath,
-				&extension,
-				&command,
-				&objFront,
-				needs_compile,
-				&compiledObj,
-				&m_compiledObj]
-				(int targetIndex) -> void
-				{
-					const path& s = globalData.targetProfile.sources[targetIndex];
+		throw;
+	}
 
-					path objPath = buildPath / (s.stem().string() + extension);
-					
-					string perFileCommand = command;
+	if (exists(profiledPath)) close_if_failed(DeletePath(profiledPath), "Failed to remove profiled executable '" + profiledPath.string() + "'!");
+	if (exists(outputPath))   close_if_failed(DeletePath(outputPath), "Failed to remove old executable '" + outputPath.string() + "'!");
 
-					perFileCommand += " \"" + s.string() + "\"";
-					perFileCommand += " " + objFront + " \"" + objPath.string() + "\"";
+	close_if_failed(
+		RenamePath(boltedPath, outputPath.filename().string()),
+		"Failed to replace '" + outputPath.string() + "' with its optimized executable!");
 
-					if (needs_compile(s, objPath))
-					{
-						Log::Print(
-							"Starting to compile via '" + perFileCommand + "'.",
-							"LANGUAGE_C_CPP",
-							LogType::LOG_INFO);
-							
-						if (system(perFileCommand.c_str()) != 0)
-						{
-							KalaMakeCore::CloseOnError(
-								"LANGUAGE_C_CPP",
-								"Failed to compile object file '" + objPath.string() + "'!");
-						}
-					}
-					else
-					{
-						Log::Print(
-							"Skipping compilation of object file '" + objPath.string() + "' because it is newer than its source and header files.\n",
-							"LANGUAGE_C_CPP",
-							LogType::LOG_INFO);
-					}
+	Log::Print(
+		"Finished optimizing '" + outputPath.string() + "' with llvm-bolt!",
+		"LANGUAGE_C_CPP",
+		LogType::LOG_SUCCESS);
 
-					m_compiledObj.lock();
-					compiledObj.push_back(objPath);
-					m_compiledObj.unlock();
-				};
+	return true;
+}
+
+path GetOutputPath(const GlobalData& globalData)
+{
+	path buildPath = globalData.targetProfile.buildPath;
+	string binaryName = globalData.targetProfile.binaryName;
+
+	string extension{};
+	if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE)
+	{
+		if ((!isWindows
+			&& globalData.targetProfile.targetType == TargetType::T_INVALID)
+			|| globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
+			|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
+		{
+			if (binaryName.ends_with(".exe")) binaryName.resize(binaryName.size() - 4);
+		}
+		else
+		{
+			if (!binaryName.ends_with(".exe")) extension = ".exe";
+		}
+	}
+	else if (globalData.targetProfile.binaryType == BinaryType::B_SHARED)
+	{
+		if ((!isWindows
+			&& globalData.targetProfile.targetType == TargetType::T_INVALID)
+			|| globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
+			|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
+		{
+			if (!binaryName.starts_with("lib")) binaryName = "lib" + binaryName;
+			if (!binaryName.ends_with(".so")) extension = ".so";
+		}
+		else
+		{
+			if (!binaryName.ends_with(".dll")) extension = ".dll";
+		}
+	}
+	else if (globalData.targetProfile.binaryType == BinaryType::B_STATIC)
+	{
+		if ((!isWindows
+			&& globalData.targetProfile.targetType == TargetType::T_INVALID)
+			|| globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
+			|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
+		{
+			if (!binaryName.starts_with("lib")) binaryName = "lib" + binaryName;
+			if (!binaryName.ends_with(".a")) extension = ".a";
+		}
+		else
+		{
+			if (!binaryName.ends_with(".lib")) extension = ".lib";
+		}
+	}
+
+	return buildPath / string(binaryName + extension);
+}
+
+unordered_map<string, LinkInput> ReadInputHashes(const path& output)
+{
+	unordered_map<string, LinkInput> result{};
+
+	path hashesPath = output.string() + string(inputHashesExtension);
+	if (!exists(hashesPath)) return result;
+
+	vector<string> lines{};
+	string errorMsg = ReadLinesFromFile(
+		hashesPath,
+		lines);
+
+	if (!errorMsg.empty()) return result;
+
+	//each line is 'hash|time|path', lines of older versions without a time are dropped
+	for (const auto& l : lines)
+	{
+		size_t hashSplit = l.find('|');
+		if (hashSplit == string::npos) continue;
+
+		size_t timeSplit = l.find('|', hashSplit + 1);
+		if (timeSplit == string::npos) continue;
+
+		LinkInput input{};
+
+		if (from_chars(l.data(), l.data() + hashSplit, input.hash).ec != std::errc{}
+			|| from_chars(l.data() + hashSplit + 1, l.data() + timeSplit, input.time).ec != std::errc{})
+		{
+			continue;
+		}
+
+		result[l.substr(timeSplit + 1)] = input;
+	}
+
+	return result;
+}
+
+void WriteInputHashes(
+	const GlobalData& globalData,
+	const path& output,
+	const vector<path>& objects)
+{
+	vector<path> inputs = objects;
+	for (const auto& l : globalData.targetProfile.links)
+	{
+		if (is_regular_file(l)) inputs.push_back(l);
+	}
 
-			generate();
+	vector<LinkInput> hashes{};
+	hashes.resize(inputs.size());
 
-			if (globalData.targetProfile.sources.size() == 1) compile(0);
-			else
+	Walker::ForEach(
+		inputs.size(),
+		[&inputs, &hashes](size_t i)
+		{
+			hashes[i] =
 			{
-				u16 max_jobs = min(
-					scast<size_t>(globalData.targetProfile.jobs), 
-					globalData.targetProfile.sources.size());
-
-				atomic<int> next{};
-				vector<thread> workers{};
+				.hash = Snapshot::HashFile(GetLinkInput(inputs[i])),
+				.time = GetInputTime(inputs[i])
+			};
+		});
 
-				for (u16 i = 0; i < max_jobs; ++i)
-				{
-					workers.emplace_back([
-						&next, 
-						&globalData,
-						compile] 
-						{
-							while (true)
-							{
-								int idx = next++;
+	unordered_map<string, LinkInput> result{};
+	for (size_t i = 0; i < inputs.size(); ++i) result[inputs[i].string()] = hashes[i];
 
-								if (scast<size_t>(idx) >= globalData.targetProfile.sources.size()) break;
+	SaveInputHashes(output, result);
+}
 
-								compile(idx);
-							}
-						});
-				}
+void SaveInputHashes(
+	const path& output,
+	const unordered_map<string, LinkInput>& inputs)
+{
+	ostringstream out{};
+	for (const auto& [inputPath, input] : inputs)
+	{
+		out << input.hash << "|" << input.time << "|" << inputPath << "\n";
+	}
 
-				for (auto& w : workers) w.join();
-			}
+	string errorMsg = CreateNewFile(
+		output.string() + string(inputHashesExtension),
+		FileType::FILE_TEXT,
+		{ .inText = out.str() });
 
-			return compiledObj;
-		};
+	if (!errorMsg.empty())
+	{
+		Log::Print(
+			"Failed to save link input hashes! Reason: " + errorMsg,
+			"LANGUAGE_C_CPP",
+			LogType::LOG_WARNING);
+	}
+}
 
-	//
-	// LINK
-	//
+i64 GetInputTime(const path& target)
+{
+	error_code ec{};
+	file_time_type time = last_write_time(target, ec);
 
-	auto link = [&isMSVC, &globalData, &frontArg](const vector<path>& objFiles) -> void
-		{
-			string sharedArg = globalData.targetProfile.binaryType == BinaryType::B_SHARED
-				? (isMSVC ? "/LD" : "-shared")
-				: string{};
+	return ec
+		? 0
+		: scast<i64>(time.time_since_epoch().count());
+}
 
-			string command{};
+void WriteInterface(const path& output)
+{
+	path interfacePath = output.string() + string(interfaceExtension);
+	path symbolsPath = output.string() + ".symbols.txt";
 
-			//set compiler launcher
+	//posix format is 'name type value size' for every defined dynamic symbol
+	string command = "nm -D --defined-only -P \"" + output.string() + "\" > \"" + symbolsPath.string() + "\"";
 
-			if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID
-				&& globalData.targetProfile.binaryType != BinaryType::B_STATIC)
-			{
-				string_view compilerLauncher{};
-				EnumToString(globalData.targetProfile.compilerLauncher, KalaMakeCore::GetCompilerLauncherTypes(), compilerLauncher);
+	vector<string> lines{};
+	if (JobPool::Run(command) != 0
+		|| !ReadLinesFromFile(symbolsPath, lines).empty())
+	{
+		Log::Print(
+			"Failed to read the exported symbols of '" + output.string() + "', programs that link it relink on every change.",
+			"LANGUAGE_C_CPP",
+			LogType::LOG_WARNING);
 
-				command += string(compilerLauncher) + " ";
-			}
+		if (exists(interfacePath)) DeletePath(interfacePath);
+		if (exists(symbolsPath)) DeletePath(symbolsPath);
 
-			//set compiler
+		return;
+	}
 
-			string compiler{};
-			string targetTriple{};
+	DeletePath(symbolsPath);
 
-			if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE
-				|| globalData.targetProfile.binaryType == BinaryType::B_SHARED)
-			{
-				string_view nonStaticCompiler{};
-				EnumToString(globalData.targetProfile.compiler, KalaMakeCore::GetCompilerTypes(), nonStaticCompiler);
+	ostringstream out{};
+	for (const auto& l : lines)
+	{
+		istringstream symbol(l);
 
-				if (globalData.targetProfile.targetType == TargetType::T_LINUX_GNU)
-				{
-					if (nonStaticCompiler == "gcc")      compiler = target_type_linux_gnu_gcc;
-					else if (nonStaticCompiler == "g++") compiler = target_type_linux_gnu_gpp;
-					else
-					{
-						compiler = nonStaticCompiler;
-						targetTriple = target_type_linux_gnu_clang_zig;
-					}
-				}
-				else if (globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
-				{
-					if (nonStaticCompiler == "gcc")      compiler = target_type_linux_musl_gcc;
-					else if (nonStaticCompiler == "g++") compiler = target_type_linux_musl_gpp;
-					else
-					{
-						compiler = nonStaticCompiler;
-						targetTriple = target_type_linux_musl_clang_zig;
-					}
-				}
-				else if (globalData.targetProfile.targetType == TargetType::T_WINDOWS_GNU)
-				{
-					if (nonStaticCompiler == "gcc")      compiler = target_type_win_gnu_gcc;
-					else if (nonStaticCompiler == "g++") compiler = target_type_win_gnu_gpp;
-					else
-					{
-						compiler = nonStaticCompiler;
-						targetTriple = target_type_win_gnu_clang_zig;
-					}
-				}
-				else
-				{
-					compiler = nonStaticCompiler;
-					if (compiler == "clang"
-						|| compiler == "clang++")
-					{
-						targetTriple = target_type_win_msvc_clang;
-					}
-					else targetTriple = target_type_win_msvc_zig;
-				}
-			}
-			else
-			{
-#ifdef _WIN32
-				compiler = "lib";
-#else
-				compiler = "ar rcs";
-#endif
-			}
+		string name{};
+		string type{};
+		string value{};
+		string size{};
+		symbol >> name >> type >> value >> size;
 
-			command += compiler;
+		if (name.empty()) continue;
 
-			if (compiler == "zig")
-			{
-				StandardType standardType = globalData.targetProfile.standard;
+		//function sizes change with their bodies, data sizes are part of the interface
+		out << name << " " << type;
+		if (type != "T"
+			&& type != "W"
+			&& type != "i")
+		{
+			out << " " << size;
+		}
+		out << "\n";
+	}
 
-				if (standardType == StandardType::C_89
-					|| standardType == StandardType::C_99
-					|| standardType == StandardType::C_11
-					|| standardType == StandardType::C_17
-					|| standardType == StandardType::C_23)
-				{
-					command += " cc";
-				}
-				else if (standardType == StandardType::CPP_14
-					|| standardType == StandardType::CPP_17
-					|| standardType == StandardType::CPP_20
-					|| standardType == StandardType::CPP_23
-					|| standardType == StandardType::CPP_26)
-				{
-					command += " c++";
-				}
-			}
+	string result = out.str();
 
-			//-target only for clang/clang++/zig
-			if (!targetTriple.empty()) command += " -target " + targetTriple;
+	vector<string> oldLines{};
+	if (exists(interfacePath)
+		&& ReadLinesFromFile(interfacePath, oldLines).empty())
+	{
+		string oldResult{};
+		for (const auto& l : oldLines) oldResult += l + "\n";
 
-			//set output
+		if (oldResult == result) return;
+	}
 
-			string outputArgFront{};
-			string outputArg{};
+	string errorMsg = CreateNewFile(
+		interfacePath,
+		FileType::FILE_TEXT,
+		{ .inText = result });
 
-			if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE
-				|| globalData.targetProfile.binaryType == BinaryType::B_SHARED)
-			{
-				//link-time shared flag for output
-				outputArgFront = globalData.targetProfile.binaryType == BinaryType::B_SHARED
-					? (isMSVC ? "/LD " : "-shared " )
-					: string{};
-
-				outputArg = isMSVC
-					? "/Fe:"
-					: "-o ";
-			}
-			else
-			{
-				if (compiler == "lib") outputArg = "/OUT:";
-			}
+	if (!errorMsg.empty())
+	{
+		Log::Print(
+			"Failed to save interface of '" + output.string() + "'! Reason: " + errorMsg,
+			"LANGUAGE_C_CPP",
+			LogType::LOG_WARNING);
+	}
+}
 
-			path buildPath = globalData.targetProfile.buildPath;
-			string binaryName = globalData.targetProfile.binaryName;
+path GetLinkInput(const path& link)
+{
+	path interfacePath = link.string() + string(interfaceExtension);
 
-			string extension{};
-			if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE)
-			{
-				if (!isWindows) command += " -Wl,-rpath,\\$ORIGIN";
+	return exists(interfacePath)
+		? interfacePath
+		: link;
+}
 
-				if ((!isWindows
-					&& globalData.targetProfile.targetType == TargetType::T_INVALID)
-					|| globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
-					|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
-				{
-					
-					if (binaryName.ends_with(".exe")) binaryName.resize(binaryName.size() - 4);
-				}
-				else
-				{
-					if (!binaryName.ends_with(".exe")) extension = ".exe";
-				}
-			}
-			else if (globalData.targetProfile.binaryType == BinaryType::B_SHARED)
-			{
-				if ((!isWindows
-					&& globalData.targetProfile.targetType == TargetType::T_INVALID)
-					|| globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
-					|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
-				{
-					if (!binaryName.starts_with("lib")) binaryName = "lib" + binaryName;
-					if (!binaryName.ends_with(".so")) extension = ".so";
-				}
-				else
-				{
-					if (!binaryName.ends_with(".dll")) extension = ".dll";
-				}
+void CompileFile_Final(
+	const GlobalData& globalData,
+	const path& source,
+	bool exportDiagnostics)
+{
+	bool isMSVC = 
+		globalData.targetProfile.compiler == CompilerType::C_CL
+		|| globalData.targetProfile.compiler == CompilerType::C_CLANG_CL;
 
-				if (isWindows
-					&& (globalData.targetProfile.compiler == CompilerType::C_GCC
-					|| globalData.targetProfile.compiler == CompilerType::C_GPP))
-				{
-					command += " -Wl,--out-implib," + (buildPath / (binaryName + ".lib")).string();
-				}
-			}
-			else if (globalData.targetProfile.binaryType == BinaryType::B_STATIC)
-			{
-				if ((!isWindows
-					&& globalData.targetProfile.targetType == TargetType::T_INVALID)
-					|| globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
-					|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
-				{
-					if (!binaryName.starts_with("lib")) binaryName = "lib" + binaryName;
-					if (!binaryName.ends_with(".a")) extension = ".a";
-				}
-				else
-				{
-					if (!binaryName.ends_with(".lib")) extension = ".lib";
-				}
-			}
+	//only sources of the profile have an object path and a command
+	const path* target{};
+	for (const auto& s : globalData.targetProfile.sources)
+	{
+		error_code ec{};
+		if (equivalent(s, source, ec))
+		{
+			target = &s;
+			break;
+		}
+	}
 
-			path outputPath = path(buildPath / string(binaryName + extension));
+	if (target == nullptr)
+	{
+		KalaMakeCore::CloseOnError(
+			"LANGUAGE_C_CPP",
+			"Source '" + source.string() + "' is not a source of profile '" + globalData.targetProfile.profileName + "'!");
+	}
 
-			command += " " + outputArgFront + outputArg + "\"" + outputPath.string() + "\"";
+	//a single source compiles with the flags and object paths a full compile uses,
+	//so the next full compile keeps its object instead of linking a baseline one
+	vector<GlobalData> builds{};
+	if (!globalData.targetProfile.microarch.empty()) builds = GetMicroarchVariants(globalData);
+	else builds.push_back(globalData);
 
-			//add object files
-			
-			for (const auto& o : objFiles)
-			{
-				command += " \"" + o.string() + "\"";
-			}
+	if (!globalData.targetProfile.pgoTraining.empty()
+		&& !AddProfileUseFlags(builds[0].targetProfile))
+	{
+		KalaMakeCore::CloseOnError(
+			"LANGUAGE_C_CPP",
+			"Profile '" + globalData.targetProfile.profileName + "' has no training data yet! Compile the whole profile once before compiling single sources.");
+	}
 
-			//set links
+	auto compile_build = [
+		&isMSVC,
+		target](
+		const GlobalData& build,
+		bool withDiagnostics) -> void
+		{
+			path buildPath = build.targetProfile.buildPath / objFolderName;
 
-			if (!globalData.targetProfile.links.empty())
+			if (!exists(buildPath))
 			{
-				for (const path& l : globalData.targetProfile.links)
+				string errorMsg = CreateNewDirectory(buildPath);
+				if (!errorMsg.empty())
 				{
-					if (is_directory(l))
-					{
-						if (isMSVC) command += " /LIBPATH:\"" + l.string() + "\"";
-						else        command += " -L\"" + l.string() + "\"";
-					}
-					else if (l.has_extension())
-					{
-						if (ContainsAlpha(l.extension().string())) command += " \"" + l.string() + "\"";
-						else
-						{
-							if (isMSVC) command += " " + l.string() + ".lib";
-							else        command += " -l" + l.string();
-						}
-					}
-					else
-					{
-						if (isMSVC) command += " " + l.string() + ".lib";
-						else        command += " -l" + l.string();
-					}
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_C_CPP",
+						"Failed to create new obj dir for compilation! Reason: " + errorMsg);
 				}
 			}
 
-			//set link flags
+			string extension = isMSVC
+				? ".obj"
+				: ".o";
+			string objFront = isMSVC
+				? "/Fo:"
+				: "-o";
 
-			vector<string> finalFlags = globalData.targetProfile.linkFlags;
+			path objPath = buildPath / (target->stem().string() + extension);
 
-			if (globalData.targetProfile.binaryType != BinaryType::B_STATIC)
-			{
-				if (isMSVC)
-				{
-					if (globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_DEBUG
-						|| globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_RELDEBUG
-						|| ContainsValue(globalData.targetProfile.customFlags, CustomFlag::F_GENERATE_SYMBOLS))
-					{
-						finalFlags.push_back("DEBUG");
-					}
-					else finalFlags.push_back("RELEASE");
-				}
-				else
-				{
-					if (globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_DEBUG
-						|| globalData.targetProfile.buildType == KalaMake::Core::BuildType::B_RELDEBUG
-						|| ContainsValue(globalData.targetProfile.customFlags, CustomFlag::F_GENERATE_SYMBOLS))
-					{
-						finalFlags.push_back("g");
+			string command = GetCompileCommand(build);
+			command += " \"" + target->string() + "\"";
+			command += " " + objFront + " \"" + objPath.string() + "\"";
 
-						if (globalData.targetProfile.targetType == TargetType::T_LINUX_GNU
-							|| globalData.targetProfile.targetType == TargetType::T_LINUX_MUSL)
-						{
-							finalFlags.push_back("rdynamic");
-						}
-					}
-				}
-			}
+			Log::Print(
+				"Starting to compile via '" + command + "'.",
+				"LANGUAGE_C_CPP",
+				LogType::LOG_INFO);
 
-#ifdef _WIN32
-			if (globalData.targetProfile.binaryType == BinaryType::B_EXECUTABLE
-				&& ContainsValue(globalData.targetProfile.customFlags, CustomFlag::F_NO_CONSOLE))
+			if (!withDiagnostics)
 			{
-				if (isMSVC)
+				if (JobPool::Run(command) != 0)
 				{
-					finalFlags.push_back("SUBSYSTEM:WINDOWS");
-					finalFlags.push_back("ENTRY:mainCRTStartup");
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_C_CPP",
+						"Failed to compile object file '" + objPath.string() + "'!");
 				}
-				else finalFlags.push_back("Wl,-subsystem:windows,-entry:mainCRTStartup");
-			}
-#endif
-
-			if (isMSVC
-				&& !finalFlags.empty())
-			{
-				finalFlags.insert(finalFlags.begin(), "link");
 			}
-
-			RemoveDuplicates(finalFlags);
-			for (const auto& f : finalFlags)
+			else
 			{
-				command += " " + frontArg + f;
-			}
+				//cl prints its diagnostics to stdout, so both streams are captured
+				path outputPath = buildPath / (target->stem().string() + ".output.txt");
+				path diagnosticsPath = buildPath / (target->stem().string() + ".diagnostics.json");
 
-			//link 
+				string capturedCommand = command + " > \"" + outputPath.string() + "\" 2>&1";
+				bool failed = JobPool::Run(capturedCommand) != 0;
 
-			auto needs_link = [&globalData](
-				const path& output,
-				const vector<path>& objects
-				) -> bool
+				vector<string> lines{};
+				string readResult = ReadLinesFromFile(outputPath, lines);
+				if (!readResult.empty())
 				{
-					if (!exists(output)) return true;
-
-					file_time_type exeTime = last_write_time(output);
-
-					if (exeTime < kmakeTime) return true;
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_C_CPP",
+						"Failed to read compiler output of '" + target->string() + "'! Reason: " + readResult);
+				}
 
-					for (const auto& o : objects)
-					{
-						if (!exists(o)
-							|| last_write_time(o) > exeTime)
-						{
-							return true;
-						}
-					}
+				vector<Diagnostic> diagnostics{};
+				for (const auto& l : lines)
+				{
+					Log::Print(l);
 
-					for (const auto& l : globalData.targetProfile.links)
-					{
-						if (exists(l)
-							&& last_write_time(l) > exeTime)
-						{
-							return true;
-						}
-					}
+					Diagnostic d{};
+					if (ParseDiagnostic(l, d)) diagnostics.push_back(std::move(d));
+				}
 
-					return false;
-				};
+				DeletePath(outputPath);
 
-			Log::Print("===========================================================================\n");
+				Generate::GenerateDiagnostics(diagnostics, diagnosticsPath);
 
-			if (needs_link(outputPath, objFiles))
-			{
 				Log::Print(
-					"Starting to link via '" + command + "'.",
+					"Exported '" + to_string(diagnostics.size()) + "' diagnostics to '" + diagnosticsPath.string() + "'.",
 					"LANGUAGE_C_CPP",
 					LogType::LOG_INFO);
 
-				Log::Print(" ");
-
-				if (system(command.c_str()) != 0)
+				if (failed)
 				{
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_C_CPP",
-						"Failed to link '" + outputPath.string() + "'!");
+						"Failed to compile object file '" + objPath.string() + "'!");
 				}
+			}
 
-				if (isWindows
-					&& globalData.targetProfile.binaryType == BinaryType::B_SHARED
-					&& globalData.targetProfile.compiler == CompilerType::C_ZIG)
-				{
-					for (auto& f : directory_iterator(globalData.targetProfile.buildPath))
-					{
-						path file = path(f);
-						if (file.extension() == ".lib")
-						{
-							string err = RenamePath(file, globalData.targetProfile.binaryName + ".lib");
-							if (!err.empty())
-							{
-								KalaMakeCore::CloseOnError(
-									"LANGUAGE_C_CPP",
-									"Failed to rename Zig-created lib! Reason: " + err);
-							}
-						}
-					}
-				}
+			Log::Print(
+				"Finished compiling object file '" + objPath.string() + "'!",
+				"LANGUAGE_C_CPP",
+				LogType::LOG_SUCCESS);
+		};
 
-				Log::Print(
-					"Finished linking to output '" + outputPath.string() + "'!",
-					"LANGUAGE_C_CPP",
-					LogType::LOG_SUCCESS);
-			}
-			else
-			{
-				Log::Print(
-					"Skipping linking of output '" + outputPath.string() + "' because there are no new object files.",
-					"LANGUAGE_C_CPP",
-					LogType::LOG_INFO);
-			}
-			};
+	for (size_t i = 0; i < builds.size(); ++i)
+	{
+		//diagnostics are the same for every level, the lowest one reports them
+		compile_build(
+			builds[i],
+			exportDiagnostics && i == 0);
+	}
+}
 
-	//
-	// COMPILE AND LINK
-	//
+bool ParseDiagnostic(
+	string_view line,
+	Diagnostic& out)
+{
+	auto to_number = [](string_view value, uint32_t& result) -> bool
+		{
+			if (value.empty()) return false;
 
-	vector<path> objFiles = compile();
-	link(objFiles);
+			auto [end, ec] = from_chars(value.data(), value.data() + value.size(), result);
+			return ec == std::errc{}
+				&& end == value.data() + value.size();
+		};
 
-	//
-	// POST BUILD ACTIONS
-	//
+	constexpr string_view severities[] = { "fatal error", "error", "warning", "note" };
 
-	if (!globalData.targetProfile.postBuildActions.empty())
+	//the earliest marker is the one the compiler wrote, later ones are part of the message
+	string_view severity{};
+	size_t pos = string_view::npos;
+	size_t markerSize{};
+	bool isGNU{};
+
+	for (string_view s : severities)
 	{
-		Log::Print("\n===========================================================================\n");
+		string gnuMarker = ": " + string(s) + ": ";
+		string msvcMarker = ": " + string(s) + " ";
 
-		Log::Print(
-			"Starting to run post build actions.",
-			"LANGUAGE_C_CPP",
-			LogType::LOG_INFO);
+		//a marker at the start has no location in front of it
+		size_t gnuPos = line.find(gnuMarker, 1);
+		size_t msvcPos = line.find(msvcMarker, 1);
+
+		if (gnuPos < pos)
+		{
+			severity = s;
+			pos = gnuPos;
+			markerSize = gnuMarker.size();
+			isGNU = true;
+		}
+		if (msvcPos < pos)
+		{
+			severity = s;
+			pos = msvcPos;
+			markerSize = msvcMarker.size();
+			isGNU = false;
+		}
+	}
+
+	if (pos == string_view::npos) return false;
+
+	string_view location = line.substr(0, pos);
+	string_view message = line.substr(pos + markerSize);
 
-		for (const auto& a : globalData.targetProfile.postBuildActions)
+	if (isGNU)
+	{
+		//file:line:col or file:line, drive letters keep their ':' in the file
+		size_t last = location.rfind(':');
+		if (last != string_view::npos
+			&& to_number(location.substr(last + 1), out.column))
 		{
-			Log::Print("\naction: " + a);
+			location = location.substr(0, last);
 
-			if (system(a.c_str()) != 0)
+			size_t previous = location.rfind(':');
+			if (previous != string_view::npos
+				&& to_number(location.substr(previous + 1), out.line))
 			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_C_CPP",
-					"Failed to run post build action '" + a + "'!");
+				location = location.substr(0, previous);
+			}
+			else
+			{
+				out.line = out.column;
+				out.column = 0;
 			}
 		}
+	}
+	else
+	{
+		//file(line,col): error C1234: message
+		size_t open = location.rfind('(');
+		if (open == string_view::npos
+			|| !location.ends_with(')'))
+		{
+			return false;
+		}
 
-		Log::Print(" ");
+		string_view numbers = location.substr(open + 1, location.size() - open - 2);
+		size_t comma = numbers.find(',');
 
-		Log::Print(
-			"Finished all post build actions!",
-			"LANGUAGE_C_CPP",
-			LogType::LOG_SUCCESS);
+		if (!to_number(numbers.substr(0, comma), out.line)) return false;
+		if (comma != string_view::npos) to_number(numbers.substr(comma + 1), out.column);
+
+		location = location.substr(0, open);
+
+		size_t codeEnd = message.find(": ");
+		if (codeEnd != string_view::npos) message = message.substr(codeEnd + 2);
 	}
+
+	out.file = string(location);
+	out.severity = severity == "fatal error" ? "error" : string(severity);
+	out.message = string(message);
+
+	return true;
 }
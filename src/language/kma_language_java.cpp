@@ -13,9 +13,12 @@
 
 #include "language/kma_language.hpp"
 #include "core/kma_core.hpp"
+#include "core/kma_schema.hpp"
 #include "core/kma_generate.hpp"
+#include "core/kma_jobs.hpp"
+#include "core/kma_action.hpp"
+#include "core/kma_walk.hpp"
 
-using KalaHeaders::KalaCore::EnumToString;
 using KalaHeaders::KalaCore::ContainsValue;
 using KalaHeaders::KalaCore::RemoveDuplicates;
 
@@ -27,6 +30,9 @@ using KalaHeaders::KalaFile::DeletePath;
 using KalaHeaders::KalaFile::CopyPath;
 
 using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::Schema;
+using KalaMake::Core::FieldType;
+using KalaMake::Core::language_java;
 using KalaMake::Language::GlobalData;
 using KalaMake::Core::BinaryType;
 using KalaMake::Core::CompilerLauncherType;
@@ -36,20 +42,25 @@ using KalaMake::Core::BuildType;
 using KalaMake::Core::WarningLevel;
 using KalaMake::Core::CustomFlag;
 using KalaMake::Core::Generate;
+using KalaMake::Core::JobPool;
+using KalaMake::Core::Action;
 using KalaMake::Core::JavaClassPath;
 using KalaMake::Core::VSCode_Launch;
 using KalaMake::Core::VSCode_Task;
+using KalaMake::Core::Walker;
+using KalaMake::Core::WalkedFile;
 
 using std::string;
 using std::string_view;
 using std::find;
+using std::min;
 using std::vector;
+using std::to_string;
 using std::filesystem::path;
 using std::filesystem::current_path;
 using std::filesystem::file_time_type;
 using std::filesystem::last_write_time;
 using std::filesystem::directory_iterator;
-using std::filesystem::recursive_directory_iterator;
 using std::filesystem::is_empty;
 using std::filesystem::is_directory;
 using std::ifstream;
@@ -58,13 +69,16 @@ using std::getline;
 using u16 = uint16_t;
 
 constexpr string_view classFolderName = "class";
+//javac always writes class files, check removes this folder after compiling
+constexpr string_view checkFolderName = "check";
 
-static file_time_type kmakeTime{};
-static file_time_type jarTime{};
+//one set per profile thread
+static thread_local file_time_type kmakeTime{};
+static thread_local file_time_type jarTime{};
 
-static path mainJava{};
-static path mainClass{};
-static string mainClassValue{};
+static thread_local path mainJava{};
+static thread_local path mainClass{};
+static thread_local string mainClassValue{};
 
 static void PreCheck(GlobalData& globalData);
 
@@ -136,6 +150,12 @@ namespace KalaMake::Language
 {
 	void LanguageCore::Compile_Java(GlobalData& globalData)
 	{
+		kmakeTime = {};
+		jarTime = {};
+		mainJava.clear();
+		mainClass.clear();
+		mainClassValue.clear();
+
 		PreCheck(globalData);
 		Compile_Final(globalData);
 	}
@@ -144,25 +164,14 @@ namespace KalaMake::Language
 void PreCheck(GlobalData& globalData)
 {
 	//
-	// ENSURE REQUIRED FIELDS ARE NOT MISSING
+	// ENSURE REQUIRED FIELDS ARE SET AND UNSUPPORTED FIELDS ARE NOT USED
 	//
 
-    if (globalData.targetProfile.standard == StandardType::S_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'standard' must be assigned in Java!");
-    }
-	if (globalData.targetProfile.buildType == BuildType::B_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'buildtype' must be assigned in Java!");
-    }
-
-    //
-    // ENSURE UNSUPPORTED FIELDS ARE NOT USED
-    //
+	Schema::CheckLanguage(
+		globalData.targetProfile,
+		language_java,
+		"Java",
+		"LANGUAGE_JAVA");
 
     if (globalData.targetProfile.binaryType != BinaryType::B_EXECUTABLE)
     {
@@ -170,85 +179,6 @@ void PreCheck(GlobalData& globalData)
 			"LANGUAGE_JAVA",
 			"Java only supports executables!");
     }
-    if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'compilerlauncher' is not supported in Java!");
-    }
-    if (globalData.targetProfile.targetType != TargetType::T_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'targettype' is not supported in Java!");
-    }
-    if (!globalData.targetProfile.headers.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'headers' is not supported in Java!");
-    }
-    if (globalData.targetProfile.warningLevel != WarningLevel::W_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'warninglevel' is not supported in Java!");
-    }
-    if (!globalData.targetProfile.linkFlags.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'linkflags' is not supported in Java!");
-    }
-
-    if (globalData.targetProfile.jobs != 0)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Field 'jobs' is not supported in Java!");
-    }
-
-	if (ContainsValue(
-			globalData.targetProfile.customFlags, 
-			CustomFlag::F_EXPORT_COMPILE_COMMANDS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Custom flag 'export-compile-commands' is not supported in Java!");
-	}
-    if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_MSVC_STATIC_RUNTIME))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Custom flag 'msvc-static-runtime' is not supported in Java!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_GENERATE_SYMBOLS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Custom flag 'generate-symbols' is not supported in Java!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_NO_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Custom flag 'no-console' is not supported in Java!");
-	}
-    if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PYTHON_ONE_FILE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_JAVA",
-			"Custom flag 'python-one-file' is not supported in Java!");
-	}
-
 	if (!globalData.targetProfile.links.empty())
 	{
 		if (globalData.targetProfile.links.size() > 1)
@@ -343,11 +273,6 @@ void PreCheck(GlobalData& globalData)
             "Did not find main Java script! Please ensure Main.java or main.java is added to sources.");
     }
 
-	auto should_exclude = [](const path& target) -> bool
-		{
-			return (target.string().starts_with('!'));
-		};
-
 	auto should_remove = [](
 		const path& target) -> bool
 		{
@@ -364,47 +289,10 @@ void PreCheck(GlobalData& globalData)
 
 	bool foundInvalid{};
 	vector<path>& sources = globalData.targetProfile.sources;
-	vector<path> exclusions{};
 	vector<path> finalSources{};
 
 	for (const auto& target : sources)
 	{
-		if (should_exclude(target))
-		{
-			string withoutExclamation = target.string().substr(1);
-
-			auto itMatch = find(
-				sources.begin(),
-				sources.end(),
-				path((withoutExclamation)));
-
-			if (itMatch == sources.end())
-			{
-				withoutExclamation = (current_path() / withoutExclamation).string();
-
-				itMatch = find(
-					sources.begin(),
-					sources.end(),
-					path((withoutExclamation)));
-
-				if (itMatch == sources.end())
-				{
-					KalaMakeCore::CloseOnError(
-						"LANGUAGE_JAVA",
-						"Cannot ignore target '" + target.string() + "' if it hasn't already been added to sources list!");
-				}
-			}
-
-			exclusions.push_back(withoutExclamation);
-
-			Log::Print(
-				"Ignoring excluded source script path '" + (*itMatch).string() + "'.",
-				"LANGUAGE_JAVA",
-				LogType::LOG_INFO);
-
-			foundInvalid = true;
-			continue;
-		}
 		if (should_remove(target))
 		{
 			Log::Print(
@@ -450,19 +338,6 @@ void PreCheck(GlobalData& globalData)
 
 	if (foundInvalid) 
 	{
-		if (!exclusions.empty())
-		{
-			finalSources.erase(
-				remove_if(
-					finalSources.begin(),
-					finalSources.end(),
-					[&exclusions](const path& p)
-					{
-						return find(exclusions.begin(), exclusions.end(), p) != exclusions.end();
-					}),
-				finalSources.end());
-		}
-
 		globalData.targetProfile.sources = std::move(finalSources);
 
 		Log::Print("\n===========================================================================\n");
@@ -482,17 +357,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_JAVA",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.preBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_JAVA",
-					"Failed to run pre build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.preBuildActions,
+			false,
+			"LANGUAGE_JAVA",
+			"pre build");
 
 		Log::Print(" ");
 
@@ -508,7 +378,7 @@ void Compile_Final(const GlobalData& globalData)
 	// GENERATE STEPS
 	//
 
-	GenerateSteps(globalData);
+	if (!globalData.checkOnly) GenerateSteps(globalData);
 
 	//
 	// COMPILE
@@ -524,8 +394,7 @@ void Compile_Final(const GlobalData& globalData)
 
 			//set standard
 
-			string_view standard{};
-			EnumToString(globalData.targetProfile.standard, KalaMakeCore::GetStandardTypes(), standard);
+			string_view standard = Schema::GetValueName(FieldType::T_STANDARD, globalData.targetProfile.standard);
 
             if (!standard.starts_with("java"))
             {
@@ -590,6 +459,38 @@ void Compile_Final(const GlobalData& globalData)
 				command += " " + f;
 			}
 
+			//check
+
+			if (globalData.checkOnly)
+			{
+				path checkDir = globalData.targetProfile.buildPath / checkFolderName;
+
+				command += " -proc:none -d \"" + checkDir.string() + "\"";
+
+				for (const auto& j : globalData.targetProfile.sources)
+				{
+					command += " \"" + j.string() + "\"";
+				}
+
+				Log::Print(
+					"Starting to check via '" + command + "'.",
+					"LANGUAGE_JAVA",
+					LogType::LOG_INFO);
+
+				bool failed = JobPool::Run(command) != 0;
+
+				if (exists(checkDir)) DeletePath(checkDir);
+
+				if (failed)
+				{
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_JAVA",
+						"Found errors in Java sources!");
+				}
+
+				return {};
+			}
+
 			//compile
 
 			path classDir = globalData.targetProfile.buildPath / classFolderName;
@@ -618,16 +519,27 @@ void Compile_Final(const GlobalData& globalData)
 
 			if (!isAnyNewer)
 			{
-				for (const auto& j : globalData.targetProfile.sources)
+				vector<WalkedFile> classFiles{};
+				Walker::Walk({ classDir }, classFiles);
+
+				//a source newer than the oldest class file is newer than at least one class file
+				file_time_type oldestClassTime = file_time_type::max();
+				for (const auto& c : classFiles)
 				{
-					for (const auto& c : recursive_directory_iterator(classDir))
+					oldestClassTime = min(oldestClassTime, c.time);
+				}
+
+				vector<file_time_type> sourceTimes{};
+				Walker::GetWriteTimes(globalData.targetProfile.sources, sourceTimes);
+
+				isAnyNewer = kmakeTime > oldestClassTime;
+
+				for (const auto& t : sourceTimes)
+				{
+					if (t > oldestClassTime)
 					{
-						if (last_write_time(j) > last_write_time(c)
-							|| kmakeTime > last_write_time(c))
-						{
-							isAnyNewer = true;
-							break;
-						}
+						isAnyNewer = true;
+						break;
 					}
 				}
 			}
@@ -644,7 +556,7 @@ void Compile_Final(const GlobalData& globalData)
 					"LANGUAGE_JAVA",
 					LogType::LOG_INFO);
 
-				if (system(command.c_str()) != 0)
+				if (JobPool::Run(command) != 0)
 				{
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_JAVA",
@@ -659,17 +571,19 @@ void Compile_Final(const GlobalData& globalData)
 					LogType::LOG_INFO);
 			}
 
+			vector<WalkedFile> classFiles{};
+			Walker::Walk({ classDir }, classFiles);
+
 			vector<path> compiledClasses{};
-			for (const auto& c : recursive_directory_iterator(classDir))
+			for (auto& c : classFiles)
 			{
-				if (is_directory(c)) continue;
-				compiledClasses.push_back(c);
-
-				if (c.path().stem() == "Main"
-					|| c.path().stem() == "main")
+				if (c.filePath.stem() == "Main"
+					|| c.filePath.stem() == "main")
 				{
-					mainClass = c.path();
+					mainClass = c.filePath;
 				}
+
+				compiledClasses.push_back(std::move(c.filePath));
 			}
 
 			if (mainClass.empty())
@@ -737,7 +651,7 @@ void Compile_Final(const GlobalData& globalData)
 					"LANGUAGE_JAVA",
 					LogType::LOG_INFO);
 
-				if (system(command.c_str()) != 0)
+				if (JobPool::Run(command) != 0)
 				{
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_JAVA",
@@ -927,7 +841,7 @@ void Compile_Final(const GlobalData& globalData)
 					}
 				}
 
-				if (system(command.c_str()) != 0)
+				if (JobPool::Run(command) != 0)
 				{
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_JAVA",
@@ -953,6 +867,20 @@ void Compile_Final(const GlobalData& globalData)
 	//
 
 	vector<path> classFiles = compile();
+
+	//jar and package steps skip on their own, so post build actions treat every build as new
+	bool relinked = true;
+
+	if (globalData.checkOnly)
+	{
+		Log::Print(
+			"Finished checking '" + to_string(globalData.targetProfile.sources.size()) + "' sources, no errors were found!",
+			"LANGUAGE_JAVA",
+			LogType::LOG_SUCCESS);
+
+		return;
+	}
+
 	path jarPath = create_jar(classFiles);
 
 	if (ContainsValue(
@@ -975,17 +903,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_JAVA",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.postBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_JAVA",
-					"Failed to run post build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.postBuildActions,
+			relinked,
+			"LANGUAGE_JAVA",
+			"post build");
 
 		Log::Print(" ");
 
@@ -12,7 +12,10 @@
 
 #include "language/kma_language.hpp"
 #include "core/kma_core.hpp"
+#include "core/kma_schema.hpp"
 #include "core/kma_generate.hpp"
+#include "core/kma_jobs.hpp"
+#include "core/kma_action.hpp"
 
 using KalaHeaders::KalaCore::ContainsValue;
 using KalaHeaders::KalaCore::RemoveDuplicates;
@@ -21,6 +24,8 @@ using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
 
 using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::Schema;
+using KalaMake::Core::language_python;
 using KalaMake::Language::GlobalData;
 using KalaMake::Core::BinaryType;
 using KalaMake::Core::CompilerLauncherType;
@@ -30,6 +35,8 @@ using KalaMake::Core::BuildType;
 using KalaMake::Core::WarningLevel;
 using KalaMake::Core::CustomFlag;
 using KalaMake::Core::Generate;
+using KalaMake::Core::JobPool;
+using KalaMake::Core::Action;
 using KalaMake::Core::VSCode_Launch;
 using KalaMake::Core::VSCode_Task;
 
@@ -47,7 +54,7 @@ using std::ifstream;
 
 constexpr string_view tempFolderName = "temp";
 
-static path mainPython{};
+static thread_local path mainPython{};
 
 static void PreCheck(GlobalData& globalData);
 
@@ -88,6 +95,8 @@ namespace KalaMake::Language
 {
 	void LanguageCore::Compile_Python(GlobalData& globalData)
 	{
+		mainPython.clear();
+
 		PreCheck(globalData);
 		Compile_Final(globalData);
 	}
@@ -95,9 +104,15 @@ namespace KalaMake::Language
 
 void PreCheck(GlobalData& globalData)
 {
-    //
-    // ENSURE UNSUPPORTED FIELDS ARE NOT USED
-    //
+	//
+	// ENSURE REQUIRED FIELDS ARE SET AND UNSUPPORTED FIELDS ARE NOT USED
+	//
+
+	Schema::CheckLanguage(
+		globalData.targetProfile,
+		language_python,
+		"Python",
+		"LANGUAGE_PYTHON");
 
     if (globalData.targetProfile.binaryType != BinaryType::B_EXECUTABLE)
     {
@@ -105,138 +120,6 @@ void PreCheck(GlobalData& globalData)
 			"LANGUAGE_PYTHON",
 			"Python only supports executables!");
     }
-    if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'compilerlauncher' is not supported in Python!");
-    }
-    if (globalData.targetProfile.standard != StandardType::S_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'standard' is not supported in Python!");
-    }
-    if (globalData.targetProfile.targetType != TargetType::T_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'targettype' is not supported in Python!");
-    }
-    if (globalData.targetProfile.buildType != BuildType::B_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'buildtype' is not supported in Python!");
-    }
-    if (!globalData.targetProfile.headers.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'headers' is not supported in Python!");
-    }
-    if (!globalData.targetProfile.links.empty())
-	{
-		KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'links' is not supported in Python!");
-	}
-    if (globalData.targetProfile.warningLevel != WarningLevel::W_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'warninglevel' is not supported in Python!");
-    }
-    if (!globalData.targetProfile.linkFlags.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'linkflags' is not supported in Python!");
-    }
-
-    if (!globalData.targetProfile.defines.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'defines' is not supported in Python!");
-    }
-    if (!globalData.targetProfile.links.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'links' is not supported in Python!");
-    }
-    if (globalData.targetProfile.jobs != 0)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Field 'jobs' is not supported in Python!");
-    }
-
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_EXPORT_COMPILE_COMMANDS))
-	{
-        KalaMakeCore::CloseOnError(
-		    "LANGUAGE_PYTHON",
-		    "Custom flag 'export-compile-commands' is not supported in Python!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_WARNINGS_AS_ERRORS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Custom flag 'warnings-as-errors' is not supported in Python!");
-	}
-    if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_MSVC_STATIC_RUNTIME))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Custom flag 'msvc-static-runtime' is not supported in Python!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_GENERATE_SYMBOLS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Custom flag 'generate-symbols' is not supported in Python!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_NO_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Custom flag 'no-console' is not supported in Java!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PACKAGE_JAR))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Custom flag 'package-jar' is not supported in Python!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_JAVA_WIN_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Custom flag 'java-win-console' is not supported in Python!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_EXPORT_JAVA_SLN))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_PYTHON",
-			"Custom flag 'export-java-sln' is not supported in Python!");
-	}
 
     //
 	// FILTER OUT BAD SOURCE FILES 
@@ -272,11 +155,6 @@ void PreCheck(GlobalData& globalData)
             "Did not find main Python script! Please ensure Main.py or main.py is added to sources.");
     }
 
-    auto should_exclude = [](const path& target) -> bool
-		{
-			return (target.string().starts_with('!'));
-		};
-
 	auto should_remove = [](
 		const path& target) -> bool
 		{
@@ -293,47 +171,10 @@ void PreCheck(GlobalData& globalData)
 
 	bool foundInvalid{};
 	vector<path>& sources = globalData.targetProfile.sources;
-	vector<path> exclusions{};
 	vector<path> finalSources{};
 
 	for (const auto& target : sources)
 	{
-		if (should_exclude(target))
-		{
-			string withoutExclamation = target.string().substr(1);
-
-			auto itMatch = find(
-				sources.begin(),
-				sources.end(),
-				path((withoutExclamation)));
-
-			if (itMatch == sources.end())
-			{
-				withoutExclamation = (current_path() / withoutExclamation).string();
-
-				itMatch = find(
-					sources.begin(),
-					sources.end(),
-					path((withoutExclamation)));
-
-				if (itMatch == sources.end())
-				{
-					KalaMakeCore::CloseOnError(
-						"LANGUAGE_PYTHON",
-						"Cannot ignore target '" + target.string() + "' if it hasn't already been added to sources list!");
-				}
-			}
-
-			exclusions.push_back(withoutExclamation);
-
-			Log::Print(
-				"Ignoring excluded source script path '" + (*itMatch).string() + "'.",
-				"LANGUAGE_PYTHON",
-				LogType::LOG_INFO);
-
-			foundInvalid = true;
-			continue;
-		}
 		if (should_remove(target))
 		{
 			Log::Print(
@@ -379,19 +220,6 @@ void PreCheck(GlobalData& globalData)
 
 	if (foundInvalid) 
 	{
-		if (!exclusions.empty())
-		{
-			finalSources.erase(
-				remove_if(
-					finalSources.begin(),
-					finalSources.end(),
-					[&exclusions](const path& p)
-					{
-						return find(exclusions.begin(), exclusions.end(), p) != exclusions.end();
-					}),
-				finalSources.end());
-		}
-
 		globalData.targetProfile.sources = std::move(finalSources);
 
 		Log::Print("\n===========================================================================\n");
@@ -411,17 +239,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_PYTHON",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.preBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_PYTHON",
-					"Failed to run pre build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.preBuildActions,
+			false,
+			"LANGUAGE_PYTHON",
+			"pre build");
 
 		Log::Print(" ");
 
@@ -453,7 +276,7 @@ void Compile_Final(const GlobalData& globalData)
             command += " > /dev/null 2>&1";
 #endif
 
-            if (system(command.c_str()) != 0)
+            if (JobPool::Run(command) != 0)
             {
                 KalaMakeCore::CloseOnError(
                     "LANGUAGE_PYTHON",
@@ -461,7 +284,8 @@ void Compile_Final(const GlobalData& globalData)
             }
         };
 
-	auto compile = [&globalData]() -> void
+	//returns true if a new output was written
+	auto compile = [&globalData]() -> bool
         {
             string command{};
 
@@ -537,7 +361,7 @@ void Compile_Final(const GlobalData& globalData)
 
                 Log::Print(" ");
 
-                if (system(command.c_str()) != 0)
+                if (JobPool::Run(command) != 0)
                 {
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_PYTHON",
@@ -548,18 +372,20 @@ void Compile_Final(const GlobalData& globalData)
 					"Finished compiling to output '" + globalData.targetProfile.buildPath.string() + "'!",
 					"LANGUAGE_PYTHON",
 					LogType::LOG_SUCCESS);
+
+				return true;
             }
-            else
-            {
-				Log::Print(
-					"Skipping compiling to output '" + globalData.targetProfile.buildPath.string() + "' because there are no new source files.",
-					"LANGUAGE_PYTHON",
-					LogType::LOG_INFO);
-            }
+
+			Log::Print(
+				"Skipping compiling to output '" + globalData.targetProfile.buildPath.string() + "' because there are no new source files.",
+				"LANGUAGE_PYTHON",
+				LogType::LOG_INFO);
+
+			return false;
         };
 
     check_pyinstaller();
-    compile();
+    bool relinked = compile();
 
 	//
 	// POST BUILD ACTIONS
@@ -574,17 +400,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_PYTHON",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.postBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_PYTHON",
-					"Failed to run post build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.postBuildActions,
+			relinked,
+			"LANGUAGE_PYTHON",
+			"post build");
 
 		Log::Print(" ");
 
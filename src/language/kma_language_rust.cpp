@@ -13,9 +13,11 @@
 
 #include "language/kma_language.hpp"
 #include "core/kma_core.hpp"
+#include "core/kma_schema.hpp"
 #include "core/kma_generate.hpp"
+#include "core/kma_jobs.hpp"
+#include "core/kma_action.hpp"
 
-using KalaHeaders::KalaCore::EnumToString;
 using KalaHeaders::KalaCore::ContainsValue;
 using KalaHeaders::KalaCore::RemoveDuplicates;
 
@@ -23,8 +25,12 @@ using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
 
 using KalaHeaders::KalaFile::CopyPath;
+using KalaHeaders::KalaFile::DeletePath;
 
 using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::Schema;
+using KalaMake::Core::FieldType;
+using KalaMake::Core::language_rust;
 using KalaMake::Language::GlobalData;
 using KalaMake::Core::BinaryType;
 using KalaMake::Core::CompilerLauncherType;
@@ -34,6 +40,8 @@ using KalaMake::Core::BuildType;
 using KalaMake::Core::WarningLevel;
 using KalaMake::Core::CustomFlag;
 using KalaMake::Core::Generate;
+using KalaMake::Core::JobPool;
+using KalaMake::Core::Action;
 using KalaMake::Core::VSCode_Launch;
 using KalaMake::Core::VSCode_Task;
 
@@ -57,6 +65,9 @@ constexpr string_view target_type_rust_linux_musl = "x86_64-unknown-linux-musl";
 //rust + windows-gnu
 constexpr string_view target_type_rust_windows_gnu = "x86_64-pc-windows-gnu";
 
+//rustc writes the metadata of check here, the folder is removed afterwards
+constexpr string_view checkFolderName = "check";
+
 //win msvc std folder
 static const path win_msvc_std_dir = path("lib") / "rustlib" / "x86_64-pc-windows-msvc" / "lib";
 //win gnu std folder
@@ -66,7 +77,7 @@ static const path linux_gnu_std_dir = path("lib") / "rustlib" / "x86_64-unknown-
 //linux musl std folder
 static const path linux_musl_std_dir = path("lib") / "rustlib" / "x86_64-unknown-linux-musl" / "lib";
 
-static path mainRust{};
+static thread_local path mainRust{};
 
 static void PreCheck(GlobalData& globalData);
 
@@ -110,6 +121,8 @@ namespace KalaMake::Language
 {
 	void LanguageCore::Compile_Rust(GlobalData& globalData)
 	{
+		mainRust.clear();
+
 		PreCheck(globalData);
 		Compile_Final(globalData);
 	}
@@ -134,122 +147,14 @@ void PreCheck(GlobalData& globalData)
 #endif
 
 	//
-	// ENSURE REQUIRED FIELDS ARE NOT MISSING
+	// ENSURE REQUIRED FIELDS ARE SET AND UNSUPPORTED FIELDS ARE NOT USED
 	//
 
-    if (globalData.targetProfile.standard == StandardType::S_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Field 'standard' must be assigned in Rust!");
-    }
-	if (globalData.targetProfile.buildType == BuildType::B_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Field 'buildtype' must be assigned in Rust!");
-    }
-
-    //
-    // ENSURE UNSUPPORTED FIELDS ARE NOT USED
-    //
-
-    if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Field 'compilerlauncher' is not supported in Rust!");
-    }
-    if (!globalData.targetProfile.headers.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Field 'headers' is not supported in Rust!");
-    }
-    if (globalData.targetProfile.warningLevel != WarningLevel::W_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Field 'warninglevel' is not supported in Rust!");
-    }
-    if (!globalData.targetProfile.linkFlags.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Field 'linkflags' is not supported in Rust!");
-    }
-
-    if (globalData.targetProfile.jobs != 0)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Field 'jobs' is not supported in Rust!");
-    }
-
-	if (ContainsValue(
-			globalData.targetProfile.customFlags, 
-			CustomFlag::F_EXPORT_COMPILE_COMMANDS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'export-compile-commands' is not supported in Rust!");
-	}
-    if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_MSVC_STATIC_RUNTIME))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'msvc-static-runtime' is not supported in Rust!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_GENERATE_SYMBOLS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'generate-symbols' is not supported in Rust!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_NO_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'no-console' is not supported in Java!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PACKAGE_JAR))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'package-jar' is not supported in Rust!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_JAVA_WIN_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'java-win-console' is not supported in Rust!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_EXPORT_JAVA_SLN))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'export-java-sln' is not supported in Rust!");
-	}
-    if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PYTHON_ONE_FILE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_RUST",
-			"Custom flag 'python-one-file' is not supported in Rust!");
-	}
+	Schema::CheckLanguage(
+		globalData.targetProfile,
+		language_rust,
+		"Rust",
+		"LANGUAGE_RUST");
 
     //
 	// FILTER OUT BAD SOURCE FILES 
@@ -285,11 +190,6 @@ void PreCheck(GlobalData& globalData)
             "Did not find main Rust script! Please ensure main.rs or lib.rs is added to sources.");
     }
 
-    auto should_exclude = [](const path& target) -> bool
-		{
-			return (target.string().starts_with('!'));
-		};
-
 	auto should_remove = [](
 		const path& target) -> bool
 		{
@@ -306,47 +206,10 @@ void PreCheck(GlobalData& globalData)
 
 	bool foundInvalid{};
 	vector<path>& sources = globalData.targetProfile.sources;
-	vector<path> exclusions{};
 	vector<path> finalSources{};
 
 	for (const auto& target : sources)
 	{
-		if (should_exclude(target))
-		{
-			string withoutExclamation = target.string().substr(1);
-
-			auto itMatch = find(
-				sources.begin(),
-				sources.end(),
-				path((withoutExclamation)));
-
-			if (itMatch == sources.end())
-			{
-				withoutExclamation = (current_path() / withoutExclamation).string();
-
-				itMatch = find(
-					sources.begin(),
-					sources.end(),
-					path((withoutExclamation)));
-
-				if (itMatch == sources.end())
-				{
-					KalaMakeCore::CloseOnError(
-						"LANGUAGE_RUST",
-						"Cannot ignore target '" + target.string() + "' if it hasn't already been added to sources list!");
-				}
-			}
-
-			exclusions.push_back(withoutExclamation);
-
-			Log::Print(
-				"Ignoring excluded source script path '" + (*itMatch).string() + "'.",
-				"LANGUAGE_RUST",
-				LogType::LOG_INFO);
-
-			foundInvalid = true;
-			continue;
-		}
 		if (should_remove(target))
 		{
 			Log::Print(
@@ -392,19 +255,6 @@ void PreCheck(GlobalData& globalData)
 
 	if (foundInvalid) 
 	{
-		if (!exclusions.empty())
-		{
-			finalSources.erase(
-				remove_if(
-					finalSources.begin(),
-					finalSources.end(),
-					[&exclusions](const path& p)
-					{
-						return find(exclusions.begin(), exclusions.end(), p) != exclusions.end();
-					}),
-				finalSources.end());
-		}
-
 		globalData.targetProfile.sources = std::move(finalSources);
 
 		Log::Print("\n===========================================================================\n");
@@ -424,17 +274,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_RUST",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.preBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_RUST",
-					"Failed to run pre build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.preBuildActions,
+			false,
+			"LANGUAGE_RUST",
+			"pre build");
 
 		Log::Print(" ");
 
@@ -450,13 +295,14 @@ void Compile_Final(const GlobalData& globalData)
 	// GENERATE STEPS
 	//
 
-	GenerateSteps(globalData);
+	if (!globalData.checkOnly) GenerateSteps(globalData);
 
 	//
 	// COMPILE
 	//
 
-    auto compile = [&globalData]() -> void
+    //returns true if a new output was written
+    auto compile = [&globalData]() -> bool
         {
             string command{};
 
@@ -515,12 +361,9 @@ void Compile_Final(const GlobalData& globalData)
             }
             default:
             {
-                string_view standard;
-            
-                EnumToString(
-                    globalData.targetProfile.standard, 
-                    KalaMakeCore::GetStandardTypes(),
-                    standard);
+                string_view standard = Schema::GetValueName(
+                    FieldType::T_STANDARD,
+                    globalData.targetProfile.standard);
 
                 if (!standard.starts_with("rust"))
                 {
@@ -636,6 +479,34 @@ void Compile_Final(const GlobalData& globalData)
 
             command += " --crate-name " + globalData.targetProfile.binaryName;
 
+            //check only emits metadata, nothing is code generated or linked
+
+            if (globalData.checkOnly)
+            {
+                path checkDir = globalData.targetProfile.buildPath / checkFolderName;
+
+                command += " --emit=metadata --out-dir \"" + checkDir.string() + "\"";
+                command += " \"" + mainRust.string() + "\"";
+
+				Log::Print(
+					"Starting to check via '" + command + "'.",
+					"LANGUAGE_RUST",
+					LogType::LOG_INFO);
+
+                bool failed = JobPool::Run(command) != 0;
+
+                if (exists(checkDir)) DeletePath(checkDir);
+
+                if (failed)
+                {
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_RUST",
+						"Found errors in Rust sources!");
+                }
+
+                return false;
+            }
+
             //set output
 
             auto has_shared_lib = [&globalData]() -> bool
@@ -915,7 +786,7 @@ void Compile_Final(const GlobalData& globalData)
 
                 Log::Print(" ");
 
-                if (system(command.c_str()) != 0)
+                if (JobPool::Run(command) != 0)
                 {
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_RUST",
@@ -926,17 +797,29 @@ void Compile_Final(const GlobalData& globalData)
 					"Finished compiling to output '" + outputPath.string() + "'!",
 					"LANGUAGE_RUST",
 					LogType::LOG_SUCCESS);
+
+				return true;
             }
-            else
-            {
-				Log::Print(
-					"Skipping compiling to output '" + outputPath.string() + "' because there are no new source files.",
-					"LANGUAGE_RUST",
-					LogType::LOG_INFO);
-            }
+
+			Log::Print(
+				"Skipping compiling to output '" + outputPath.string() + "' because there are no new source files.",
+				"LANGUAGE_RUST",
+				LogType::LOG_INFO);
+
+			return false;
         };
 
-    compile();
+    bool relinked = compile();
+
+	if (globalData.checkOnly)
+	{
+		Log::Print(
+			"Finished checking sources, no errors were found!",
+			"LANGUAGE_RUST",
+			LogType::LOG_SUCCESS);
+
+		return;
+	}
 
     //
 	// POST BUILD ACTIONS
@@ -951,17 +834,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_RUST",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.postBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_RUST",
-					"Failed to run post build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.postBuildActions,
+			relinked,
+			"LANGUAGE_RUST",
+			"post build");
 
 		Log::Print(" ");
 
@@ -9,7 +9,10 @@
 
 #include "language/kma_language.hpp"
 #include "core/kma_core.hpp"
+#include "core/kma_schema.hpp"
 #include "core/kma_generate.hpp"
+#include "core/kma_jobs.hpp"
+#include "core/kma_action.hpp"
 
 #include "log_utils.hpp"
 
@@ -20,6 +23,8 @@ using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
 
 using KalaMake::Core::KalaMakeCore;
+using KalaMake::Core::Schema;
+using KalaMake::Core::language_zig;
 using KalaMake::Language::GlobalData;
 using KalaMake::Core::BinaryType;
 using KalaMake::Core::CompilerLauncherType;
@@ -29,6 +34,8 @@ using KalaMake::Core::BuildType;
 using KalaMake::Core::WarningLevel;
 using KalaMake::Core::CustomFlag;
 using KalaMake::Core::Generate;
+using KalaMake::Core::JobPool;
+using KalaMake::Core::Action;
 using KalaMake::Core::VSCode_Launch;
 using KalaMake::Core::VSCode_Task;
 
@@ -48,7 +55,7 @@ constexpr string_view target_type_zig_linux_musl = "x86_64-linux-musl";
 // zig + windows-gnu
 constexpr string_view target_type_zig_windows_gnu = "x86_64-windows-gnu";
 
-static path mainZig{};
+static thread_local path mainZig{};
 
 static void PreCheck(GlobalData& globalData);
 
@@ -92,6 +99,8 @@ namespace KalaMake::Language
 {
 	void LanguageCore::Compile_Zig(GlobalData& globalData)
 	{
+		mainZig.clear();
+
 		PreCheck(globalData);
 		Compile_Final(globalData);
 	}
@@ -100,142 +109,14 @@ namespace KalaMake::Language
 void PreCheck(GlobalData& globalData)
 {
 	//
-	// ENSURE REQUIRED FIELDS ARE NOT MISSING
+	// ENSURE REQUIRED FIELDS ARE SET AND UNSUPPORTED FIELDS ARE NOT USED
 	//
 
-	if (globalData.targetProfile.buildType == BuildType::B_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'buildtype' must be assigned in Zig!");
-    }
-
-    //
-    // ENSURE UNSUPPORTED FIELDS ARE NOT USED
-    //
-
-    if (globalData.targetProfile.standard != StandardType::S_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'standard' is not supported in Zig!");
-    }
-    if (globalData.targetProfile.compilerLauncher != CompilerLauncherType::C_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'compilerlauncher' is not supported in Zig!");
-    }
-    if (!globalData.targetProfile.headers.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'headers' is not supported in Zig!");
-    }
-    if (!globalData.targetProfile.links.empty())
-	{
-		KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'links' is not supported in Zig!");
-	}
-    if (globalData.targetProfile.warningLevel != WarningLevel::W_INVALID)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'warninglevel' is not supported in Zig!");
-    }
-    if (!globalData.targetProfile.linkFlags.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'linkflags' is not supported in Zig!");
-    }
-
-    if (!globalData.targetProfile.defines.empty())
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'defines' is not supported in Zig!");
-    }
-    if (globalData.targetProfile.jobs != 0)
-    {
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Field 'jobs' is not supported in Zig!");
-    }
-
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_EXPORT_COMPILE_COMMANDS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'export-compile-commands' is not supported in Zig!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_WARNINGS_AS_ERRORS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'warnings-as-errors' is not supported in Zig!");
-	}
-    if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_MSVC_STATIC_RUNTIME))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'msvc-static-runtime' is not supported in Zig!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_GENERATE_SYMBOLS))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'generate-symbols' is not supported in Zig!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_NO_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'no-console' is not supported in Java!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PACKAGE_JAR))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'package-jar' is not supported in Zig!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_JAVA_WIN_CONSOLE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'java-win-console' is not supported in Zig!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_EXPORT_JAVA_SLN))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'export-java-sln' is not supported in Zig!");
-	}
-	if (ContainsValue(
-		globalData.targetProfile.customFlags, 
-		CustomFlag::F_PYTHON_ONE_FILE))
-	{
-        KalaMakeCore::CloseOnError(
-			"LANGUAGE_ZIG",
-			"Custom flag 'python-one-file' is not supported in Zig!");
-	}
+	Schema::CheckLanguage(
+		globalData.targetProfile,
+		language_zig,
+		"Zig",
+		"LANGUAGE_ZIG");
 
     //
 	// FILTER OUT BAD SOURCE FILES 
@@ -271,11 +152,6 @@ void PreCheck(GlobalData& globalData)
             "Did not find main Zig script! Please ensure main.zig or root.zig is added to sources.");
     }
 
-	auto should_exclude = [](const path& target) -> bool
-		{
-			return (target.string().starts_with('!'));
-		};
-
 	auto should_remove = [](
 		const path& target) -> bool
 		{
@@ -292,47 +168,10 @@ void PreCheck(GlobalData& globalData)
 
 	bool foundInvalid{};
 	vector<path>& sources = globalData.targetProfile.sources;
-	vector<path> exclusions{};
 	vector<path> finalSources{};
 
 	for (const auto& target : sources)
 	{
-		if (should_exclude(target))
-		{
-			string withoutExclamation = target.string().substr(1);
-
-			auto itMatch = find(
-				sources.begin(),
-				sources.end(),
-				path((withoutExclamation)));
-
-			if (itMatch == sources.end())
-			{
-				withoutExclamation = (current_path() / withoutExclamation).string();
-
-				itMatch = find(
-					sources.begin(),
-					sources.end(),
-					path((withoutExclamation)));
-
-				if (itMatch == sources.end())
-				{
-					KalaMakeCore::CloseOnError(
-						"LANGUAGE_ZIG",
-						"Cannot ignore target '" + target.string() + "' if it hasn't already been added to sources list!");
-				}
-			}
-
-			exclusions.push_back(withoutExclamation);
-
-			Log::Print(
-				"Ignoring excluded source script path '" + (*itMatch).string() + "'.",
-				"LANGUAGE_ZIG",
-				LogType::LOG_INFO);
-
-			foundInvalid = true;
-			continue;
-		}
 		if (should_remove(target))
 		{
 			Log::Print(
@@ -378,19 +217,6 @@ void PreCheck(GlobalData& globalData)
 
 	if (foundInvalid) 
 	{
-		if (!exclusions.empty())
-		{
-			finalSources.erase(
-				remove_if(
-					finalSources.begin(),
-					finalSources.end(),
-					[&exclusions](const path& p)
-					{
-						return find(exclusions.begin(), exclusions.end(), p) != exclusions.end();
-					}),
-				finalSources.end());
-		}
-
 		globalData.targetProfile.sources = std::move(finalSources);
 
 		Log::Print("\n===========================================================================\n");
@@ -410,17 +236,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_ZIG",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.preBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_ZIG",
-					"Failed to run pre build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.preBuildActions,
+			false,
+			"LANGUAGE_ZIG",
+			"pre build");
 
 		Log::Print(" ");
 
@@ -436,13 +257,14 @@ void Compile_Final(const GlobalData& globalData)
 	// GENERATE STEPS
 	//
 
-	GenerateSteps(globalData);
+	if (!globalData.checkOnly) GenerateSteps(globalData);
 
 	//
 	// COMPILE
 	//
 
-    auto compile = [&globalData]() -> void
+    //returns true if a new output was written
+    auto compile = [&globalData]() -> bool
         {
             string command{};
 
@@ -571,6 +393,27 @@ void Compile_Final(const GlobalData& globalData)
 				}
             }
 
+            //check only runs semantic analysis, no binary is emitted
+
+            if (globalData.checkOnly)
+            {
+                command += " -fno-emit-bin";
+
+				Log::Print(
+					"Starting to check via '" + command + "'.",
+					"LANGUAGE_ZIG",
+					LogType::LOG_INFO);
+
+                if (JobPool::Run(command) != 0)
+                {
+					KalaMakeCore::CloseOnError(
+						"LANGUAGE_ZIG",
+						"Found errors in Zig sources!");
+                }
+
+                return false;
+            }
+
             //set output data
 
             path buildPath = globalData.targetProfile.buildPath;
@@ -693,7 +536,7 @@ void Compile_Final(const GlobalData& globalData)
 
                 Log::Print(" ");
 
-                if (system(command.c_str()) != 0)
+                if (JobPool::Run(command) != 0)
                 {
 					KalaMakeCore::CloseOnError(
 						"LANGUAGE_ZIG",
@@ -704,17 +547,29 @@ void Compile_Final(const GlobalData& globalData)
 					"Finished compiling to output '" + outputPath.string() + "'!",
 					"LANGUAGE_ZIG",
 					LogType::LOG_SUCCESS);
+
+				return true;
             }
-            else
-            {
-				Log::Print(
-					"Skipping compiling to output '" + outputPath.string() + "' because there are no new source files.",
-					"LANGUAGE_ZIG",
-					LogType::LOG_INFO);
-            }
+
+			Log::Print(
+				"Skipping compiling to output '" + outputPath.string() + "' because there are no new source files.",
+				"LANGUAGE_ZIG",
+				LogType::LOG_INFO);
+
+			return false;
         };
 
-    compile();
+    bool relinked = compile();
+
+	if (globalData.checkOnly)
+	{
+		Log::Print(
+			"Finished checking sources, no errors were found!",
+			"LANGUAGE_ZIG",
+			LogType::LOG_SUCCESS);
+
+		return;
+	}
 
     //
 	// POST BUILD ACTIONS
@@ -729,17 +584,12 @@ void Compile_Final(const GlobalData& globalData)
 			"LANGUAGE_ZIG",
 			LogType::LOG_INFO);
 
-		for (const auto& a : globalData.targetProfile.postBuildActions)
-		{
-			Log::Print("\naction: " + a);
-
-			if (system(a.c_str()) != 0)
-			{
-				KalaMakeCore::CloseOnError(
-					"LANGUAGE_ZIG",
-					"Failed to run post build action '" + a + "'!");
-			}
-		}
+		Action::RunAll(
+			globalData,
+			globalData.targetProfile.postBuildActions,
+			relinked,
+			"LANGUAGE_ZIG",
+			"post build");
 
 		Log::Print(" ");
 
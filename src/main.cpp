@@ -9,6 +9,7 @@
 #include "kc_command.hpp"
 
 #include "core/kma_core.hpp"
+#include "core/kma_context.hpp"
 
 using KalaHeaders::KalaLog::Log;
 using KalaHeaders::KalaLog::LogType;
@@ -18,10 +19,16 @@ using KalaCLI::CommandManager;
 
 using KalaMake::Core::KalaMakeCore;
 using KalaMake::Core::StartType;
+using KalaMake::Core::KalaMakeError;
+using KalaMake::Core::SessionContext;
 
 using std::vector;
 using std::string;
 
+static void RunCommand(
+	StartType type,
+	const vector<string>& params);
+
 static void AddExternalCommands()
 {
 	auto command_compile = [](const vector<string>& params)
@@ -29,7 +36,7 @@ static void AddExternalCommands()
 			if (params.size() == 1)
 			{
 				Log::Print(
-					"Command 'compile' got no arguments! You must pass a .kmake path and target profile!",
+					"Command 'compile' got no arguments! You must pass a .kmake path and at least one target profile!",
 					"PARSE",
 					LogType::LOG_ERROR,
 					2);
@@ -39,25 +46,74 @@ static void AddExternalCommands()
 			if (params.size() == 2)
 			{
 				Log::Print(
-					"Command 'compile' requires two arguments! You must pass a .kmake path and target profile!",
+					"Command 'compile' requires at least two arguments! You must pass a .kmake path and at least one target profile!",
 					"PARSE",
 					LogType::LOG_ERROR,
 					2);
 
 				return;
 			}
-			if (params.size() > 3)
+			RunCommand(StartType::S_COMPILE, params);
+		};
+	auto command_compile_file = [](const vector<string>& params)
+		{
+			if (params.size() < 4)
 			{
 				Log::Print(
-					"Command 'compile' only allows two arguments! You must pass a .kmake path and target profile!",
+					"Command 'compile-file' requires at least three arguments! You must pass a .kmake path, target profile and source path!",
 					"PARSE",
 					LogType::LOG_ERROR,
 					2);
 
 				return;
 			}
+			if (params.size() > 5)
+			{
+				Log::Print(
+					"Command 'compile-file' only allows four arguments! You must pass a .kmake path, target profile, source path and optionally 'json'!",
+					"PARSE",
+					LogType::LOG_ERROR,
+					2);
 
-			KalaMakeCore::OpenFile(StartType::S_COMPILE, params);
+				return;
+			}
+			if (params.size() == 5
+				&& params[4] != "json")
+			{
+				Log::Print(
+					"Command 'compile-file' only allows 'json' as its fourth argument!",
+					"PARSE",
+					LogType::LOG_ERROR,
+					2);
+
+				return;
+			}
+
+			RunCommand(StartType::S_COMPILE_FILE, params);
+		};
+	auto command_check = [](const vector<string>& params)
+		{
+			if (params.size() == 1)
+			{
+				Log::Print(
+					"Command 'check' got no arguments! You must pass a .kmake path and at least one target profile!",
+					"PARSE",
+					LogType::LOG_ERROR,
+					2);
+
+				return;
+			}
+			if (params.size() == 2)
+			{
+				Log::Print(
+					"Command 'check' requires at least two arguments! You must pass a .kmake path and at least one target profile!",
+					"PARSE",
+					LogType::LOG_ERROR,
+					2);
+
+				return;
+			}
+			RunCommand(StartType::S_CHECK, params);
 		};
 	auto command_clean = [](const vector<string>& params)
 		{
@@ -82,7 +138,7 @@ static void AddExternalCommands()
 				return;
 			}
 
-			KalaMakeCore::OpenFile(StartType::S_CLEAN, params);
+			RunCommand(StartType::S_CLEAN, params);
 		};
 	auto command_version = [](const vector<string>& params)
 		{
@@ -122,7 +178,7 @@ static void AddExternalCommands()
 				return;
 			}
 
-			KalaMakeCore::OpenFile(StartType::S_LIST_PROFILES, params);
+			RunCommand(StartType::S_LIST_PROFILES, params);
 		};
 	auto command_validate = [](const vector<string>& params)
 		{
@@ -157,7 +213,7 @@ static void AddExternalCommands()
 				return;
 			}
 
-			KalaMakeCore::OpenFile(StartType::S_VALIDATE, params);
+			RunCommand(StartType::S_VALIDATE, params);
 		};
 
 	CommandManager::AddCommand(
@@ -166,10 +222,34 @@ static void AddExternalCommands()
 			.description =
 				"Compile a project from a kalamake file, "
 				"second parameter must be valid path to a .kmake file, "
-				"third parameter must be a valid profile in the .kmake file.",
+				"third parameter must be a valid profile in the .kmake file, "
+				"more profiles or --all-profiles compile them together with shared jobs.",
 			.targetFunction = command_compile
 		});
 
+	CommandManager::AddCommand(
+		{
+			.primaryParam = "compile-file",
+			.description =
+				"Compiles a single source of a profile without linking, "
+				"second parameter must be valid path to a .kmake file, "
+				"third parameter must be a valid profile in the .kmake file, "
+				"fourth parameter must be a source of that profile, "
+				"optional fifth parameter 'json' exports the diagnostics next to the object file.",
+			.targetFunction = command_compile_file
+		});
+
+	CommandManager::AddCommand(
+		{
+			.primaryParam = "check",
+			.description =
+				"Checks every source of a profile for compile errors without writing objects or linking, "
+				"second parameter must be valid path to a .kmake file, "
+				"third parameter must be a valid profile in the .kmake file, "
+				"more profiles or --all-profiles check them together.",
+			.targetFunction = command_check
+		});
+
 	CommandManager::AddCommand(
 		{
 			.primaryParam = "clean",
@@ -204,6 +284,24 @@ static void AddExternalCommands()
 		});
 }
 
+//The engine throws on errors so it can be embedded,
+//the command line keeps exiting with 1 after the error was already logged
+void RunCommand(
+	StartType type,
+	const vector<string>& params)
+{
+	SessionContext context{};
+
+	try
+	{
+		KalaMakeCore::OpenFile(context, type, params);
+	}
+	catch (const KalaMakeError&)
+	{
+		exit(1);
+	}
+}
+
 int main(int argc, char* argv[])
 {
 	Core::Run(argc, argv, AddExternalCommands);